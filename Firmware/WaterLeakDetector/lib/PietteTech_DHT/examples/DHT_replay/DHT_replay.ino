@@ -0,0 +1,173 @@
+/*
+ * FILE:        DHT_replay.cpp
+ * VERSION:     0.0.19
+ * PURPOSE:     Exercise the DHT edge decoder with synthetic edge traces
+ * LICENSE:     GPL v3 (http://www.gnu.org/licenses/gpl.html)
+ *
+ * No sensor is needed.  Builds edge->edge timing traces of a DHT11
+ * reading and feeds them through DHT.replay(), which runs the same
+ * decoder the ISR uses.  The traces are:
+ *
+ *   clean       nominal timing
+ *   jitter N    every edge moved by up to +/- N us (N = 5..40)
+ *   truncated   the trace ends after a random number of edges
+ *   glitch      a spurious short edge is inserted at a random point
+ *   flipped     one data bit is flipped (must fail the checksum)
+ *
+ * For each kind it prints the decode success rate (the reading must
+ * decode to the values that were encoded) and the average decoder
+ * cost per edge, in CPU cycles and nanoseconds.  Use this to measure
+ * the effect of changing the timing windows or optimizing the ISR.
+ * After each round it prints the timing windows the decoder has
+ * learned from the good traces.
+ *
+ * Each kind of trace is replayed through two decoders: "general" is
+ * PietteTech_DHT, which learns its timing and chooses the sensor type at
+ * run time, and "DHT11" is PietteTech_DHT_T specialized at compile time
+ * for a DHT11 with the fixed timing windows.
+ *
+ * The WaterLeakDetector host tests run the same trials off the device
+ * (test/DhtReplay.cpp in the WaterLeakDetector firmware).
+ *
+ * Team Practical Projects
+ *      October 2026        Original
+ */
+
+#include "PietteTech_DHT.h"
+
+#define DHTTYPE  DHT11              // Sensor type DHT11/21/22/AM2301/AM2302
+#define DHTPIN   D3                 // not used; no sensor is needed
+#define TRIALS   500                // traces of each kind
+
+// nominal timing, in microseconds
+#define T_RELEASE    30             // start pulse released to first falling edge
+#define T_RESPONSE  160             // 80us low + 80us high response
+#define T_ZERO       78             // 50us low + 28us high
+#define T_ONE       120             // 50us low + 70us high
+
+const uint8_t HUMIDITY = 45;        // encoded values; DHT11 has no fraction
+const uint8_t TEMPERATURE = 22;
+
+PietteTech_DHT DHT(DHTPIN, DHTTYPE);
+PietteTech_DHT_T<DHT11Type, DHTFixedTiming<> > DHT11only(DHTPIN);
+
+uint16_t trace[48];
+int traceLength;
+
+// build a clean trace of the encoded reading; returns the number of edges
+int buildTrace(uint16_t *t, int flipBit) {
+  uint8_t bytes[5] = { HUMIDITY, 0, TEMPERATURE, 0, 0 };
+  int n = 0;
+
+  bytes[4] = bytes[0] + bytes[1] + bytes[2] + bytes[3];
+  t[n++] = T_RELEASE;
+  t[n++] = T_RESPONSE;
+  for (int bit = 0; bit < 40; bit++) {
+    bool one = (bytes[bit / 8] >> (7 - bit % 8)) & 1;
+    if (bit == flipBit) one = !one;
+    t[n++] = one ? T_ONE : T_ZERO;
+  }
+  return n;
+}
+
+// replay the trace through PietteTech_DHT; true if it decoded to the encoded values
+bool replayGeneral(uint32_t *ticks) {
+  uint32_t start = System.ticks();
+  int result = DHT.replay(trace, traceLength);
+  *ticks += System.ticks() - start;
+  return result == DHTLIB_OK &&
+         (int)DHT.getHumidity() == HUMIDITY &&
+         (int)DHT.getCelsius() == TEMPERATURE;
+}
+
+// the same through the decoder specialized for a DHT11
+bool replayDHT11(uint32_t *ticks) {
+  uint32_t start = System.ticks();
+  int result = DHT11only.replay(trace, traceLength);
+  *ticks += System.ticks() - start;
+  return result == DHTLIB_OK &&
+         (int)DHT11only.getHumidity() == HUMIDITY &&
+         (int)DHT11only.getCelsius() == TEMPERATURE;
+}
+
+// replay TRIALS traces made by "make" through both decoders and print the results
+void runTrials(const char *name, int param, void (*make)(int)) {
+  int ok[2] = { 0, 0 };
+  uint32_t ticks[2] = { 0, 0 };
+  uint32_t edges = 0;
+
+  for (int i = 0; i < TRIALS; i++) {
+    make(param);
+    edges += traceLength;
+    if (replayGeneral(&ticks[0])) ok[0]++;
+    if (replayDHT11(&ticks[1])) ok[1]++;
+  }
+
+  for (int d = 0; d < 2; d++) {
+    uint32_t cycles = ticks[d] / edges;
+    Serial.printlnf("%-10s %3d  %-8s %5.1f%% ok  %4lu cycles/edge  %5lu ns/edge",
+                    name, param, d == 0 ? "general" : "DHT11", 100.0 * ok[d] / TRIALS,
+                    cycles, cycles * 1000 / System.ticksPerMicrosecond());
+  }
+}
+
+void makeClean(int unused) {
+  traceLength = buildTrace(trace, -1);
+}
+
+void makeJitter(int amount) {
+  traceLength = buildTrace(trace, -1);
+  for (int i = 0; i < traceLength; i++)
+    trace[i] = max(1, trace[i] + random(-amount, amount + 1));
+}
+
+void makeTruncated(int unused) {
+  traceLength = random(1, buildTrace(trace, -1));
+}
+
+void makeGlitch(int unused) {
+  traceLength = buildTrace(trace, -1);
+  int at = random(2, traceLength);
+  int split = random(1, 10);        // a short pulse within a bit
+  memmove(&trace[at + 1], &trace[at], (traceLength - at) * sizeof(trace[0]));
+  trace[at] -= split;
+  trace[at + 1] = split;
+  traceLength++;
+}
+
+void makeFlipped(int unused) {
+  traceLength = buildTrace(trace, random(0, 40));
+}
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial.available() && millis() < 30000) {
+    Serial.println("Press any key to start.");
+    Particle.process();
+    delay(1000);
+  }
+  Serial.println("DHT decoder replay using DHT.replay");
+  Serial.print("LIB version: ");
+  Serial.println(DHTLIB_VERSION);
+  Serial.println("---------------");
+  Serial.printlnf("RAM: general %u bytes, DHT11 %u bytes",
+                  sizeof(DHT), sizeof(DHT11only));
+  Serial.println("---------------");
+  DHT.begin();
+  DHT11only.begin();
+  randomSeed(micros());
+}
+
+void loop() {
+  runTrials("clean", 0, makeClean);
+  for (int amount = 5; amount <= 40; amount += 5)
+    runTrials("jitter", amount, makeJitter);
+  runTrials("truncated", 0, makeTruncated);
+  runTrials("glitch", 0, makeGlitch);
+  runTrials("flipped", 0, makeFlipped);
+  Serial.printlnf("learned: 1 > %dus, data %d-%dus, response %d-%dus",
+                  DHT.getOneThreshold(), DHT.getDataMin(), DHT.getDataMax(),
+                  DHT.getResponseMin(), DHT.getResponseMax());
+  Serial.println("---------------");
+  delay(10000);
+}
@@ -24,6 +24,34 @@
 // 
 //      November 2021       Added calculation for HeatIndex and 
 //                          conversion CtoF() and FtoC()
+// Team Practical Projects
+//      October 2026        Start pulse and startup settle time no longer
+//                          block: acquire() pulls the line low and returns,
+//                          and acquiring() releases it once the pulse time
+//                          has passed.  begin() no longer delays 1 second.
+//                          Added abort() to give up on a sensor that does
+//                          not respond, so other sensors can be read.
+//                          The ISR only measures the edge->edge time; the
+//                          bits are decoded by decode(), which replay()
+//                          can feed with recorded or synthetic edge traces.
+//                          The 0/1 bit threshold and the data and response
+//                          timing windows are learned from good readings.
+//                          Added an edge timing histogram and counts of
+//                          good readings and of each error code.
+//                          The driver is now the class template
+//                          PietteTech_DHT_T (PietteTech_DHT_T.h), whose
+//                          sensor type, timing windows and edge timing
+//                          log are compile time policies; this class is
+//                          a thin wrapper that keeps the original API.
+//                          The edge timing log is bounds checked.
+//                          A DHT21/22 start pulse (1.5ms, 20ms at most)
+//                          is held with a busy wait, as polling could
+//                          hold it too long; only a DHT11's is ended by
+//                          acquiring().
+//                          The statistics (counts of good readings and
+//                          of each error code, edge time histogram) are
+//                          a compile time policy too; PietteTech_DHT
+//                          keeps them.
 //
 // Based on adaptation by niesteszeck (github/niesteszeck)
 // Based on original DHT11 library (http://playgroudn.adruino.cc/Main/DHT11Lib)
@@ -32,39 +60,9 @@
 // See docs for more background
 //   https://docs.particle.io/reference/firmware/photon/#attachinterrupt-
 
-//    Timing of DHT22 SDA signal line after MCU pulls low for 1ms
-//    https://github.com/mtnscott/Spark_DHT/AM2302.pdf
-//
-//  - - - -            -----           -- - - --            ------- - -
-//         \          /     \         /  \      \          /
-//          +        /       +       /    +      +        /
-//           \      /         \     /      \      \      /
-//            ------           -----        -- - --------
-// ^        ^                ^                   ^          ^
-// |   Ts   |        Tr      |        Td         |    Te    |
-//
-//    Ts : Start time from MCU changing SDA from Output High to Tri-State (Hi-Z)
-//         Spec: 20-200us             Tested: < 65us
-//    Tr : DHT response to MCU controlling SDA and pulling Low and High to
-//         start of first data bit
-//         Spec: 150-170us            Tested: 125 - 200us
-//    Td : DHT data bit, falling edge to falling edge
-//         Spec: '0' 70us - 85us      Tested: 60 - 110us
-//         Spec: '1' 116us - 130us    Tested: 111 - 155us
-//    Te : DHT releases SDA to Tri-State (Hi-Z)
-//         Spec: 45-55us              Not Tested
-
-
 #include "PietteTech_DHT.h"
 
-#if !defined(word)
-  // Thanks to Paul Kourany for this word type conversion function
-uint16_t word(uint8_t high, uint8_t low) {
-  uint16_t ret_val = low;
-  ret_val += (high << 8);
-  return ret_val;
-}
-#endif
+template class PietteTech_DHT_T<DHTAnyType, DHTLearnedTiming, DHTDefaultEdges, DHTStats>;
 
 // 
 // NOTE:  callback_wrapper is only here for backwards compatibility with v0.3 and earlier
@@ -73,115 +71,16 @@ uint16_t word(uint8_t high, uint8_t low) {
 PietteTech_DHT::PietteTech_DHT() {
 }
 
-PietteTech_DHT::PietteTech_DHT(uint8_t sigPin, uint8_t dht_type, void(*callback_wrapper)()) {
-  _sigPin = sigPin;
-  _type = dht_type;
+PietteTech_DHT::PietteTech_DHT(uint8_t sigPin, uint8_t dht_type, void(*callback_wrapper)())
+  : PietteTech_DHT_T(sigPin, dht_type) {
 }
 
-// 
-// NOTE:  callback_wrapper is only here for backwards compatibility with v0.3 and earlier
-//        it is no longer used or needed
-// 
 void PietteTech_DHT::begin() {
-  _firstreading = true;
-  _lastreadtime = 0;
-  _state = STOPPED;
-  _status = DHTLIB_ERROR_NOTSTARTED;
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-  // no extra steps required
-#else
-  _detachISR = false;
-#endif
-
-  pinMode(_sigPin, OUTPUT);
-  digitalWrite(_sigPin, HIGH);
-  
-  delay(1000); // allow for sensor to settle after startup
+  PietteTech_DHT_T::begin();
 }
 
 void PietteTech_DHT::begin(uint8_t sigPin, uint8_t dht_type, void(*callback_wrapper)()) {
-  _sigPin = sigPin;
-  _type = dht_type;
-  this->begin();
-}
-
-int PietteTech_DHT::acquire() {
-  // Check if sensor was read less than two seconds ago and return early
-  // to use last reading
-  unsigned long currenttime = millis();
-  if (!_firstreading && ((currenttime - _lastreadtime) < 2000)) {
-    // return last correct measurement, (this read time - last read time) < device limit
-    return DHTLIB_ACQUIRED;
-  }
-
-  if (_state == STOPPED || _state == ACQUIRED) {
-    // 
-    // Setup the initial state machine
-    // 
-    _firstreading = false;
-    _lastreadtime = currenttime;
-    _state = RESPONSE;
-
-#if defined(DHT_DEBUG_TIMING)
-    // 
-    // Clear the debug timings array
-    // 
-    for (int i = 0; i < 41; i++) _edges[i] = 0;
-    _e = &_edges[0];
-#endif
-
-    // 
-    // Set the initial values in the buffer and variables
-    // 
-    for (int i = 0; i < 5; i++) _bits[i] = 0;
-    _cnt = 7;
-    _idx = 0;
-    _hum = 0;
-    _temp = 0;
-
-    // 
-    // Toggle the digital output to trigger the DHT device
-    // to send us temperature and humidity data
-    // 
-    pinMode(_sigPin, OUTPUT);
-    digitalWrite(_sigPin, LOW);
-    if (_type == DHT11)
-      delay(18);                  // DHT11 Spec: 18ms min
-    else
-      delayMicroseconds(1500);    // DHT22 Spec: 0.8-20ms, 1ms typ
-    pinMode(_sigPin, INPUT);        // Note Hi-Z mode with pullup resistor
-                                    // will keep this high until the DHT responds.
-    // 
-    // Attach the interrupt handler to receive the data once the DHT
-    // starts to send us data
-    // 
-    _us = micros();
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-    // no extra steps required
-#else
-    _detachISR = false;
-#endif
-
-    attachInterrupt(_sigPin, &PietteTech_DHT::_isrCallback, this, FALLING);
-
-    return DHTLIB_ACQUIRING;
-  }
-  else
-    return DHTLIB_ERROR_ACQUIRING;
-}
-
-int PietteTech_DHT::acquireAndWait(uint32_t timeout) {
-  acquire();
-  uint32_t start = millis();
-  while (acquiring() && (timeout == 0 || ((millis() - start) < timeout))) Particle.process();
-  if (acquiring()) {
-    _status = DHTLIB_ERROR_RESPONSE_TIMEOUT;
-    if (_state == RESPONSE) {
-      _state = STOPPED;
-      _detachISR = true;
-    }
-  }
-  return getStatus();
+  PietteTech_DHT_T::begin(sigPin, dht_type);
 }
 
 // 
@@ -190,232 +89,57 @@ int PietteTech_DHT::acquireAndWait(uint32_t timeout) {
 // 
 void PietteTech_DHT::isrCallback() { }
 
-void PietteTech_DHT::_isrCallback() {
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-  // no extra steps required
-#else
-  // NOTE:  
-  // We can't call detachInterrupt() inside the ISR (c.f. https://github.com/particle-iot/device-os/issues/1835)
-  // so we'll set _detachISR inside the ISR when we're done
-  // and count on code on the main thread to detach it via detachISRIfRequested().
-  // Getting another interrupt after we've already requested a detach is benign
-  // so we'll just ignore this interrupt and return.
-
-  if (_detachISR) return;
-#endif
-
-  unsigned long newUs = micros();
-  unsigned long delta = (newUs - _us);
-  _us = newUs;
-
-  if (delta > 6000) {
-    _status = DHTLIB_ERROR_ISR_TIMEOUT;
-    _state = STOPPED;
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-    detachInterrupt(_sigPin);
-#else
-    _detachISR = true;
-#endif
-    return;
-  }
-  switch (_state) {
-  case RESPONSE:            // Spec: 80us LOW followed by 80us HIGH
-    if (delta < 65) {       // Spec: 20-200us to first falling edge of response
-      _us -= delta;
-      break; //do nothing, it started the response signal
-      
-// --------------- issue: https://github.com/particle-iot/device-os/issues/1654 -----------------
-//    } if (125 < delta && delta < 200) { // originally 
-    } if (125 < delta && delta < 220) {   // account for timing offset with Particle Mesh devices
-// ----------------------------------------------------------------------------------------------
-
-#if defined(DHT_DEBUG_TIMING)
-      *_e++ = delta;  // record the edge -> edge time
-#endif
-      _state = DATA;
-    }
-    else {
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-      detachInterrupt(_sigPin);
-#else
-      _detachISR = true;
-#endif
-      _status = DHTLIB_ERROR_RESPONSE_TIMEOUT;
-      _state = STOPPED;
-#if defined(DHT_DEBUG_TIMING)
-      *_e++ = delta;  // record the edge -> edge time
-#endif
-    }
-    break;
-  case DATA:          // Spec: 50us low followed by high of 26-28us = 0, 70us = 1
-    if (60 < delta && delta < 155) { //valid in timing
-      _bits[_idx] <<= 1; // shift the data
-      if (delta > 110) //is a one
-        _bits[_idx] |= 1;
-#if defined(DHT_DEBUG_TIMING)
-      *_e++ = delta;  // record the edge -> edge time
-#endif
-      if (_cnt == 0) { // we have completed the byte, go to next
-        _cnt = 7; // restart at MSB
-        if (++_idx == 5) { // go to next byte, if we have got 5 bytes stop.
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-          detachInterrupt(_sigPin);
-#else
-          _detachISR = true;
-#endif
-          // Verify checksum
-          uint8_t sum = _bits[0] + _bits[1] + _bits[2] + _bits[3];
-          if (_bits[4] != sum) {
-            _status = DHTLIB_ERROR_CHECKSUM;
-            _state = STOPPED;
-          }
-          else {
-            _status = DHTLIB_OK;
-            _state = ACQUIRED;
-            _convert = true;
-          }
-          break;
-        }
-      }
-      else _cnt--;
-    }
-    else if (delta < 10) {
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-      detachInterrupt(_sigPin);
-#else
-      _detachISR = true;
-#endif
-      _status = DHTLIB_ERROR_DELTA;
-      _state = STOPPED;
-    }
-    else {
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-      detachInterrupt(_sigPin);
-#else
-      _detachISR = true;
-#endif
-      _status = DHTLIB_ERROR_DATA_TIMEOUT;
-      _state = STOPPED;
-    }
-    break;
-  default:
-    break;
-  }
-}
-
-void PietteTech_DHT::convert() {
-  // Calculate the temperature and humidity based on the sensor type
-  switch (_type) {
-  case DHT11:
-    _hum = _bits[0];
-    _temp = _bits[2];
-    break;
-  case DHT22:
-  case DHT21:
-    _hum = word(_bits[0], _bits[1]) * 0.1;
-    _temp = (_bits[2] & 0x80 ?
-      -word(_bits[2] & 0x7F, _bits[3]) :
-      word(_bits[2], _bits[3])) * 0.1;
-    break;
-  }
-  _convert = false;
-}
-
-bool PietteTech_DHT::acquiring() {
-  if (_state != ACQUIRED && _state != STOPPED)
-    return true;
-  return false;
-}
-
-int PietteTech_DHT::getStatus() {
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-  // no extra steps required
-#else
-  detachISRIfRequested();
-#endif
-  return _status;
-}
-
-float PietteTech_DHT::getCelsius() {
-  DHT_CHECK_STATE;
-  return _temp;
-}
-
-float PietteTech_DHT::getHumidity() {
-  DHT_CHECK_STATE;
-  return _hum;
-}
-
-float PietteTech_DHT::getFahrenheit() {
-  DHT_CHECK_STATE;
-  return CtoF(_temp);
-}
-
-float PietteTech_DHT::getKelvin() {
-  DHT_CHECK_STATE;
-  return _temp + 273.15;
-}
-
 // 
-// Added methods for supporting Adafruit Unified Sensor framework
+// Start with the fixed timing windows
 // 
-float PietteTech_DHT::readTemperature() {
-  acquireAndWait();
-  return getCelsius();
-}
-
-float PietteTech_DHT::readHumidity() {
-  acquireAndWait();
-  return getHumidity();
-}
-
-// delta max = 0.6544 wrt dewPoint()
-// 5x faster than dewPoint()
-// reference: http://en.wikipedia.org/wiki/Dew_point
-double PietteTech_DHT::getDewPoint() {
-  DHT_CHECK_STATE;
-  double a = 17.271;
-  double b = 237.7;
-  double temp_ = (a * (double)_temp) / (b + (double)_temp) + log((double)_hum / 100);
-  double Td = (b * temp_) / (a - temp_);
-  return Td;
+void DHTLearnedTiming::beginTiming() {
+  _oneThreshold = 110;
+  _dataMin = 60;
+  _dataMax = 155;
+  _responseMin = 125;
+  _responseMax = 220;
+  _zeroMean16 = 0;
+  _oneMean16 = 0;
+  _responseMean16 = 0;
+  resetTiming();
 }
 
-// dewPoint function NOAA
-// reference: http://wahiduddin.net/calc/density_algorithms.htm
-double PietteTech_DHT::getDewPointSlow() {
-  DHT_CHECK_STATE;
-  double a0 = (double) 373.15 / (273.15 + (double)_temp);
-  double SUM = (double)-7.90298 * (a0 - 1.0);
-  SUM += 5.02808 * log10(a0);
-  SUM += -1.3816e-7 * (pow(10, (11.344*(1 - 1 / a0))) - 1);
-  SUM += 8.1328e-3 * (pow(10, (-3.49149*(a0 - 1))) - 1);
-  SUM += log10(1013.246);
-  double VP = pow(10, SUM - 3) * (double)_hum;
-  double T = log(VP / 0.61078); // temp var
-  return (241.88 * T) / (17.558 - T);
-}
+// 
+// Move the timing windows towards the timing of a good reading.  The
+// average 0 and 1 bit times and the response time are smoothed over
+// about 8 readings; the 1 threshold is midway between the 0 and 1 bit
+// times and the windows extend beyond them by a margin proportional to
+// their separation.  Integer math only, as this runs in the ISR.
+// 
+void DHTLearnedTiming::calibrate() {
+  if (_zeros == 0 || _ones == 0)
+    return;                         // need both kinds of bits
+
+  int32_t zero16 = ((int32_t)_zeroSum << 4) / _zeros;
+  int32_t one16 = ((int32_t)_oneSum << 4) / _ones;
+  int32_t response16 = (int32_t)_responseDelta << 4;
+
+  if (_oneMean16 == 0) {            // first good reading
+    _zeroMean16 = zero16;
+    _oneMean16 = one16;
+    _responseMean16 = response16;
+  }
+  else {
+    _zeroMean16 += (zero16 - _zeroMean16) / 8;
+    _oneMean16 += (one16 - _oneMean16) / 8;
+    _responseMean16 += (response16 - _responseMean16) / 8;
+  }
 
-double PietteTech_DHT::getHeatIndex() {
-  DHT_CHECK_STATE;
-	return -8.78469475556 
-         +1.61139411      * (double)_temp 
-         +2.33854883889                           * (double)_hum 
-         -0.14611605      * (double)_temp         * (double)_hum 
-         -0.012308094     * pow((double)_temp, 2) 
-         -0.0164248277778                         * pow((double)_hum, 2) 
-         +0.002211732     * pow((double)_temp, 2) * (double)_hum 
-         +0.00072546      * (double)_temp         * pow((double)_hum, 2) 
-         -0.000003582     * pow((double)_temp, 2) * pow((double)_hum, 2);
-}
+  int32_t zero = _zeroMean16 >> 4;
+  int32_t one = _oneMean16 >> 4;
+  int32_t response = _responseMean16 >> 4;
+  int32_t gap = one - zero;
+  if (gap < 16)
+    return;                         // implausible; keep the last windows
 
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-// no extra steps required
-#else
-void PietteTech_DHT::detachISRIfRequested() {
-  if (_detachISR) {
-    detachInterrupt(_sigPin);
-    _detachISR = false;
-  }
+  _oneThreshold = constrain((zero + one) / 2, 80, 140);
+  _dataMin = constrain(zero - gap / 2, 20, 70);
+  _dataMax = constrain(one + gap, 140, 250);
+  _responseMin = constrain(response - 50, 70, 140);   // above the 65us ignored edge
+  _responseMax = constrain(response + 50, 200, 300);
 }
-#endif
@@ -24,6 +24,38 @@
 // 
 //      November 2021       Added calculation for HeatIndex and 
 //                          conversion CtoF() and FtoC()
+// Team Practical Projects
+//      October 2026        Start pulse and startup settle time no longer
+//                          block: acquire() pulls the line low and returns,
+//                          and acquiring() releases it once the pulse time
+//                          has passed.  begin() no longer delays 1 second.
+//                          Added abort() to give up on a sensor that does
+//                          not respond, so other sensors can be read.
+//                          The ISR only measures the edge->edge time; the
+//                          bits are decoded by decode(), which replay()
+//                          can feed with recorded or synthetic edge traces.
+//                          The 0/1 bit threshold and the data and response
+//                          timing windows are learned from good readings.
+//                          Added an edge timing histogram and counts of
+//                          good readings and of each error code.
+//                          The driver is now the class template
+//                          PietteTech_DHT_T (PietteTech_DHT_T.h), whose
+//                          sensor type, timing windows and edge timing
+//                          log are compile time policies; this class is
+//                          a thin wrapper that keeps the original API.
+//                          The edge timing log is bounds checked.
+//                          A DHT21/22 start pulse (1.5ms, 20ms at most)
+//                          is held with a busy wait, as polling could
+//                          hold it too long; only a DHT11's is ended by
+//                          acquiring().
+//                          The statistics (counts of good readings and
+//                          of each error code, edge time histogram) are
+//                          a compile time policy too; PietteTech_DHT
+//                          keeps them.
+//                          Times are kept in the type that micros() and
+//                          millis() return, so that the edge times stay
+//                          right when micros() passes 2^32 on a host
+//                          with a 64 bit unsigned long.
 //
 // Based on adaptation by niesteszeck (github/niesteszeck)
 // Based on original DHT11 library (http://playgroudn.adruino.cc/Main/DHT11Lib)
@@ -35,54 +67,25 @@
 #ifndef __PIETTETECH_DHT_H__
 #define __PIETTETECH_DHT_H__
 
- // There appears to be a overrun in memory on this class.  For now please leave DHT_DEBUG_TIMING enabled
+ // DHT_DEBUG_TIMING gives PietteTech_DHT the edge->edge timing log, _edges[].
+ // It used to be needed to avoid an overrun in memory; the log is now bounds
+ // checked, but it stays enabled for the sketches that print it.
 #define DHT_DEBUG_TIMING        // Enable this for edge->edge timing collection
 
-#include <Particle.h>
-#include <math.h>
+#include "PietteTech_DHT_T.h"
 
-const char DHTLIB_VERSION[]              = "0.0.14";
+const char DHTLIB_VERSION[]              = "0.0.21";
 
-// device types
-const int  DHT11                         = 11;
-const int  DHT21                         = 21;
-const int  AM2301                        = 21;
-const int  DHT22                         = 22;
-const int  AM2302                        = 22;
-                                            
-// state codes                              
-const int  DHTLIB_OK                     =  0;
-const int  DHTLIB_ACQUIRING              =  1;
-const int  DHTLIB_ACQUIRED               =  2;
-const int  DHTLIB_RESPONSE_OK            =  3;
-                                            
-// error codes                              
-const int  DHTLIB_ERROR_CHECKSUM         = -1;
-const int  DHTLIB_ERROR_ISR_TIMEOUT      = -2;
-const int  DHTLIB_ERROR_RESPONSE_TIMEOUT = -3;
-const int  DHTLIB_ERROR_DATA_TIMEOUT     = -4;
-const int  DHTLIB_ERROR_ACQUIRING        = -5;
-const int  DHTLIB_ERROR_DELTA            = -6;
-const int  DHTLIB_ERROR_NOTSTARTED       = -7;
-
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-# define DHT_CHECK_STATE                    \
-         if(_state == STOPPED)              \
-           return _status;                  \
-         else if(_state != ACQUIRED)        \
-           return DHTLIB_ERROR_ACQUIRING;   \
-         if(_convert) convert();
+#if defined(DHT_DEBUG_TIMING)
+typedef DHTEdgeLog  DHTDefaultEdges;
 #else
-# define DHT_CHECK_STATE                    \
-         detachISRIfRequested();            \
-         if(_state == STOPPED)              \
-           return _status;                  \
-         else if(_state != ACQUIRED)        \
-           return DHTLIB_ERROR_ACQUIRING;   \
-         if(_convert) convert();
+typedef DHTNoEdges  DHTDefaultEdges;
 #endif
 
-class PietteTech_DHT
+// compiled once, in PietteTech_DHT.cpp
+extern template class PietteTech_DHT_T<DHTAnyType, DHTLearnedTiming, DHTDefaultEdges, DHTStats>;
+
+class PietteTech_DHT : public PietteTech_DHT_T<DHTAnyType, DHTLearnedTiming, DHTDefaultEdges, DHTStats>
 {
 public:
   // either this combination of constructor and begin() call
@@ -97,62 +100,5 @@ public:
   //        it is no longer used or needed
   // 
   void     isrCallback();
-  int      acquire();
-  int      acquireAndWait(uint32_t timeout = 0);
-  static inline
-  double   CtoF(double celsius)    { return (celsius * 9 / 5 + 32); };
-  static inline 
-  double   FtoC(double fahrenheit) { return ((fahrenheit - 32) * 5 / 9); };
-  float    getCelsius();
-  float    getFahrenheit();
-  float    getKelvin();
-  double   getDewPoint();
-  double   getDewPointSlow();
-  double   getHeatIndex();
-  float    getHumidity();
-  bool     acquiring();
-  int      getStatus();
-  float    readTemperature();
-  float    readHumidity();
-#if defined(DHT_DEBUG_TIMING)
-  volatile 
-  uint8_t  _edges[41];
-#endif
-
-private:
-  void     _isrCallback();
-  void     convert();
-#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
-  // no extra steps required
-#else
-  void     detachISRIfRequested();           
-  volatile 
-  bool     _detachISR;
-#endif
-  enum states { RESPONSE = 0, DATA = 1, ACQUIRED = 2, STOPPED = 3, ACQUIRING = 4 };
-  volatile 
-  states   _state;
-  volatile 
-  int      _status;
-  volatile 
-  uint8_t  _bits[5];
-  volatile 
-  uint8_t  _cnt;
-  volatile 
-  uint8_t  _idx;
-  volatile 
-  uint32_t _us;
-  volatile 
-  bool     _convert;
-#if defined(DHT_DEBUG_TIMING)
-  volatile 
-  uint8_t *_e;
-#endif
-  int      _sigPin;
-  int      _type;
-  uint32_t _lastreadtime;
-  bool     _firstreading;
-  float    _hum;
-  float    _temp;
 };
 #endif
@@ -0,0 +1,884 @@
+// FILE:        PietteTech_DHT_T.h
+// VERSION:     0.0.21
+// PURPOSE:     Particle Interrupt driven lib for DHT sensors, specialized
+//              at compile time
+// LICENSE:     GPL v3 (http://www.gnu.org/licenses/gpl.html)
+//
+// Team Practical Projects
+//      October 2026        The driver is the class template PietteTech_DHT_T,
+//                          specialized at compile time by four policies:
+//
+//   Type     DHT11Type, DHT22Type (also DHT21, AM2301, AM2302) or DHTAnyType.
+//            Gives the start pulse time and decodes the data bytes.  With a
+//            fixed type only that sensor's decoder is compiled in and the
+//            start pulse is a constant.  DHTAnyType stores the type given to
+//            begin() and chooses at run time, as PietteTech_DHT always has.
+//   Timing   DHTLearnedTiming learns the 0/1 bit threshold and the data and
+//            response timing windows from good readings.
+//            DHTFixedTiming<one, dataMin, dataMax, responseMin, responseMax>
+//            uses fixed windows (by default the original 110us, 60-155us and
+//            125-220us), so the ISR compares against constants and the
+//            windows take no RAM.
+//   Edges    DHTNoEdges, or DHTEdgeLog to record the edge->edge times of the
+//            last reading in _edges[] (what DHT_DEBUG_TIMING does).
+//   Stats    DHTNoStats, or DHTStats to count good readings and each error
+//            code and keep a histogram of the edge->edge times (160 bytes).
+//
+// For example, a DHT11 on D3 read with the original fixed timing:
+//
+//   PietteTech_DHT_T<DHT11Type, DHTFixedTiming<> > DHT(D3);
+//
+// PietteTech_DHT (PietteTech_DHT.h) is a thin wrapper around
+// PietteTech_DHT_T<DHTAnyType, DHTLearnedTiming, DHTEdgeLog, DHTStats>
+// that keeps the original constructors.
+//
+// Based on PietteTech_DHT; see PietteTech_DHT.h for its history.
+
+//    Timing of DHT22 SDA signal line after MCU pulls low for 1ms
+//    https://github.com/mtnscott/Spark_DHT/AM2302.pdf
+//
+//  - - - -            -----           -- - - --            ------- - -
+//         \          /     \         /  \      \          /
+//          +        /       +       /    +      +        /
+//           \      /         \     /      \      \      /
+//            ------           -----        -- - --------
+// ^        ^                ^                   ^          ^
+// |   Ts   |        Tr      |        Td         |    Te    |
+//
+//    Ts : Start time from MCU changing SDA from Output High to Tri-State (Hi-Z)
+//         Spec: 20-200us             Tested: < 65us
+//    Tr : DHT response to MCU controlling SDA and pulling Low and High to
+//         start of first data bit
+//         Spec: 150-170us            Tested: 125 - 200us
+//    Td : DHT data bit, falling edge to falling edge
+//         Spec: '0' 70us - 85us      Tested: 60 - 110us
+//         Spec: '1' 116us - 130us    Tested: 111 - 155us
+//    Te : DHT releases SDA to Tri-State (Hi-Z)
+//         Spec: 45-55us              Not Tested
+
+#ifndef __PIETTETECH_DHT_T_H__
+#define __PIETTETECH_DHT_T_H__
+
+#include <Particle.h>
+#include <math.h>
+
+// device types
+const int  DHT11                         = 11;
+const int  DHT21                         = 21;
+const int  AM2301                        = 21;
+const int  DHT22                         = 22;
+const int  AM2302                        = 22;
+
+// state codes
+const int  DHTLIB_OK                     =  0;
+const int  DHTLIB_ACQUIRING              =  1;
+const int  DHTLIB_ACQUIRED               =  2;
+const int  DHTLIB_RESPONSE_OK            =  3;
+
+// error codes
+const int  DHTLIB_ERROR_CHECKSUM         = -1;
+const int  DHTLIB_ERROR_ISR_TIMEOUT      = -2;
+const int  DHTLIB_ERROR_RESPONSE_TIMEOUT = -3;
+const int  DHTLIB_ERROR_DATA_TIMEOUT     = -4;
+const int  DHTLIB_ERROR_ACQUIRING        = -5;
+const int  DHTLIB_ERROR_DELTA            = -6;
+const int  DHTLIB_ERROR_NOTSTARTED       = -7;
+const int  DHTLIB_NUM_ERRORS             =  7;
+
+// start pulses up to this long (a DHT21/22's) are timed with a busy wait;
+// polling could hold them past the sensor's 20ms maximum
+const uint32_t DHT_BLOCKING_PULSE_US     = 2000;
+
+// edge timing histogram
+const int  DHT_HISTOGRAM_BUCKETS         = 32;
+const int  DHT_HISTOGRAM_BUCKET_US       =  8;  // last bucket holds 248us and up
+
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+# define DHT_CHECK_STATE                    \
+         if(_state == STOPPED)              \
+           return _status;                  \
+         else if(_state != ACQUIRED)        \
+           return DHTLIB_ERROR_ACQUIRING;   \
+         if(_convert) convert();
+#else
+# define DHT_CHECK_STATE                    \
+         detachISRIfRequested();            \
+         if(_state == STOPPED)              \
+           return _status;                  \
+         else if(_state != ACQUIRED)        \
+           return DHTLIB_ERROR_ACQUIRING;   \
+         if(_convert) convert();
+#endif
+
+//
+// Type policies
+//
+class DHT11Type
+{
+public:
+  static const int TYPE = DHT11;
+  int      getType() const    { return DHT11; }
+protected:
+  void     setType(uint8_t dht_type) { }
+  uint32_t startPulse() const { return 18000; }     // DHT11 Spec: 18ms min
+  void     convertBits(const volatile uint8_t *bits, float &hum, float &temp) const {
+    hum = bits[0];
+    temp = bits[2];
+  }
+};
+
+class DHT22Type
+{
+public:
+  static const int TYPE = DHT22;                    // also DHT21
+  int      getType() const    { return DHT22; }
+protected:
+  void     setType(uint8_t dht_type) { }
+  uint32_t startPulse() const { return 1500; }      // DHT22 Spec: 0.8-20ms, 1ms typ
+  void     convertBits(const volatile uint8_t *bits, float &hum, float &temp) const {
+    hum = ((bits[0] << 8) | bits[1]) * 0.1;
+    temp = (bits[2] & 0x80 ?
+      -(((bits[2] & 0x7F) << 8) | bits[3]) :
+      ((bits[2] << 8) | bits[3])) * 0.1;
+  }
+};
+
+class DHTAnyType : protected DHT11Type, protected DHT22Type
+{
+public:
+  static const int TYPE = 0;                        // the type is given to begin()
+  int      getType() const    { return _type; }
+protected:
+  void     setType(uint8_t dht_type) { _type = dht_type; }
+  uint32_t startPulse() const {
+    return (_type == DHT11) ? DHT11Type::startPulse() : DHT22Type::startPulse();
+  }
+  void     convertBits(const volatile uint8_t *bits, float &hum, float &temp) const {
+    switch (_type) {
+    case DHT11:
+      DHT11Type::convertBits(bits, hum, temp);
+      break;
+    case DHT22:
+    case DHT21:
+      DHT22Type::convertBits(bits, hum, temp);
+      break;
+    }
+  }
+private:
+  uint8_t  _type;
+};
+
+//
+// Timing policies.  The decoder asks the policy whether an edge->edge time
+// is a valid response or data bit and whether a bit is a 1, and tells it
+// the timing of each reading so that it can learn from good readings.
+//
+class DHTLearnedTiming
+{
+public:
+  int      getOneThreshold() const { return _oneThreshold; }  // us; longer bits are 1s
+  int      getDataMin() const      { return _dataMin; }       // us; valid data bits are
+  int      getDataMax() const      { return _dataMax; }       //   between these
+  int      getResponseMin() const  { return _responseMin; }   // us; valid responses are
+  int      getResponseMax() const  { return _responseMax; }   //   between these
+protected:
+  void     beginTiming();
+  void     resetTiming() {
+    _zeroSum = 0;
+    _oneSum = 0;
+    _zeros = 0;
+    _ones = 0;
+    _responseDelta = 0;
+  }
+  bool     isResponse(unsigned long delta) const {
+    return _responseMin < delta && delta < _responseMax;
+  }
+  bool     isData(unsigned long delta) const {
+    return _dataMin < delta && delta < _dataMax;
+  }
+  bool     isOne(unsigned long delta) const { return delta > _oneThreshold; }
+  void     recordResponse(unsigned long delta) { _responseDelta = delta; }
+  void     recordBit(unsigned long delta, bool one) {
+    if (one) {
+      _oneSum += delta;
+      _ones++;
+    }
+    else {
+      _zeroSum += delta;
+      _zeros++;
+    }
+  }
+  void     calibrate();
+private:
+  // timing windows, learned by calibrate()
+  volatile
+  uint16_t _oneThreshold;
+  volatile
+  uint16_t _dataMin;
+  volatile
+  uint16_t _dataMax;
+  volatile
+  uint16_t _responseMin;
+  volatile
+  uint16_t _responseMax;
+  int32_t  _zeroMean16;                       // learned timing, in 1/16 us
+  int32_t  _oneMean16;
+  int32_t  _responseMean16;
+  // timing of the reading in progress
+  volatile
+  uint16_t _zeroSum;
+  volatile
+  uint16_t _oneSum;
+  volatile
+  uint8_t  _zeros;
+  volatile
+  uint8_t  _ones;
+  volatile
+  uint16_t _responseDelta;
+};
+
+template <uint16_t ONE_THRESHOLD = 110, uint16_t DATA_MIN = 60, uint16_t DATA_MAX = 155,
+          uint16_t RESPONSE_MIN = 125, uint16_t RESPONSE_MAX = 220>
+class DHTFixedTiming
+{
+public:
+  int      getOneThreshold() const { return ONE_THRESHOLD; }
+  int      getDataMin() const      { return DATA_MIN; }
+  int      getDataMax() const      { return DATA_MAX; }
+  int      getResponseMin() const  { return RESPONSE_MIN; }
+  int      getResponseMax() const  { return RESPONSE_MAX; }
+protected:
+  void     beginTiming() { }
+  void     resetTiming() { }
+  bool     isResponse(unsigned long delta) const {
+    return RESPONSE_MIN < delta && delta < RESPONSE_MAX;
+  }
+  bool     isData(unsigned long delta) const {
+    return DATA_MIN < delta && delta < DATA_MAX;
+  }
+  bool     isOne(unsigned long delta) const { return delta > ONE_THRESHOLD; }
+  void     recordResponse(unsigned long delta) { }
+  void     recordBit(unsigned long delta, bool one) { }
+  void     calibrate() { }
+};
+
+//
+// Edge timing policies
+//
+class DHTNoEdges
+{
+protected:
+  void     resetEdges() { }
+  void     recordEdge(unsigned long delta) { }
+};
+
+class DHTEdgeLog
+{
+public:
+  volatile
+  uint8_t  _edges[41];                        // the response, then 40 data bits
+protected:
+  void     resetEdges() {
+    //
+    // Clear the debug timings array
+    //
+    for (int i = 0; i < 41; i++) _edges[i] = 0;
+    _e = &_edges[0];
+  }
+  void     recordEdge(unsigned long delta) {
+    if (_e < &_edges[41])                     // never write past the end
+      *_e++ = delta;  // record the edge -> edge time
+  }
+private:
+  volatile
+  uint8_t *_e;
+};
+
+//
+// Statistics policies:  counts of good readings and of each error code, and
+// a histogram of the edge->edge times
+//
+class DHTNoStats
+{
+public:
+  uint32_t getOkCount() const            { return 0; }
+  uint32_t getErrorCount(int status) const { return 0; }
+  void     getEdgeHistogram(uint32_t *counts) const {
+    for (int i = 0; i < DHT_HISTOGRAM_BUCKETS; i++) counts[i] = 0;
+  }
+  void     resetStats() { }
+protected:
+  void     recordOk() { }
+  void     recordError(int status) { }
+  void     recordDelta(unsigned long delta) { }
+};
+
+class DHTStats
+{
+public:
+  uint32_t getOkCount() const            { return _okCount; }
+  uint32_t getErrorCount(int status) const {  // count of one error code
+    if (status < -DHTLIB_NUM_ERRORS || status >= 0)
+      return 0;
+    return _errorCounts[-status - 1];
+  }
+  void     getEdgeHistogram(uint32_t *counts) const {  // DHT_HISTOGRAM_BUCKETS counts
+    for (int i = 0; i < DHT_HISTOGRAM_BUCKETS; i++) counts[i] = _histogram[i];
+  }
+  void     resetStats() {
+    _okCount = 0;
+    for (int i = 0; i < DHTLIB_NUM_ERRORS; i++) _errorCounts[i] = 0;
+    for (int i = 0; i < DHT_HISTOGRAM_BUCKETS; i++) _histogram[i] = 0;
+  }
+protected:
+  void     recordOk() { _okCount++; }
+  void     recordError(int status) {
+    if (-DHTLIB_NUM_ERRORS <= status && status < 0)
+      _errorCounts[-status - 1]++;
+  }
+  void     recordDelta(unsigned long delta) {
+    _histogram[delta < DHT_HISTOGRAM_BUCKETS * DHT_HISTOGRAM_BUCKET_US ?
+               delta / DHT_HISTOGRAM_BUCKET_US : DHT_HISTOGRAM_BUCKETS - 1]++;
+  }
+private:
+  volatile
+  uint32_t _okCount;
+  volatile
+  uint32_t _errorCounts[DHTLIB_NUM_ERRORS];
+  volatile
+  uint32_t _histogram[DHT_HISTOGRAM_BUCKETS];
+};
+
+//
+// The driver
+//
+template <class Type, class Timing = DHTLearnedTiming, class Edges = DHTNoEdges,
+          class Stats = DHTNoStats>
+class PietteTech_DHT_T : public Type, public Timing, public Edges, public Stats
+{
+public:
+  // either this combination of constructor and begin() call
+  PietteTech_DHT_T(uint8_t sigPin, uint8_t dht_type = Type::TYPE);
+  void begin();
+  // or this
+  PietteTech_DHT_T();
+  void begin(uint8_t sigPin, uint8_t dht_type = Type::TYPE);
+
+  int      acquire();
+  int      acquireAndWait(uint32_t timeout = 0);
+  void     abort();
+  //
+  // Decoder testing: feed a trace of edge->edge times (in microseconds,
+  // starting with the first falling edge after the start pulse) through
+  // the same decoder the ISR uses, then read the result as usual.
+  // Returns the resulting status; not allowed while acquiring.
+  //
+  int      replay(const uint16_t *deltas, int count);
+  //
+  // Statistics (getOkCount(), getErrorCount(), getEdgeHistogram() and
+  // resetStats()) come from the Stats policy, and the timing windows
+  // (getOneThreshold() etc.) from the Timing policy.
+  //
+  static inline
+  double   CtoF(double celsius)    { return (celsius * 9 / 5 + 32); };
+  static inline
+  double   FtoC(double fahrenheit) { return ((fahrenheit - 32) * 5 / 9); };
+  float    getCelsius();
+  float    getFahrenheit();
+  float    getKelvin();
+  double   getDewPoint();
+  double   getDewPointSlow();
+  double   getHeatIndex();
+  float    getHumidity();
+  bool     acquiring();
+  int      getStatus();
+  float    readTemperature();
+  float    readHumidity();
+
+private:
+  void     _isrCallback();
+  void     convert();
+  void     reset();
+  void     decode(unsigned long delta);
+  void     fail(int status);
+  void     advance();
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+  // no extra steps required
+#else
+  void     detachISRIfRequested();
+  volatile
+  bool     _detachISR;
+#endif
+  enum states { RESPONSE = 0, DATA = 1, ACQUIRED = 2, STOPPED = 3, ACQUIRING = 4,
+                SETTLING = 5, STARTING = 6 };
+  volatile
+  states   _state;
+  volatile
+  int      _status;
+  volatile
+  uint8_t  _bits[5];
+  volatile
+  uint8_t  _cnt;
+  volatile
+  uint8_t  _idx;
+  volatile
+  unsigned long _us;
+  volatile
+  uint32_t _carry;
+  volatile
+  bool     _convert;
+  int      _sigPin;
+  unsigned long _lastreadtime;
+  unsigned long _begintime;
+  bool     _settled;
+  unsigned long _startus;
+  bool     _firstreading;
+  float    _hum;
+  float    _temp;
+};
+
+template <class Type, class Timing, class Edges, class Stats>
+PietteTech_DHT_T<Type, Timing, Edges, Stats>::PietteTech_DHT_T() {
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+PietteTech_DHT_T<Type, Timing, Edges, Stats>::PietteTech_DHT_T(uint8_t sigPin, uint8_t dht_type) {
+  _sigPin = sigPin;
+  this->setType(dht_type);
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+void PietteTech_DHT_T<Type, Timing, Edges, Stats>::begin() {
+  _firstreading = true;
+  _lastreadtime = 0;
+  _state = STOPPED;
+  _status = DHTLIB_ERROR_NOTSTARTED;
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+  // no extra steps required
+#else
+  _detachISR = false;
+#endif
+
+  pinMode(_sigPin, OUTPUT);
+  digitalWrite(_sigPin, HIGH);
+
+  // allow for sensor to settle after startup; an acquire() in the
+  // meantime waits in the SETTLING state rather than blocking here
+  _begintime = millis();
+  _settled = false;
+
+  this->beginTiming();
+  this->resetStats();
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+void PietteTech_DHT_T<Type, Timing, Edges, Stats>::begin(uint8_t sigPin, uint8_t dht_type) {
+  _sigPin = sigPin;
+  this->setType(dht_type);
+  this->begin();
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+int PietteTech_DHT_T<Type, Timing, Edges, Stats>::acquire() {
+  // Check if sensor was read less than two seconds ago and return early
+  // to use last reading
+  unsigned long currenttime = millis();
+  if (!_firstreading && ((currenttime - _lastreadtime) < 2000)) {
+    // return last correct measurement, (this read time - last read time) < device limit
+    return DHTLIB_ACQUIRED;
+  }
+
+  if (_state == STOPPED || _state == ACQUIRED) {
+    //
+    // Setup the initial state machine
+    //
+    _firstreading = false;
+    _lastreadtime = currenttime;
+    reset();
+
+    //
+    // Start the pulse that triggers the DHT device to send us
+    // temperature and humidity data, once it has settled after
+    // startup.  advance() (called from acquiring()) ends the pulse.
+    //
+    _state = SETTLING;
+    advance();
+
+    return DHTLIB_ACQUIRING;
+  }
+  else
+    return DHTLIB_ERROR_ACQUIRING;
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+int PietteTech_DHT_T<Type, Timing, Edges, Stats>::acquireAndWait(uint32_t timeout) {
+  acquire();
+  // the settle time after begin() doesn't count against the timeout
+  while (_state == SETTLING && acquiring()) Particle.process();
+  uint32_t start = millis();
+  while (acquiring() && (timeout == 0 || ((millis() - start) < timeout))) Particle.process();
+  if (acquiring())
+    abort();
+  return getStatus();
+}
+
+//
+// Give up on an acquisition in progress, e.g. because the sensor did not
+// respond.  The status becomes DHTLIB_ERROR_RESPONSE_TIMEOUT.  Must not be
+// called from an ISR.
+//
+template <class Type, class Timing, class Edges, class Stats>
+void PietteTech_DHT_T<Type, Timing, Edges, Stats>::abort() {
+  if (!acquiring())
+    return;
+
+  if (_state == SETTLING || _state == STARTING) {
+    pinMode(_sigPin, INPUT);        // end the start pulse, if any
+    _status = DHTLIB_ERROR_RESPONSE_TIMEOUT;
+    _state = STOPPED;
+    this->recordError(DHTLIB_ERROR_RESPONSE_TIMEOUT);
+  }
+  else {                            // the ISR is attached
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+    fail(DHTLIB_ERROR_RESPONSE_TIMEOUT);
+#else
+    _detachISR = true;              // the ISR ignores any further edges
+    fail(DHTLIB_ERROR_RESPONSE_TIMEOUT);
+    detachISRIfRequested();
+#endif
+  }
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+int PietteTech_DHT_T<Type, Timing, Edges, Stats>::replay(const uint16_t *deltas, int count) {
+  if (acquiring())
+    return DHTLIB_ERROR_ACQUIRING;
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+  // no extra steps required
+#else
+  detachISRIfRequested();           // finish off the last real acquisition
+#endif
+
+  reset();
+  _status = DHTLIB_ERROR_DATA_TIMEOUT;  // unless the trace completes a reading
+  _state = RESPONSE;
+  for (int i = 0; i < count && _state != STOPPED && _state != ACQUIRED; i++)
+    decode(deltas[i]);
+
+  if (_state != STOPPED && _state != ACQUIRED)
+    _state = STOPPED;               // the trace ended early
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+  // no extra steps required
+#else
+  _detachISR = false;               // the decoder asked, but no ISR is attached
+#endif
+  return _status;
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+void PietteTech_DHT_T<Type, Timing, Edges, Stats>::_isrCallback() {
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+  // no extra steps required
+#else
+  // NOTE:
+  // We can't call detachInterrupt() inside the ISR (c.f. https://github.com/particle-iot/device-os/issues/1835)
+  // so we'll set _detachISR inside the ISR when we're done
+  // and count on code on the main thread to detach it via detachISRIfRequested().
+  // Getting another interrupt after we've already requested a detach is benign
+  // so we'll just ignore this interrupt and return.
+
+  if (_detachISR) return;
+#endif
+
+  unsigned long newUs = micros();
+  unsigned long delta = (newUs - _us);
+  _us = newUs;
+
+  decode(delta);
+}
+
+//
+// Set up the decoder for a new acquisition
+//
+template <class Type, class Timing, class Edges, class Stats>
+void PietteTech_DHT_T<Type, Timing, Edges, Stats>::reset() {
+  this->resetEdges();
+  this->resetTiming();
+
+  //
+  // Set the initial values in the buffer and variables
+  //
+  for (int i = 0; i < 5; i++) _bits[i] = 0;
+  _cnt = 7;
+  _idx = 0;
+  _carry = 0;
+  _hum = 0;
+  _temp = 0;
+}
+
+//
+// Decode one edge, given the time since the previous edge.  Called from
+// the ISR, or from replay().
+//
+template <class Type, class Timing, class Edges, class Stats>
+void PietteTech_DHT_T<Type, Timing, Edges, Stats>::decode(unsigned long delta) {
+  delta += _carry;                  // time of an ignored edge, if any
+  _carry = 0;
+
+  this->recordDelta(delta);
+
+  if (delta > 6000) {
+    fail(DHTLIB_ERROR_ISR_TIMEOUT);
+    return;
+  }
+  switch (_state) {
+  case RESPONSE:            // Spec: 80us LOW followed by 80us HIGH
+    if (delta < 65) {       // Spec: 20-200us to first falling edge of response
+      _carry = delta;       // measure the next edge from the previous one
+      break; //do nothing, it started the response signal
+
+// --------------- issue: https://github.com/particle-iot/device-os/issues/1654 -----------------
+//    } if (125 < delta && delta < 200) { // originally
+//    } if (125 < delta && delta < 220) { // account for timing offset with Particle Mesh devices
+    } if (this->isResponse(delta)) {  // Timing policy, by default 125-220
+// ----------------------------------------------------------------------------------------------
+
+      this->recordEdge(delta);
+      this->recordResponse(delta);
+      _state = DATA;
+    }
+    else {
+      this->recordEdge(delta);
+      fail(DHTLIB_ERROR_RESPONSE_TIMEOUT);
+    }
+    break;
+  case DATA:          // Spec: 50us low followed by high of 26-28us = 0, 70us = 1
+    if (this->isData(delta)) { //valid in timing (by default 60-155)
+      bool one = this->isOne(delta);  // by default over 110
+      _bits[_idx] <<= 1; // shift the data
+      if (one) //is a one
+        _bits[_idx] |= 1;
+      this->recordBit(delta, one);
+      this->recordEdge(delta);
+      if (_cnt == 0) { // we have completed the byte, go to next
+        _cnt = 7; // restart at MSB
+        if (++_idx == 5) { // go to next byte, if we have got 5 bytes stop.
+          // Verify checksum
+          uint8_t sum = _bits[0] + _bits[1] + _bits[2] + _bits[3];
+          if (_bits[4] != sum) {
+            fail(DHTLIB_ERROR_CHECKSUM);
+          }
+          else {
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+            detachInterrupt(_sigPin);
+#else
+            _detachISR = true;
+#endif
+            this->calibrate();
+            this->recordOk();
+            _status = DHTLIB_OK;
+            _state = ACQUIRED;
+            _convert = true;
+          }
+          break;
+        }
+      }
+      else _cnt--;
+    }
+    else if (delta < 10) {
+      fail(DHTLIB_ERROR_DELTA);
+    }
+    else {
+      fail(DHTLIB_ERROR_DATA_TIMEOUT);
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+//
+// End an acquisition with an error
+//
+template <class Type, class Timing, class Edges, class Stats>
+void PietteTech_DHT_T<Type, Timing, Edges, Stats>::fail(int status) {
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+  detachInterrupt(_sigPin);
+#else
+  _detachISR = true;
+#endif
+  _status = status;
+  _state = STOPPED;
+  this->recordError(status);
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+void PietteTech_DHT_T<Type, Timing, Edges, Stats>::convert() {
+  // Calculate the temperature and humidity based on the sensor type
+  this->convertBits(_bits, _hum, _temp);
+  _convert = false;
+}
+
+//
+// Move the start of an acquisition along without blocking:
+// wait for the sensor to settle after begin(), then hold the start
+// pulse low for its minimum time, then release the line and let the
+// ISR receive the data.  Each call does whatever is due and returns.
+// A short start pulse (DHT21/22, 1.5ms) must not exceed 20ms, so it is
+// held with a busy wait; only a long one (DHT11, 18ms minimum and no
+// maximum) is ended by a later call.
+//
+template <class Type, class Timing, class Edges, class Stats>
+void PietteTech_DHT_T<Type, Timing, Edges, Stats>::advance() {
+  if (_state == SETTLING) {
+    if (!_settled && (millis() - _begintime) < 1000)
+      return;                       // allow for sensor to settle after startup
+    _settled = true;
+
+    pinMode(_sigPin, OUTPUT);
+    digitalWrite(_sigPin, LOW);
+    _startus = micros();
+    _state = STARTING;
+    if (this->startPulse() <= DHT_BLOCKING_PULSE_US)
+      delayMicroseconds(this->startPulse());
+  }
+
+  if (_state == STARTING) {
+    if ((micros() - _startus) < this->startPulse())
+      return;
+
+    pinMode(_sigPin, INPUT);        // Note Hi-Z mode with pullup resistor
+                                    // will keep this high until the DHT responds.
+    //
+    // Attach the interrupt handler to receive the data once the DHT
+    // starts to send us data
+    //
+    _us = micros();
+    _state = RESPONSE;
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+    // no extra steps required
+#else
+    _detachISR = false;
+#endif
+
+    attachInterrupt(_sigPin, &PietteTech_DHT_T::_isrCallback, this, FALLING);
+  }
+}
+
+//
+// NOTE:  acquiring() must be called while acquiring to end a DHT11's
+//        start pulse; a DHT21/22's is ended by acquire() itself
+//
+template <class Type, class Timing, class Edges, class Stats>
+bool PietteTech_DHT_T<Type, Timing, Edges, Stats>::acquiring() {
+  advance();
+  if (_state != ACQUIRED && _state != STOPPED)
+    return true;
+  return false;
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+int PietteTech_DHT_T<Type, Timing, Edges, Stats>::getStatus() {
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+  // no extra steps required
+#else
+  detachISRIfRequested();
+#endif
+  return _status;
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+float PietteTech_DHT_T<Type, Timing, Edges, Stats>::getCelsius() {
+  DHT_CHECK_STATE;
+  return _temp;
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+float PietteTech_DHT_T<Type, Timing, Edges, Stats>::getHumidity() {
+  DHT_CHECK_STATE;
+  return _hum;
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+float PietteTech_DHT_T<Type, Timing, Edges, Stats>::getFahrenheit() {
+  DHT_CHECK_STATE;
+  return CtoF(_temp);
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+float PietteTech_DHT_T<Type, Timing, Edges, Stats>::getKelvin() {
+  DHT_CHECK_STATE;
+  return _temp + 273.15;
+}
+
+//
+// Added methods for supporting Adafruit Unified Sensor framework
+//
+template <class Type, class Timing, class Edges, class Stats>
+float PietteTech_DHT_T<Type, Timing, Edges, Stats>::readTemperature() {
+  acquireAndWait();
+  return getCelsius();
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+float PietteTech_DHT_T<Type, Timing, Edges, Stats>::readHumidity() {
+  acquireAndWait();
+  return getHumidity();
+}
+
+// delta max = 0.6544 wrt dewPoint()
+// 5x faster than dewPoint()
+// reference: http://en.wikipedia.org/wiki/Dew_point
+template <class Type, class Timing, class Edges, class Stats>
+double PietteTech_DHT_T<Type, Timing, Edges, Stats>::getDewPoint() {
+  DHT_CHECK_STATE;
+  double a = 17.271;
+  double b = 237.7;
+  double temp_ = (a * (double)_temp) / (b + (double)_temp) + log((double)_hum / 100);
+  double Td = (b * temp_) / (a - temp_);
+  return Td;
+}
+
+// dewPoint function NOAA
+// reference: http://wahiduddin.net/calc/density_algorithms.htm
+template <class Type, class Timing, class Edges, class Stats>
+double PietteTech_DHT_T<Type, Timing, Edges, Stats>::getDewPointSlow() {
+  DHT_CHECK_STATE;
+  double a0 = (double) 373.15 / (273.15 + (double)_temp);
+  double SUM = (double)-7.90298 * (a0 - 1.0);
+  SUM += 5.02808 * log10(a0);
+  SUM += -1.3816e-7 * (pow(10, (11.344*(1 - 1 / a0))) - 1);
+  SUM += 8.1328e-3 * (pow(10, (-3.49149*(a0 - 1))) - 1);
+  SUM += log10(1013.246);
+  double VP = pow(10, SUM - 3) * (double)_hum;
+  double T = log(VP / 0.61078); // temp var
+  return (241.88 * T) / (17.558 - T);
+}
+
+template <class Type, class Timing, class Edges, class Stats>
+double PietteTech_DHT_T<Type, Timing, Edges, Stats>::getHeatIndex() {
+  DHT_CHECK_STATE;
+	return -8.78469475556
+         +1.61139411      * (double)_temp
+         +2.33854883889                           * (double)_hum
+         -0.14611605      * (double)_temp         * (double)_hum
+         -0.012308094     * pow((double)_temp, 2)
+         -0.0164248277778                         * pow((double)_hum, 2)
+         +0.002211732     * pow((double)_temp, 2) * (double)_hum
+         +0.00072546      * (double)_temp         * pow((double)_hum, 2)
+         -0.000003582     * pow((double)_temp, 2) * pow((double)_hum, 2);
+}
+
+#if (SYSTEM_VERSION < SYSTEM_VERSION_v121RC3)
+// no extra steps required
+#else
+template <class Type, class Timing, class Edges, class Stats>
+void PietteTech_DHT_T<Type, Timing, Edges, Stats>::detachISRIfRequested() {
+  if (_detachISR) {
+    detachInterrupt(_sigPin);
+    _detachISR = false;
+  }
+}
+#endif
+
+#endif
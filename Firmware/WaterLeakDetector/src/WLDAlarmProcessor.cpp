@@ -14,33 +14,46 @@
  * then calling methods on the instantiated object to either send a alarm (when it detects and
  * alarm condition) or else to arm for an alarm (when it detects a normal condition).  The instantiated
  * object manages alarms so that an SMS text is send at most once per day, for any persistant alarm
- * condition.  The WLD firmware can send alarms using the instantiated object's sendAlarm..() methods
+ * condition.  The WLD firmware can report alarms using the instantiated object's setCondition() method
  * each and every time it detects an alarm condition, regardless of how frequently this occurs.  The
  * instantiated object manages the sensding of SMS texts to the user so that the user only receives one alarm
  * per day for any persistent alarm.  Conversely, the WLD firmmware should continuously re-arm an alarm
  * whenever a non-alarm condition is detected so that any new alarm condition will alert the user
  * immediately.
  * 
- * This class supports three active alarm types, and an additional alarm test (to make sure that the
+ * Alarm types are described by a table (ALARM_TABLE in WLDAlarmProcessor.cpp) with one entry per
+ * WLDAlarmType: the published event name, the alarm message, whether the alarm value is appended
+ * to the message, the holdoff between repeated alarms, and a severity.  All per-alarm state is
+ * indexed by alarm type: whether each alarm is armed and whether its condition is present are
+ * bits in a word, and the time of the last alarm and the current alarm value are arrays.  A new
+ * alarm type needs only a new WLDAlarmType value and a new table entry; no new methods.
+ *
+ * This class supports these alarm types, and an additional alarm test (to make sure that the
  * process of publication --> webhook --> script --> SMS is working):
- * 
- * - High Temperature Alarm:  called (with the actual temperature as the argument) whenever a too-high
+ *
+ * - High Temperature Alarm:  present (with the actual temperature as the value) whenever a too-high
  * temperature is detected by the WLD firmware.
  * 
- * - Low Temperature Alarm:  called (with the actual temperature as the argument) whenever a too-low
+ * - Low Temperature Alarm:  present (with the actual temperature as the value) whenever a too-low
  * temperature is detected by the WLD firmware.
  * 
- * - Leak Alarm: called whenever the WLD firmware detects a water leak.
- * 
- * In addition, the class supports three re-arm methods:
- * 
- * - re-arm High Temperature Alarm: called whenever the WLD firmware determines that the temperature is not too
- * high (relgardless of whether the temperature is normal or too low).
- * 
- * - re-arm Low Temperature Alarm: called whenever the WLD firmware determines that the temperature is not too
- * low (relgardless of whether the temperature is normal or too high).
- * 
- * - re-arm Water Leak Detection: called whenever the WLD firmware determines that no water leak is detected.
+ * - Leak Alarm: present whenever the WLD firmware detects a water leak.
+ *
+ * - Predicted Low (High) Temperature Alarm:  present (with the minutes until the limit is reached as
+ * the value) whenever the WLD firmware predicts from the temperature trend that the low (high)
+ * temperature limit will soon be reached, before the low (high) temperature alarm is present.
+ *
+ * - Sensor Fault Alarm: present (with the last error code as the value) whenever the temperature and
+ * humidity sensor has failed several readings in a row.
+ *
+ * The WLD firmware reports the condition of each alarm with setCondition() whenever it has a new
+ * measurement, and calls service() once afterwards.  service() makes one pass over the table: an
+ * alarm whose condition is present is published if it is armed or its holdoff has expired, and an
+ * alarm whose condition is not present is re-armed so that a new alarm condition will alert the
+ * user immediately.  sendAlarm() publishes an alarm immediately (subject to the same arming and
+ * holdoff), which is how the test alarm is sent.
+ *
+ * Alarms of CRITICAL severity are placed ahead of other waiting events in the event queue.
  * 
  * See: "WLD V2 Concept Document" for further details:   
  * https://docs.google.com/document/d/1WXK0372C2H_zPN31xgyE5MKP1GyY8HaXpQrTsiYnKkg/edit?usp=sharing
@@ -50,153 +63,148 @@
  * (c) 2022, Bob Glicksman, Jim Schrempp, Team Practical Projects
  * 
  * version 1.0: 10/25/22.  Initial release
+ * version 1.1: 10/17/26.  Time and cloud access through the WLDHal hardware abstraction layer
+ * version 1.2: 10/17/26.  Alarm events are added to a WLDEventQueue instead of being published directly,
+ *  so sending an alarm never blocks and an alarm that cannot be published yet is not lost
+ * version 2.0: 10/17/26.  Table driven: one set of methods and one pass over an alarm table serves every
+ *  alarm type, each with its own holdoff and severity.  Added the sensor fault alarm.
+ * version 2.1: 10/17/26.  Added the predicted low and high temperature alarms.
+ * version 2.2: 10/17/26.  Added conditions(), for the state snapshot.
+ * version 2.3: 10/17/26.  Checks at compile time that the event queue holds the longest event name.
+ * version 2.4: 10/17/26.  Added value(), the value of a present alarm.
  * 
  *******************************************************************************/
 #include <WLDAlarmProcessor.h>
 
+// Constants
+const unsigned long ONE_MINUTE = 60000; // one minute = 60000 milliseconds
+const unsigned long ONE_DAY = ONE_MINUTE * 60 * 24;  // 60 minutes per hour, 24 hours per day
+//const unsigned long ONE_DAY = ONE_MINUTE;    // FOR TESTING ONLY
+
+// Published event names
+constexpr char EVENT_LOW_TEMP[] = "WLDAlarmLowTemp";
+constexpr char EVENT_HIGH_TEMP[] = "WLDAlarmHighTemp";
+constexpr char EVENT_WATER_LEAK[] = "WLDAlarmWaterLeak";
+constexpr char EVENT_SENSOR_FAULT[] = "WLDAlarmSensorFault";
+constexpr char EVENT_LOW_TEMP_PREDICTED[] = "WLDAlarmLowTempPredicted";
+constexpr char EVENT_HIGH_TEMP_PREDICTED[] = "WLDAlarmHighTempPredicted";
+constexpr char EVENT_TEST[] = "WLDAlarmTest";
+static_assert(sizeof(EVENT_HIGH_TEMP_PREDICTED) <= EVENT_NAME_SIZE, "the event queue must hold the longest event name");
+
+// The alarm table, one entry per WLDAlarmType, in WLDAlarmType order
+static constexpr WLDAlarmDescriptor ALARM_TABLE[NUM_ALARM_TYPES] = {
+    // event name                message                                                value          holdoff  severity
+    { EVENT_LOW_TEMP,            "Low temperature detected. Temperature = ",            VALUE_FIXED,   ONE_DAY, SEVERITY_WARNING },
+    { EVENT_HIGH_TEMP,           "High temperature detected. Temperature = ",           VALUE_FIXED,   ONE_DAY, SEVERITY_WARNING },
+    { EVENT_WATER_LEAK,          "Water leak Detected",                                 VALUE_NONE,    ONE_DAY, SEVERITY_CRITICAL },
+    { EVENT_SENSOR_FAULT,        "Temperature sensor fault. Error code = ",             VALUE_INTEGER, ONE_DAY, SEVERITY_WARNING },
+    { EVENT_LOW_TEMP_PREDICTED,  "Low temperature predicted. Minutes to the limit = ",  VALUE_INTEGER, ONE_DAY, SEVERITY_WARNING },
+    { EVENT_HIGH_TEMP_PREDICTED, "High temperature predicted. Minutes to the limit = ", VALUE_INTEGER, ONE_DAY, SEVERITY_WARNING },
+    { EVENT_TEST,                "This is a test of the WLD alarm system",              VALUE_NONE,    0,       SEVERITY_INFO },
+};
+
 // Constructor
 WLDAlarmProcessor::WLDAlarmProcessor() {
     // follow convention and put all initializations in begin() method   
 }   // end of Constructor
 
 // Initialization
-void WLDAlarmProcessor::begin() {
+void WLDAlarmProcessor::begin(WLDHal *hal, WLDEventQueue *queue) {
     // initialize all of the internal variables.
 
-    _lowTempAlarmArm = true;    // arm the alarm upon initialization
-    _highTempAlarmArm = true;   // arm the alarm upon initialization
-    _leakAlarmArm = true;       // arm the alarm upon initialization
+    _hal = hal;     // all time access is through the HAL
+    _queue = queue; // alarm events are published from the queue
 
-    _lowTempLastAlarm = 0L;
-    _highTempLastAlarm = 0L;
-    _leakLastAlarm = 0L;
+    _armed = (1UL << NUM_ALARM_TYPES) - 1;  // arm all alarms upon initialization
+    _present = 0;
+    for(int type = 0; type < NUM_ALARM_TYPES; type++) {
+        _value[type] = 0;
+        _lastAlarm[type] = 0L;
+    }
 
 }   // end of begin()
 
 // Methods for handling alarms, arming and field testing
 
-// method to create and publish a low temperature alarm event to the Particle Cloud
-void WLDAlarmProcessor::sendLowTemperatureAlarm(float theAlarmTemperature) {
-    String alarmMsg = "Low temperature detected. Temperature = ";
-    unsigned long holdoffTime;
-
-    holdoffTime =  WLDAlarmProcessor::diff(millis(), _lowTempLastAlarm); 
-
-    // publish an alarm if it is armed, or else if it is more than ONE_DAY 
-    //  since the last time the alarm was published
-    if( (_lowTempAlarmArm == true) || ( holdoffTime  >= ONE_DAY) ) {
-        alarmMsg += String(theAlarmTemperature);
-        Particle.publish("WLDAlarmLowTemp", alarmMsg);
-        _lowTempAlarmArm = false;   // disarm the alarm
-        _lowTempLastAlarm = millis();  // record the time of the alarm
-    } 
-    return;
-}   // end of sendLowTemperateAlarm()
-
-// method to create and publish a high temperature alarm event to the Particle Cloud
-void WLDAlarmProcessor::sendHighTemperatureAlarm(float theAlarmTemperature) {
-    String alarmMsg = "High temperature detected. Temperature = ";
-    unsigned long holdoffTime;
-    
-    holdoffTime = WLDAlarmProcessor::diff( millis(), _highTempLastAlarm );
-
-    // publish an alarm if it is armed, or else if it is more than ONE_DAY 
-    //  since the last time the alarm was published   
-    if( (_highTempAlarmArm == true) || ( holdoffTime >= ONE_DAY) ) {  
-        alarmMsg += String(theAlarmTemperature);
-        Particle.publish("WLDAlarmHighTemp", alarmMsg);
-        _highTempAlarmArm = false;   // disarm the alarm
-        _highTempLastAlarm = millis();  // record the time of the alarm
-    } 
-    return;
-
-}   // end of sendHighTemperatureAlarm()
+// method to record whether the condition of an alarm is present, and its value; acted upon by service()
+void WLDAlarmProcessor::setCondition(WLDAlarmType type, bool present, fixed_t value) {
+    uint32_t bit = 1UL << type;
 
-// method to create and publish a water leak alarm event to the Particle Cloud
-void WLDAlarmProcessor::sendWaterLeakAlarm() {
-    String alarmMsg = "Water Leak Alarm Detected.";
-    unsigned long holdoffTime;
-
-    holdoffTime = WLDAlarmProcessor::diff( millis(), _leakLastAlarm );
-
-    // publish an alarm if it is armed, or else if it is more than ONE_DAY 
-    //  since the last time the alarm was published
-    if( (_leakAlarmArm == true) || ( holdoffTime >= ONE_DAY) ) {  
-        String _alarmMsg = "Water leak Detected";
-        Particle.publish("WLDAlarmWaterLeak", _alarmMsg);
-        _leakAlarmArm = false;   // disarm the alarm
-        _leakLastAlarm = millis();  // record the time of the alarm
-    } 
+    if(present == true) {
+        _present |= bit;
+        _value[type] = value;
+    } else {
+        _present &= ~bit;
+    }
     return;
-
-}   // end of sendWaterLeakAlarm()
-
-// method to create and publish a test alarm event to the Particle Cloud for field testing purposes
-void WLDAlarmProcessor::sendTestAlarm() {
-
-    String alarmMsg = "This is a test of the WLD alarm system";
-    Particle.publish("WLDAlarmTest", alarmMsg);
-
+}   // end of setCondition()
+
+// method to make one pass over the alarm table, publishing present alarms and re-arming the others
+void WLDAlarmProcessor::service() {
+    unsigned long now = _hal->millis();
+
+    for(int type = 0; type < NUM_ALARM_TYPES; type++) {
+        uint32_t bit = 1UL << type;
+
+        if((_present & bit) == 0) {
+            _armed |= bit;      // no alarm condition, so a new one will alarm immediately
+        } else if((_armed & bit) || (now - _lastAlarm[type]) >= ALARM_TABLE[type].holdoff) {
+            // publish an alarm if it is armed, or else if its holdoff has passed since the last
+            //  time the alarm was published.  Unsigned arithmetic is correct across millis() overflow.
+            publish(type, now);
+        }
+    }
     return;
-}   // end of sendTestAlarm()
+}   // end of service()
 
-// method to re-arm the low temperatre alarm so that a new alarm can be sent immediately
-void WLDAlarmProcessor::armLowTempAlarm() {
+// method to publish an alarm right away, if it is armed or its holdoff has passed
+void WLDAlarmProcessor::sendAlarm(WLDAlarmType type, fixed_t value) {
+    unsigned long now = _hal->millis();
 
-    _lowTempAlarmArm = true;
+    if(((_armed >> type) & 1) || (now - _lastAlarm[type]) >= ALARM_TABLE[type].holdoff) {
+        _value[type] = value;
+        publish(type, now);
+    }
     return;
+}   // end of sendAlarm()
 
-}   // end of armLowTempAlarm()
-
-// method to clear out the holdoff for the high temperatre alarm so that a new alarm can be sent immediately
-void WLDAlarmProcessor::armHighTempAlarm() {
-
-    _highTempAlarmArm = true;
+// method to re-arm an alarm so that a new alarm can be sent immediately
+void WLDAlarmProcessor::armAlarm(WLDAlarmType type) {
+    _armed |= 1UL << type;
     return;
+}   // end of armAlarm()
 
-}   // end of armHighTempAlarm() 
-
-// method to clear out the holdoff for the water leak alarm so that a new alarm can be sent immediately
-void WLDAlarmProcessor::armLeakAlarm() {
-
-   _leakAlarmArm = true;
-   return;
-
-}   // end of armLeakAlarm() 
-
-// Methods for debugging purposes
-
-unsigned long WLDAlarmProcessor::get_lowTempLastAlarm() {
-
-    return _lowTempLastAlarm;
-
-}   // end of get_lowTempLastAlarm()
-
-unsigned long WLDAlarmProcessor::get_highTempLastAlarm() {
+// Alarm table access
 
-    return _highTempLastAlarm;
-
-}   // end of get_highTempLastAlarm()
-
-
-unsigned long WLDAlarmProcessor::get_leakLastAlarm() {
-
-    return _leakLastAlarm;
-
-}   // end of get_leakLastAlarm()
+const WLDAlarmDescriptor *WLDAlarmProcessor::descriptor(WLDAlarmType type) {
+    return &ALARM_TABLE[type];
+}   // end of descriptor()
 
 // private methods
 
-// diff(): take the difference between two unsigned long variables, accounting for variable overflow
-//  Used to ensure that alarm holdoffs won't be fooled upon millis() overflow
-unsigned long WLDAlarmProcessor::diff(unsigned long current, unsigned long last)  {
-    const unsigned long MAX = 0xffffffff;  // an unsigned long is 4 bytes
-    unsigned long difference;
-
-    if (current < last) {       // overflow condition
-        difference = (MAX - last) + current;
-    } else {
-        difference = current - last;
+// build the alarm message from the table and add the alarm event to the queue
+void WLDAlarmProcessor::publish(int type, unsigned long now) {
+    const WLDAlarmDescriptor *alarm = &ALARM_TABLE[type];
+    char alarmMsg[EVENT_DATA_SIZE];
+    int length;
+
+    length = snprintf(alarmMsg, sizeof(alarmMsg), "%s", alarm->message);
+    if(length > 0 && length < (int)sizeof(alarmMsg)) {
+        if(alarm->valueFormat == VALUE_FIXED) {
+            char value[16];
+            const char *text = value;
+            formatFixed(value, sizeof(value), _value[type]);
+            while(*text == ' ') {
+                text++;     // formatFixed() right justifies; the message doesn't need the padding
+            }
+            snprintf(alarmMsg + length, sizeof(alarmMsg) - length, "%s", text);
+        } else if(alarm->valueFormat == VALUE_INTEGER) {
+            snprintf(alarmMsg + length, sizeof(alarmMsg) - length, "%d", fixedToInt(_value[type]));
+        }
     }
-    return difference;
-}  // end of diff()
\ No newline at end of file
+
+    _queue->enqueue(alarm->eventName, alarmMsg, alarm->severity == SEVERITY_CRITICAL);
+    _armed &= ~(1UL << type);   // disarm the alarm
+    _lastAlarm[type] = now;     // record the time of the alarm
+    return;
+}   // end of publish()
@@ -14,33 +14,46 @@
  * then calling methods on the instantiated object to either send a alarm (when it detects and
  * alarm condition) or else to arm for an alarm (when it detects a normal condition).  The instantiated
  * object manages alarms so that an SMS text is send at most once per day, for any persistant alarm
- * condition.  The WLD firmware can send alarms using the instantiated object's sendAlarm..() methods
+ * condition.  The WLD firmware can report alarms using the instantiated object's setCondition() method
  * each and every time it detects an alarm condition, regardless of how frequently this occurs.  The
  * instantiated object manages the sensding of SMS texts to the user so that the user only receives one alarm
  * per day for any persistent alarm.  Conversely, the WLD firmmware should continuously re-arm an alarm
  * whenever a non-alarm condition is detected so that any new alarm condition will alert the user
  * immediately.
  * 
- * This class supports three active alarm types, and an additional alarm test (to make sure that the
+ * Alarm types are described by a table (ALARM_TABLE in WLDAlarmProcessor.cpp) with one entry per
+ * WLDAlarmType: the published event name, the alarm message, whether the alarm value is appended
+ * to the message, the holdoff between repeated alarms, and a severity.  All per-alarm state is
+ * indexed by alarm type: whether each alarm is armed and whether its condition is present are
+ * bits in a word, and the time of the last alarm and the current alarm value are arrays.  A new
+ * alarm type needs only a new WLDAlarmType value and a new table entry; no new methods.
+ *
+ * This class supports these alarm types, and an additional alarm test (to make sure that the
  * process of publication --> webhook --> script --> SMS is working):
- * 
- * - High Temperature Alarm:  called (with the actual temperature as the argument) whenever a too-high
+ *
+ * - High Temperature Alarm:  present (with the actual temperature as the value) whenever a too-high
  * temperature is detected by the WLD firmware.
  * 
- * - Low Temperature Alarm:  called (with the actual temperature as the argument) whenever a too-low
+ * - Low Temperature Alarm:  present (with the actual temperature as the value) whenever a too-low
  * temperature is detected by the WLD firmware.
  * 
- * - Leak Alarm: called whenever the WLD firmware detects a water leak.
- * 
- * In addition, the class supports three re-arm methods:
- * 
- * - re-arm High Temperature Alarm: called whenever the WLD firmware determines that the temperature is not too
- * high (relgardless of whether the temperature is normal or too low).
- * 
- * - re-arm Low Temperature Alarm: called whenever the WLD firmware determines that the temperature is not too
- * low (relgardless of whether the temperature is normal or too high).
- * 
- * - re-arm Water Leak Detection: called whenever the WLD firmware determines that no water leak is detected.
+ * - Leak Alarm: present whenever the WLD firmware detects a water leak.
+ *
+ * - Predicted Low (High) Temperature Alarm:  present (with the minutes until the limit is reached as
+ * the value) whenever the WLD firmware predicts from the temperature trend that the low (high)
+ * temperature limit will soon be reached, before the low (high) temperature alarm is present.
+ *
+ * - Sensor Fault Alarm: present (with the last error code as the value) whenever the temperature and
+ * humidity sensor has failed several readings in a row.
+ *
+ * The WLD firmware reports the condition of each alarm with setCondition() whenever it has a new
+ * measurement, and calls service() once afterwards.  service() makes one pass over the table: an
+ * alarm whose condition is present is published if it is armed or its holdoff has expired, and an
+ * alarm whose condition is not present is re-armed so that a new alarm condition will alert the
+ * user immediately.  sendAlarm() publishes an alarm immediately (subject to the same arming and
+ * holdoff), which is how the test alarm is sent.
+ *
+ * Alarms of CRITICAL severity are placed ahead of other waiting events in the event queue.
  * 
  * See: "WLD V2 Concept Document" for further details:   
  * https://docs.google.com/document/d/1WXK0372C2H_zPN31xgyE5MKP1GyY8HaXpQrTsiYnKkg/edit?usp=sharing
@@ -50,53 +63,98 @@
  * (c) 2022, Bob Glicksman, Jim Schrempp, Team Practical Projects
  * 
  * version 1.0: 10/25/22.  Initial release
+ * version 1.1: 10/17/26.  Time and cloud access through the WLDHal hardware abstraction layer
+ * version 1.2: 10/17/26.  Alarm events are added to a WLDEventQueue instead of being published directly,
+ *  so sending an alarm never blocks and an alarm that cannot be published yet is not lost
+ * version 2.0: 10/17/26.  Table driven: one set of methods and one pass over an alarm table serves every
+ *  alarm type, each with its own holdoff and severity.  Added the sensor fault alarm.
+ * version 2.1: 10/17/26.  Added the predicted low and high temperature alarms.
+ * version 2.2: 10/17/26.  Added conditions(), for the state snapshot.
+ * version 2.3: 10/17/26.  Checks at compile time that the event queue holds the longest event name.
+ * version 2.4: 10/17/26.  Added value(), the value of a present alarm.
  * 
  *******************************************************************************/
 #ifndef wldap
 #define wldap
 
 #include "application.h"
+#include <WLDHal.h>
+#include <WLDEventQueue.h>
+#include <WLDFixedPoint.h>
+
+// Alarm types; the order is the order of ALARM_TABLE in WLDAlarmProcessor.cpp
+enum WLDAlarmType {
+    ALARM_LOW_TEMP = 0,
+    ALARM_HIGH_TEMP,
+    ALARM_WATER_LEAK,
+    ALARM_SENSOR_FAULT,
+    ALARM_LOW_TEMP_PREDICTED,
+    ALARM_HIGH_TEMP_PREDICTED,
+    ALARM_TEST,
+    NUM_ALARM_TYPES
+};
+
+// Alarm severities
+enum WLDAlarmSeverity {
+    SEVERITY_INFO = 0,
+    SEVERITY_WARNING,
+    SEVERITY_CRITICAL
+};
+
+// Alarm values
+enum WLDAlarmValueFormat {
+    VALUE_NONE = 0,         // the message has no value
+    VALUE_FIXED,            // the value is a fixed-point reading, shown with one decimal place
+    VALUE_INTEGER           // the value is an integer, such as an error code
+};
+
+// Description of one alarm type
+struct WLDAlarmDescriptor {
+    const char *eventName;          // name of the published event
+    const char *message;            // alarm message; the value, if any, is appended
+    WLDAlarmValueFormat valueFormat;
+    unsigned long holdoff;          // minimum time between repeats of a persistent alarm, in milliseconds
+    WLDAlarmSeverity severity;
+};
 
 class WLDAlarmProcessor  {
     private:
-        // Constants
-        const unsigned int ONE_MINUTE = 60000; // one minute = 60000 milliseconds
-        const unsigned int ONE_DAY = ONE_MINUTE * 60 * 24;  // 60 minutes per hour, 24 hours per day
-        //const unsigned int ONE_DAY = ONE_MINUTE;    // FOR TESTING ONLY
-        
         // Variables
-        bool _lowTempAlarmArm;      // indicate alarm arming
-        bool _highTempAlarmArm;     // indicate alarm arming
-        bool _leakAlarmArm;         // indicate alarm arming
+        WLDHal *_hal;               // hardware abstraction layer for time access
+        WLDEventQueue *_queue;      // queue that alarm events are published from
+
+        uint32_t _armed;                                // bit n set when alarm type n is armed
+        uint32_t _present;                              // bit n set when the condition of alarm type n is present
+        fixed_t _value[NUM_ALARM_TYPES];                // value of each present alarm
+        unsigned long _lastAlarm[NUM_ALARM_TYPES];      // time of the last alarm of each type
 
-        unsigned long _lowTempLastAlarm;    // time of the last alarm
-        unsigned long _highTempLastAlarm;   // time of the last alarm
-        unsigned long _leakLastAlarm;       // time of the last alarm
-        
         // Private methods (internal use only)
-        unsigned long diff(unsigned long current, unsigned long last);
-    
+        void publish(int type, unsigned long now);
+
     public:
         // Constructor
         WLDAlarmProcessor();
 
         // Initialization
-        void begin();
-        
-        // Methods for handling alarms, holdoffs and filed testing
-        void sendLowTemperatureAlarm(float theAlarmTemperature);
-        void sendHighTemperatureAlarm(float theAlarmTemperature);
-        void sendWaterLeakAlarm();
-        void sendTestAlarm();      // for field testing purposes
+        void begin(WLDHal *hal, WLDEventQueue *queue);
+
+        // Methods for handling alarms, holdoffs and field testing
+        void setCondition(WLDAlarmType type, bool present, fixed_t value = 0);
+        void service();             // publish or re-arm every alarm according to its condition
+        void sendAlarm(WLDAlarmType type, fixed_t value = 0);
+        void armAlarm(WLDAlarmType type);   // forced arming of the alarm
+        void sendTestAlarm() { sendAlarm(ALARM_TEST); }     // for field testing purposes
+
+        // Alarm table access
+        static const WLDAlarmDescriptor *descriptor(WLDAlarmType type);
 
-        void armLowTempAlarm();     // forced arming of the alarm
-        void armHighTempAlarm();    // forced arming of the alarm
-        void armLeakAlarm();        // forced arming of the alarm
+        // Alarm conditions:  bit n is set when the condition of alarm type n is present
+        uint32_t conditions() { return _present; }
 
         // Methods for debugging purposes
-        unsigned long get_lowTempLastAlarm();
-        unsigned long get_highTempLastAlarm();
-        unsigned long get_leakLastAlarm();
+        bool armed(WLDAlarmType type) { return (_armed >> type) & 1; }
+        unsigned long lastAlarm(WLDAlarmType type) { return _lastAlarm[type]; }
+        fixed_t value(WLDAlarmType type) { return _value[type]; }
 };
 
 #endif
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * WLDConfigJournal:  wear-leveled, CRC protected journal of the WLD settings in EEPROM
+ *
+ * See WLDConfigJournal.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include <WLDConfigJournal.h>
+
+// Constructor
+WLDConfigJournal::WLDConfigJournal() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDConfigJournal::begin(WLDHal *hal, int start, int size) {
+    _hal = hal;
+    _start = start;
+    _slots = size / SLOT_SIZE;
+    _newest = -1;
+    _sequence = 0;
+    _writes = 0;
+    _savedLength = 0;
+    _pendingLength = 0;
+    _dirty = false;
+    _changed = 0;
+}   // end of begin()
+
+// Settings
+
+/* load():  find the newest good record and copy its settings into "data"
+    parameters:
+        data, length:  the settings struct.  Only as many bytes as the record holds are copied, so
+            settings that are newer than the record keep the values they had.
+    return:
+        true if a good record was found
+*/
+bool WLDConfigJournal::load(void *data, size_t length) {
+    Header header;
+    uint8_t settings[MAX_LENGTH];
+    uint32_t tried = 0;     // records at or above this sequence number have been tried
+
+    _newest = -1;
+    for(int attempt = 0; attempt < _slots; attempt++) {
+        int best = -1;
+        uint32_t bestSequence = 0;
+
+        // the slot with the highest sequence number not yet tried
+        for(int slot = 0; slot < _slots; slot++) {
+            _hal->eepromRead(address(slot), &header, sizeof(header));
+            if(header.magic != MAGIC || header.format != FORMAT || header.length > MAX_LENGTH) {
+                continue;
+            }
+            if((attempt == 0 || header.sequence < tried) && (best < 0 || header.sequence > bestSequence)) {
+                best = slot;
+                bestSequence = header.sequence;
+            }
+        }
+        if(best < 0) {
+            return false;   // no (more) records
+        }
+        tried = bestSequence;
+
+        if(readRecord(best, &header, settings)) {
+            _newest = best;
+            _sequence = header.sequence;
+            _savedLength = header.length;
+            memcpy(_saved, settings, header.length);
+            memcpy(data, settings, (length < header.length) ? length : header.length);
+            return true;
+        }
+    }
+    return false;
+}   // end of load()
+
+// take a copy of the settings, to be written by service() SAVE_DELAY after the last change
+void WLDConfigJournal::save(const void *data, size_t length, unsigned long now) {
+    _pendingLength = (length > MAX_LENGTH) ? MAX_LENGTH : length;
+    memcpy(_pending, data, _pendingLength);
+    _dirty = true;
+    _changed = now;
+}   // end of save()
+
+bool WLDConfigJournal::service(unsigned long now) {
+    if(_dirty == false || timeSince(now, _changed) < SAVE_DELAY) {
+        return false;
+    }
+    uint32_t writes = _writes;
+    write();
+    return _writes != writes;
+}   // end of service()
+
+void WLDConfigJournal::flush() {
+    if(_dirty == true) {
+        write();
+    }
+}   // end of flush()
+
+// private methods
+
+// read the record in a slot; false if its magic number, format, length or CRC is wrong
+bool WLDConfigJournal::readRecord(int slot, Header *header, uint8_t *data) {
+    uint16_t crc;
+
+    _hal->eepromRead(address(slot), header, sizeof(Header));
+    if(header->magic != MAGIC || header->format != FORMAT || header->length > MAX_LENGTH) {
+        return false;
+    }
+    _hal->eepromRead(address(slot) + sizeof(Header), data, header->length);
+    _hal->eepromRead(address(slot) + sizeof(Header) + header->length, &crc, sizeof(crc));
+    return crc == crc16(data, header->length, crc16(header, sizeof(Header)));
+}   // end of readRecord()
+
+// write the pending settings as a new record in the slot after the newest one, unless they are
+//  the same as the newest record.  The magic number is cleared first and written last, so that
+//  the slot holds a good record only once all of it has been written.
+void WLDConfigJournal::write() {
+    _dirty = false;
+    if(_newest >= 0 && _pendingLength == _savedLength && memcmp(_pending, _saved, _pendingLength) == 0) {
+        return;     // unchanged
+    }
+
+    int slot = (_newest + 1) % _slots;
+    Header header;
+    uint16_t clear = 0;
+    header.magic = MAGIC;
+    header.format = FORMAT;
+    header.length = _pendingLength;
+    header.sequence = (_newest >= 0) ? _sequence + 1 : 0;
+    uint16_t crc = crc16(_pending, _pendingLength, crc16(&header, sizeof(header)));
+
+    _hal->eepromWrite(address(slot), &clear, sizeof(clear));
+    _hal->eepromWrite(address(slot) + sizeof(header.magic), (const uint8_t *)&header + sizeof(header.magic),
+                      sizeof(header) - sizeof(header.magic));
+    _hal->eepromWrite(address(slot) + sizeof(header), _pending, _pendingLength);
+    _hal->eepromWrite(address(slot) + sizeof(header) + _pendingLength, &crc, sizeof(crc));
+    _hal->eepromWrite(address(slot), &header.magic, sizeof(header.magic));
+
+    _newest = slot;
+    _sequence = header.sequence;
+    _savedLength = _pendingLength;
+    memcpy(_saved, _pending, _pendingLength);
+    _writes++;
+}   // end of write()
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * WLDConfigJournal:  wear-leveled, CRC protected journal of the WLD settings in EEPROM
+ *
+ * The WLD firmware keeps its settings (the temperature alarm limits, and later per-probe
+ * thresholds, holdoffs, ...) in one struct.  Instead of writing the struct to one fixed EEPROM
+ * address every time it is set, each save appends a new record to a journal that is spread over
+ * an area of EEPROM, and loading finds the newest good record:
+ *
+ * - The journal area is divided into fixed size slots, one record per slot.  A record is a
+ * header (a magic number, the journal format, the length of the settings and a sequence
+ * number that is one more than that of the record before it), the settings, and a CRC-16 (see
+ * WLDCrc.h) of the header and settings.  Each save goes into the slot after the newest record,
+ * wrapping around, so writes are spread evenly over all of the slots and the newest record is
+ * never overwritten.
+ *
+ * - A record is written in an order that makes a torn write (a reset or power loss part way
+ * through) harmless:  the magic number of the slot is cleared first, then the rest of the header,
+ * the settings and the CRC are written, and the magic number is written last.  A slot whose magic
+ * number or CRC is wrong is ignored, so a torn record is never loaded and the record before it
+ * is loaded instead.
+ *
+ * - load() reads the header of every slot and checks the CRC of the slot with the highest
+ * sequence number, going on to the next highest only if that CRC is wrong; at boot this is one
+ * pass over the headers plus one CRC, a few milliseconds.
+ *
+ * - Settings that are only ever appended to the end of the settings struct stay compatible:
+ * a record stores the length of the settings it was written with, and load() copies only that
+ * many bytes, so settings added since keep the defaults that the caller set before load().
+ *
+ * - save() only takes a copy of the settings.  service() writes it SAVE_DELAY after the last
+ * change, so a burst of changes from the cloud is coalesced into one record, and nothing is
+ * written when the settings are the same as the newest record.  flush() writes at once.
+ *
+ * On the Photon the EEPROM is itself emulated in flash, by Device OS, which spreads its own
+ * writes over a flash page; the journal adds the integrity check, the coalescing and the
+ * format for growing the settings, and it spreads writes on a true EEPROM as well.
+ *
+ * test/ConfigJournalTest.cpp tears a save after each possible number of bytes, at each slot of a
+ * journal that has wrapped, and checks that load() then returns either the settings from before
+ * the save or those from after it.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Refer to test/ConfigJournalTest.cpp for the fault injection
+ *
+ *******************************************************************************/
+#ifndef wldcj
+#define wldcj
+
+#include "application.h"
+#include <WLDHal.h>
+#include <WLDCrc.h>
+#include <WLDTime.h>
+
+class WLDConfigJournal  {
+    public:
+        // Constants
+        static const int SLOT_SIZE = 64;            // bytes of EEPROM per record
+        static const uint16_t MAGIC = 0x4a57;       // marks a written record
+        static const uint8_t FORMAT = 1;            // record format
+        static const unsigned long SAVE_DELAY = 10000;  // milliseconds from the last change to the write
+
+    private:
+        // Record header, followed in the slot by the settings and the CRC
+        struct Header {
+            uint16_t magic;
+            uint8_t format;
+            uint8_t length;         // bytes of settings
+            uint32_t sequence;
+        };
+
+    public:
+        static const int MAX_LENGTH = SLOT_SIZE - sizeof(Header) - sizeof(uint16_t);   // bytes of settings
+
+    private:
+        // Variables
+        WLDHal *_hal;
+        int _start;                 // EEPROM address of the first slot
+        int _slots;                 // number of slots
+        int _newest;                // slot of the newest good record, or -1
+        uint32_t _sequence;         // sequence number of the newest good record
+        uint32_t _writes;           // records written since begin()
+
+        uint8_t _saved[MAX_LENGTH];     // settings of the newest good record
+        uint8_t _savedLength;
+        uint8_t _pending[MAX_LENGTH];   // settings waiting to be written
+        uint8_t _pendingLength;
+        bool _dirty;                // save() has been called since the last write
+        unsigned long _changed;     // time of the last save()
+
+        // Private methods (internal use only)
+        int address(int slot) { return _start + slot * SLOT_SIZE; }
+        bool readRecord(int slot, Header *header, uint8_t *data);
+        void write();
+
+    public:
+        // Constructor
+        WLDConfigJournal();
+
+        // Initialization:  the journal uses "size" bytes of EEPROM from "start"
+        void begin(WLDHal *hal, int start, int size);
+
+        // Settings
+        bool load(void *data, size_t length);       // false if there is no good record
+        void save(const void *data, size_t length, unsigned long now);
+        bool service(unsigned long now);            // write the pending settings if due; true if written
+        void flush();                               // write the pending settings now
+
+        // Status
+        int slots() { return _slots; }
+        int newest() { return _newest; }
+        uint32_t sequence() { return _sequence; }
+        uint32_t writes() { return _writes; }
+        bool pending() { return _dirty; }
+};
+
+#endif
@@ -0,0 +1,33 @@
+/*******************************************************************************
+ * WLDCrc:  CRC used to validate WLD data kept in retained memory and EEPROM
+ *
+ * crc16() computes the CRC-16/CCITT-FALSE checksum (polynomial 0x1021, initial value 0xFFFF)
+ * of a block of bytes, bit by bit, so that no lookup table is needed.  Passing the result of
+ * one call as "crc" to the next continues the checksum over more than one block.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#ifndef wldcrc
+#define wldcrc
+
+#include "application.h"
+
+const uint16_t CRC16_INITIAL = 0xffff;
+
+inline uint16_t crc16(const void *data, size_t length, uint16_t crc = CRC16_INITIAL) {
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    for(size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)bytes[i] << 8;
+        for(int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+#endif
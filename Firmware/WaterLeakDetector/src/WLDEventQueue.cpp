@@ -0,0 +1,155 @@
+/*******************************************************************************
+ * WLDEventQueue:  bounded queue of outbound cloud events, drained at a rate the cloud accepts
+ *
+ * See WLDEventQueue.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Added urgent events
+ * version 1.2: 10/17/26.  Added claimToken()
+ * version 1.3: 10/17/26.  Event names of up to 27 characters (the predicted alarms); store layout version 2
+ *
+ *******************************************************************************/
+#include <WLDEventQueue.h>
+#include <WLDCrc.h>
+
+// Constructor
+WLDEventQueue::WLDEventQueue() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDEventQueue::begin(WLDHal *hal, WLDPublisher *publisher, WLDEventQueueStore *store) {
+    _hal = hal;
+    _publisher = publisher;
+    _store = store;
+
+    // keep events left over from before a reset only if the store is intact
+    if(_store->marker != EVENT_STORE_MARKER || _store->version != EVENT_STORE_VERSION ||
+       _store->head >= EVENT_QUEUE_LENGTH || _store->count > EVENT_QUEUE_LENGTH ||
+       _store->crc != storeCrc()) {
+        memset(_store, 0, sizeof(WLDEventQueueStore));
+        _store->marker = EVENT_STORE_MARKER;
+        _store->version = EVENT_STORE_VERSION;
+        _store->crc = storeCrc();
+    }
+
+    _tokens = MAX_TOKENS * 1000;    // start with a full bucket
+    _lastRefill = _hal->millis();
+    _lastFailure = 0;
+    _failed = false;
+
+    _published = 0;
+    _coalesced = 0;
+    _dropped = 0;
+    _failures = 0;
+}   // end of begin()
+
+// add an event to the queue, or update the data of a waiting event with the same name
+bool WLDEventQueue::enqueue(const char *eventName, const char *eventData, bool urgent) {
+    bool kept = true;
+    WLDQueuedEvent *event = NULL;
+
+    // coalesce with a waiting event of the same name
+    for(int i = 0; i < _store->count; i++) {
+        WLDQueuedEvent *waiting = &_store->events[(_store->head + i) % EVENT_QUEUE_LENGTH];
+        if(strncmp(waiting->name, eventName, EVENT_NAME_SIZE) == 0) {
+            event = waiting;
+            _coalesced++;
+            break;
+        }
+    }
+
+    if(event == NULL) {
+        if(_store->count == EVENT_QUEUE_LENGTH) {
+            if(urgent == false) {   // full: drop the oldest event
+                _store->head = (_store->head + 1) % EVENT_QUEUE_LENGTH;
+            }                       // else drop the newest event
+            _store->count--;
+            _dropped++;
+            kept = false;
+        }
+        if(urgent == true) {        // add at the head of the queue
+            _store->head = (_store->head + EVENT_QUEUE_LENGTH - 1) % EVENT_QUEUE_LENGTH;
+            event = &_store->events[_store->head];
+        } else {                    // add at the tail of the queue
+            event = &_store->events[(_store->head + _store->count) % EVENT_QUEUE_LENGTH];
+        }
+        _store->count++;
+        strncpy(event->name, eventName, EVENT_NAME_SIZE - 1);
+        event->name[EVENT_NAME_SIZE - 1] = '\0';
+    }
+
+    strncpy(event->data, eventData, EVENT_DATA_SIZE - 1);
+    event->data[EVENT_DATA_SIZE - 1] = '\0';
+    _store->crc = storeCrc();
+    return kept;
+}   // end of enqueue()
+
+// publish the oldest waiting event if the cloud is connected and the rate limit allows it
+void WLDEventQueue::process() {
+    unsigned long now = _hal->millis();
+
+    refillTokens(now);
+
+    if(_store->count == 0 || _tokens < 1000) {
+        return;
+    }
+    if(_failed == true && (now - _lastFailure) < RETRY_INTERVAL) {
+        return;     // back off after a failed publish
+    }
+    if(_publisher->cloudConnected() == false) {
+        return;
+    }
+
+    WLDQueuedEvent *event = &_store->events[_store->head];
+    _tokens -= 1000;    // the cloud counts failed attempts against the rate limit too
+    if(_publisher->publish(event->name, event->data) == true) {
+        _store->head = (_store->head + 1) % EVENT_QUEUE_LENGTH;
+        _store->count--;
+        _store->crc = storeCrc();
+        _published++;
+        _failed = false;
+    } else {
+        _failures++;
+        _failed = true;
+        _lastFailure = now;
+    }
+}   // end of process()
+
+// spend a token for a publish that is made outside the queue, if no event is waiting for it
+bool WLDEventQueue::claimToken() {
+    refillTokens(_hal->millis());
+
+    if(_store->count != 0 || _tokens < 1000) {
+        return false;
+    }
+    _tokens -= 1000;
+    return true;
+}   // end of claimToken()
+
+// private methods
+
+// CRC of the queue contents; the marker, version and CRC fields themselves are not included
+uint16_t WLDEventQueue::storeCrc() {
+    uint16_t crc = crc16(&_store->head, sizeof(_store->head));
+    crc = crc16(&_store->count, sizeof(_store->count), crc);
+    return crc16(_store->events, sizeof(_store->events), crc);
+}   // end of storeCrc()
+
+// add the tokens earned since the last refill, up to the burst limit
+void WLDEventQueue::refillTokens(unsigned long now) {
+    unsigned long elapsed = now - _lastRefill;     // unsigned arithmetic is correct across millis() overflow
+
+    _lastRefill = now;
+    if(elapsed >= MAX_TOKENS * PUBLISH_INTERVAL) {
+        _tokens = MAX_TOKENS * 1000;
+        return;
+    }
+    _tokens += elapsed * 1000 / PUBLISH_INTERVAL;
+    if(_tokens > MAX_TOKENS * 1000) {
+        _tokens = MAX_TOKENS * 1000;
+    }
+}   // end of refillTokens()
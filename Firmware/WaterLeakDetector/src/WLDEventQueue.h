@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * WLDEventQueue:  bounded queue of outbound cloud events, drained at a rate the cloud accepts
+ *
+ * The WLDAlarmProcessor does not publish alarm events itself.  It adds them to a WLDEventQueue
+ * with enqueue(), which only copies the event into the queue and therefore never blocks.  The
+ * WLD firmware calls process() once per pass of loop(), after the time critical work is done.
+ * process() publishes at most one event per call, and only when:
+ *
+ * - the publisher reports that the cloud is connected, and
+ * - a token is available.  Tokens are added at one per PUBLISH_INTERVAL (1 second, the Particle
+ * cloud rate limit) up to a burst of MAX_TOKENS, and one is spent for each publish attempt.
+ *
+ * An event stays at the head of the queue until it is delivered; a failed publish is retried
+ * after RETRY_INTERVAL.  If an event with the same name is already waiting, enqueue() replaces its
+ * data with the newer data instead of adding a second copy (coalescing), so a persistent alarm
+ * never fills the queue.  When the queue is full, the oldest event is dropped.  An urgent event
+ * is placed at the head of the queue, ahead of the events already waiting; if the queue is full,
+ * the newest waiting event is dropped to make room for it.
+ *
+ * The queued events are kept in a WLDEventQueueStore supplied by the caller.  The WLD firmware
+ * places the store in retained memory, so alarms that have not yet been sent survive a reset and
+ * are sent after the device reconnects.  begin() keeps the store contents only if its marker,
+ * layout version and CRC are intact.
+ *
+ * A publisher outside the queue (the WLD telemetry) shares the rate limit through claimToken(), which
+ * spends a token only when no event is waiting, so that queued alarms always go first.
+ *
+ * Events are delivered through a WLDPublisher (see WLDPublisher.h), so the queue can be driven
+ * against a mock publisher.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Added urgent events
+ * version 1.2: 10/17/26.  Added claimToken()
+ * version 1.3: 10/17/26.  Event names of up to 27 characters (the predicted alarms); store layout version 2
+ *
+ *******************************************************************************/
+#ifndef wldeq
+#define wldeq
+
+#include "application.h"
+#include <WLDHal.h>
+#include <WLDPublisher.h>
+
+// Sizes of the queue
+const int EVENT_QUEUE_LENGTH = 8;           // maximum number of waiting events
+const int EVENT_NAME_SIZE = 28;             // event name, including the terminating null
+const int EVENT_DATA_SIZE = 72;             // event data, including the terminating null
+
+// One waiting event
+struct WLDQueuedEvent {
+    char name[EVENT_NAME_SIZE];
+    char data[EVENT_DATA_SIZE];
+};
+
+// Storage for the waiting events; may be placed in retained memory
+struct WLDEventQueueStore {
+    uint32_t marker;                        // EVENT_STORE_MARKER when the store has been initialized
+    uint16_t version;                       // layout version of the store
+    uint16_t crc;                           // CRC of head, count and events
+    uint8_t head;                           // index of the oldest event
+    uint8_t count;                          // number of waiting events
+    WLDQueuedEvent events[EVENT_QUEUE_LENGTH];
+};
+
+class WLDEventQueue  {
+    private:
+        // Constants
+        static const uint32_t EVENT_STORE_MARKER = 0x574c4451;  // "WLDQ"
+        static const uint16_t EVENT_STORE_VERSION = 2;
+        static const unsigned long PUBLISH_INTERVAL = 1000;     // one token per second
+        static const unsigned long MAX_TOKENS = 4;              // burst allowed by the cloud
+        static const unsigned long RETRY_INTERVAL = 5000;       // wait before retrying a failed publish
+
+        // Variables
+        WLDHal *_hal;
+        WLDPublisher *_publisher;
+        WLDEventQueueStore *_store;
+        unsigned long _tokens;              // available tokens, in milli-tokens
+        unsigned long _lastRefill;          // time tokens were last added
+        unsigned long _lastFailure;         // time of the last failed publish
+        bool _failed;                       // the last publish failed
+
+        // Counters
+        uint32_t _published;
+        uint32_t _coalesced;
+        uint32_t _dropped;
+        uint32_t _failures;
+
+        // Private methods (internal use only)
+        uint16_t storeCrc();
+        void refillTokens(unsigned long now);
+
+    public:
+        // Constructor
+        WLDEventQueue();
+
+        // Initialization
+        void begin(WLDHal *hal, WLDPublisher *publisher, WLDEventQueueStore *store);
+
+        // Add an event to the queue; returns false if an older event had to be dropped
+        bool enqueue(const char *eventName, const char *eventData, bool urgent = false);
+
+        // Publish the event at the head of the queue if the cloud and the rate limit allow
+        void process();
+
+        // Spend a token for a publish made outside the queue; false while events are waiting or no token is available
+        bool claimToken();
+
+        // Status
+        int pending() { return _store->count; }
+        uint32_t published() { return _published; }
+        uint32_t coalesced() { return _coalesced; }
+        uint32_t dropped() { return _dropped; }
+        uint32_t failures() { return _failures; }
+};
+
+#endif
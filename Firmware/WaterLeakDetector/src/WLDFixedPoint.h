@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * WLDFixedPoint:  integer and fixed-point helpers for the WLD sensor pipeline
+ *
+ * The Photon's Cortex-M3 has no floating point unit, so every float operation is a library
+ * call.  The WLD firmware therefore keeps sensor values as integers:
+ *
+ * - Water sensor readings stay in raw ADC counts.  Voltage thresholds are converted to ADC
+ * counts once, at compile time, with voltsToAdcCounts().
+ *
+ * - Temperatures (degrees F) and humidities (%RH) are kept as signed fixed-point values with
+ * FIXED_FRACTION_BITS fractional bits (1/256 of a degree or of a percent).  Whole-unit limits
+ * are converted with intToFixed(), which is also usable at compile time.  A float reading from
+ * the DHT library is converted once per reading with floatToFixed().
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Added tenthsToFixed(), for settings given in tenths
+ *
+ *******************************************************************************/
+#ifndef wldfp
+#define wldfp
+
+#include "application.h"
+
+// ADC calibration
+const int ADC_FULL_SCALE_COUNTS = 4095;     // 12 bit ADC
+const int ADC_REFERENCE_MV = 3300;          // 3.3 volt reference
+
+// Fixed-point format for temperature and humidity
+typedef int32_t fixed_t;
+const int FIXED_FRACTION_BITS = 8;
+const fixed_t FIXED_ONE = 1 << FIXED_FRACTION_BITS;
+
+// Largest ADC reading that is at or below "volts".  A reading is above a voltage threshold
+//  exactly when it is greater than voltsToAdcCounts(threshold).
+constexpr uint16_t voltsToAdcCounts(double volts) {
+    return (uint16_t)(volts * ADC_FULL_SCALE_COUNTS * 1000 / ADC_REFERENCE_MV);
+}
+
+// ADC reading converted to millivolts
+inline uint16_t adcCountsToMillivolts(uint16_t counts) {
+    return (uint16_t)(((uint32_t)counts * ADC_REFERENCE_MV) / ADC_FULL_SCALE_COUNTS);
+}
+
+// whole units to fixed point
+constexpr fixed_t intToFixed(int value) {
+    return (fixed_t)value * FIXED_ONE;
+}
+
+// tenths of a unit to fixed point, rounded to the nearest fixed-point step
+constexpr fixed_t tenthsToFixed(int32_t tenths) {
+    return (tenths * FIXED_ONE + (tenths < 0 ? -5 : 5)) / 10;
+}
+
+// float to fixed point, rounded to the nearest fixed-point step
+inline fixed_t floatToFixed(float value) {
+    return (fixed_t)lroundf(value * FIXED_ONE);
+}
+
+// fixed point to the nearest whole unit (halves round up)
+inline int fixedToInt(fixed_t value) {
+    return (int)((value + FIXED_ONE / 2) >> FIXED_FRACTION_BITS);
+}
+
+// fixed point to the nearest tenth of a unit (halves round up)
+inline int32_t fixedToTenths(fixed_t value) {
+    return (value * 10 + FIXED_ONE / 2) >> FIXED_FRACTION_BITS;
+}
+
+// write a fixed-point value to buffer with one decimal place, right justified in 4 characters
+//  (the same text as printf("%4.1f")); returns the length of the text
+inline int formatFixed(char *buffer, size_t size, fixed_t value) {
+    int32_t tenths = fixedToTenths(value);
+    int32_t magnitude = (tenths < 0) ? -tenths : tenths;
+    char text[16];
+
+    snprintf(text, sizeof(text), "%s%ld.%ld", (tenths < 0) ? "-" : "", (long)(magnitude / 10), (long)(magnitude % 10));
+    return snprintf(buffer, size, "%4s", text);
+}
+
+// fixed point to float, for the rare cases (alarm messages) that need it
+inline float fixedToFloat(fixed_t value) {
+    return (float)value / FIXED_ONE;
+}
+
+#endif
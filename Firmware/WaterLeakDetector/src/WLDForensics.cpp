@@ -0,0 +1,162 @@
+/*******************************************************************************
+ * WLDForensics:  record of stalls and resets that survives a reset
+ *
+ * See WLDForensics.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include <WLDForensics.h>
+#include <WLDLoopProfiler.h>
+
+static_assert(NUM_LOOP_PHASES <= FORENSICS_PHASES, "FORENSICS_PHASES must count every loop phase");
+
+// short names of the threads, in WLDForensicsThread order, for the cloud variable
+static const char * const THREAD_NAMES[NUM_FORENSICS_THREADS] = { "loop", "sensing" };
+
+// Constructor
+WLDForensics::WLDForensics() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization:  keep the record in the store if it is intact, and count this boot
+void WLDForensics::begin(WLDHal *hal, WLDForensicsStore *store) {
+    uint32_t resetData;
+
+    _hal = hal;
+    _store = store;
+    if(_store->marker != FORENSICS_STORE_MARKER || _store->version != FORENSICS_STORE_VERSION ||
+       _store->crc != storeCrc(_store)) {
+        memset(_store, 0, sizeof(WLDForensicsStore));
+        _store->marker = FORENSICS_STORE_MARKER;
+        _store->version = FORENSICS_STORE_VERSION;
+        _store->newest = FORENSICS_RECORDS - 1;
+    }
+
+    _store->boots++;
+    _store->resetReason = _hal->resetReason(&resetData);
+    _store->resetData = resetData;
+    _watchdogReset = (_store->watchdogPending != 0);
+    if(_watchdogReset == true) {
+        _store->watchdogResets++;
+        _store->watchdogPending = 0;
+    }
+    _store->crc = storeCrc(_store);
+}   // end of begin()
+
+// Recording
+
+// record a phase of a thread that took longer than its budget
+void WLDForensics::recordStall(uint8_t thread, int phase, uint32_t microseconds) {
+    addStall(thread, phase, microseconds / 1000, false);
+}   // end of recordStall()
+
+// record a phase of a thread that has not ended after "milliseconds", and reset the device
+void WLDForensics::resetForStall(uint8_t thread, int phase, uint32_t milliseconds) {
+    addStall(thread, phase, milliseconds, true);
+    _hal->reset();
+}   // end of resetForStall()
+
+// forget the stalls and the counts; the boot count is kept, so later records can still be told apart
+void WLDForensics::clear() {
+    SINGLE_THREADED_BLOCK() {
+        _store->stalls = 0;
+        _store->watchdogResets = 0;
+        _store->newest = FORENSICS_RECORDS - 1;
+        memset(_store->counts, 0, sizeof(_store->counts));
+        memset(_store->records, 0, sizeof(_store->records));
+        _store->crc = storeCrc(_store);
+    }
+}   // end of clear()
+
+// Reporting
+
+// write the record into buffer (see WLDForensics.h); returns the length written
+size_t WLDForensics::format(char *buffer, size_t size) {
+    WLDForensicsStore store;
+    char reason[24];     // "<reason>/<data>", at most "65535/4294967295"
+    int length;
+
+    SINGLE_THREADED_BLOCK() {
+        memcpy(&store, _store, sizeof(store));  // a consistent copy, as the sensing thread may record
+    }
+
+    if(_watchdogReset == true) {
+        snprintf(reason, sizeof(reason), "watchdog");
+    } else {
+        snprintf(reason, sizeof(reason), "%u/%lu", store.resetReason, (unsigned long)store.resetData);
+    }
+    length = snprintf(buffer, size, "boots:%u,reset:%s,watchdogs:%u,stalls:%lu,counts:", store.boots, reason,
+                      store.watchdogResets, (unsigned long)store.stalls);
+
+    // the count of every thread and phase that has stalled
+    bool first = true;
+    for(int thread = 0; thread < NUM_FORENSICS_THREADS; thread++) {
+        for(int phase = 0; phase < FORENSICS_PHASES && length < (int)size; phase++) {
+            if(store.counts[thread][phase] == 0) {
+                continue;
+            }
+            length += snprintf(buffer + length, size - length, "%s%s:%s=%u", first ? "" : " ",
+                               THREAD_NAMES[thread], WLDLoopProfiler::phaseName(phase),
+                               store.counts[thread][phase]);
+            first = false;
+        }
+    }
+
+    // the stalls, newest first
+    for(int i = 0; i < FORENSICS_RECORDS && (uint32_t)i < store.stalls && length < (int)size; i++) {
+        const WLDStallRecord *record = &store.records[(store.newest + FORENSICS_RECORDS - i) % FORENSICS_RECORDS];
+        length += snprintf(buffer + length, size - length, ";%u/%lu/%lu/%s:%s/%s%lu", record->boot,
+                           (unsigned long)record->time, (unsigned long)(record->uptime / 1000),
+                           THREAD_NAMES[record->thread], WLDLoopProfiler::phaseName(record->phase),
+                           record->watchdog ? ">" : "", (unsigned long)record->duration);
+    }
+
+    if(length >= (int)size) {
+        length = size - 1;  // out of room; the oldest stalls are cut off
+    }
+    return length;
+}   // end of format()
+
+// private methods
+
+// add a stall to the ring and count it; a watchdog stall marks the coming reset as a watchdog reset
+void WLDForensics::addStall(uint8_t thread, int phase, uint32_t milliseconds, bool watchdog) {
+    WLDStallRecord record;
+
+    if(thread >= NUM_FORENSICS_THREADS || phase < 0 || phase >= FORENSICS_PHASES) {
+        thread = THREAD_LOOP;
+        phase = PHASE_LOOP;     // not expected; keep the stall, without the phase
+    }
+    memset(&record, 0, sizeof(record));     // so that the padding is the same every time
+    record.time = _hal->unixTime();
+    record.uptime = _hal->millis();
+    record.duration = milliseconds;
+    record.boot = _store->boots;
+    record.thread = thread;
+    record.phase = phase;
+    record.watchdog = watchdog ? 1 : 0;
+
+    SINGLE_THREADED_BLOCK() {
+        _store->newest = (_store->newest + 1) % FORENSICS_RECORDS;
+        memcpy(&_store->records[_store->newest], &record, sizeof(record));
+        _store->stalls++;
+        if(_store->counts[thread][phase] < 0xffff) {
+            _store->counts[thread][phase]++;
+        }
+        if(watchdog == true) {
+            _store->watchdogPending = 1;
+        }
+        _store->crc = storeCrc(_store);
+    }
+}   // end of addStall()
+
+// CRC of the store contents; the marker, version and CRC fields themselves are not included
+uint16_t WLDForensics::storeCrc(const WLDForensicsStore *store) {
+    const uint8_t *contents = (const uint8_t *)&store->crc + sizeof(store->crc);
+
+    return crc16(contents, sizeof(WLDForensicsStore) - (contents - (const uint8_t *)store));
+}   // end of storeCrc()
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * WLDForensics:  record of stalls and resets that survives a reset
+ *
+ * When a device in the field misses a leak or resets, the cause is usually something that held up
+ * loop() or the sensing thread:  a DHT reading, a publish, an EEPROM write.  A WLDForensics keeps
+ * a record of such stalls, and of the resets, in a WLDForensicsStore that the firmware places in
+ * retained memory, so that the record can be read from the cloud after the fact:
+ *
+ * - A WLDLoopProfiler with a stall monitor (see WLDLoopProfiler.h) reports, through recordStall(),
+ * every phase of a thread that takes longer than the thread's budget.  Each stall is added to a
+ * ring of the last FORENSICS_RECORDS stalls, with the boot it happened in, its Unix time (0 before
+ * the time is set from the cloud), the uptime, the thread, the phase and its duration, and is
+ * counted per thread and phase.  Both threads record stalls, so a record is added with thread
+ * switching disabled.
+ *
+ * - A stall that never ends is caught by a watchdog:  the firmware calls resetForStall() when
+ * loop() or the sensing thread has not come around for too long.  It records the stall of the
+ * phase in progress, as a watchdog stall, and resets the device; the next begin() counts the reset
+ * as a watchdog reset.
+ *
+ * - begin() counts every boot and keeps the Device OS reason for the last reset.
+ *
+ * The store has a marker, layout version and CRC, as the event queue store does; begin() starts
+ * a new record if any of them is wrong (after a power loss, or a firmware with another layout).
+ *
+ * format() writes the record for a cloud variable:
+ *      "boots:<n>,reset:<reason>/<data>,watchdogs:<n>,stalls:<n>,counts:<thread>:<phase>=<n> ...;
+ *       <boot>/<time>/<uptime s>/<thread>:<phase>/<duration ms>;..."
+ * with the stalls newest first.  <reason> and <data> are those of the Device OS (for example 20 for
+ * the reset pin, 40 for power down, 130 for a panic), or "watchdog" when the last reset was by
+ * resetForStall().  The duration of a watchdog stall is prefixed with ">".
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  The reset reason and data are no longer cut off at 15 characters
+ *
+ *******************************************************************************/
+#ifndef wldforensics
+#define wldforensics
+
+#include "application.h"
+#include <WLDHal.h>
+#include <WLDCrc.h>
+
+// The threads whose stalls are recorded
+enum WLDForensicsThread {
+    THREAD_LOOP = 0,        // loop()
+    THREAD_SENSING,         // the sensing thread
+    NUM_FORENSICS_THREADS
+};
+
+// Sizes of the record
+const int FORENSICS_RECORDS = 16;           // stalls kept
+const int FORENSICS_PHASES = 16;            // phases counted per thread
+
+// One stall
+struct WLDStallRecord {
+    uint32_t time;                          // Unix time at the end of the stall, or 0 if not set
+    uint32_t uptime;                        // milliseconds from the reset to the end of the stall
+    uint32_t duration;                      // milliseconds
+    uint16_t boot;                          // boot count of the stall
+    uint8_t thread;                         // WLDForensicsThread
+    uint8_t phase;                          // WLDLoopPhase
+    uint8_t watchdog;                       // 1 if the stall was ended by a watchdog reset
+};
+
+// Storage for the record; placed in retained memory
+struct WLDForensicsStore {
+    uint32_t marker;                        // FORENSICS_STORE_MARKER when the store has been initialized
+    uint16_t version;                       // layout version of the store
+    uint16_t crc;                           // CRC of everything after this field
+    uint16_t boots;                         // boots since the store was initialized
+    uint16_t watchdogResets;                // resets by resetForStall()
+    uint16_t resetReason;                   // Device OS reason of the last reset
+    uint8_t watchdogPending;                // set by resetForStall() just before the reset
+    uint8_t newest;                         // index of the newest stall
+    uint32_t resetData;                     // Device OS data of the last reset
+    uint32_t stalls;                        // stalls recorded, including those no longer kept
+    uint16_t counts[NUM_FORENSICS_THREADS][FORENSICS_PHASES];  // stalls of each thread and phase
+    WLDStallRecord records[FORENSICS_RECORDS];
+};
+
+class WLDForensics  {
+    private:
+        // Constants
+        static const uint32_t FORENSICS_STORE_MARKER = 0x574c4446;  // "WLDF"
+        static const uint16_t FORENSICS_STORE_VERSION = 1;
+
+        // Variables
+        WLDHal *_hal;
+        WLDForensicsStore *_store;
+        bool _watchdogReset;                // the last reset was by resetForStall()
+
+        // Private methods (internal use only)
+        uint16_t storeCrc(const WLDForensicsStore *store);
+        void addStall(uint8_t thread, int phase, uint32_t milliseconds, bool watchdog);
+
+    public:
+        // Constructor
+        WLDForensics();
+
+        // Initialization; counts the boot
+        void begin(WLDHal *hal, WLDForensicsStore *store);
+
+        // Recording, from either thread
+        void recordStall(uint8_t thread, int phase, uint32_t microseconds);
+        void resetForStall(uint8_t thread, int phase, uint32_t milliseconds);  // does not return
+        void clear();
+
+        // Reporting
+        uint32_t stalls() { return _store->stalls; }
+        size_t format(char *buffer, size_t size);
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * WLDHal:  hardware abstraction layer for the Water Leak Detector firmware
+ *
+ * The WLD firmware and the WLDAlarmProcessor class do not call the Device OS time, pin, servo,
+ * EEPROM or cloud APIs directly.  Instead, they call the methods of a WLDHal object.  WLDHal is
+ * a pure interface, and needs nothing but the C library:
+ *
+ * - On the Photon the object is a WLDHalPhoton (see WLDHalPhoton.h), whose methods forward to
+ * Device OS, so the firmware behaves exactly as it always has.
+ *
+ * - On a host the object is a simulation with a simulated clock, scripted ADC and GPIO inputs,
+ * an in-memory EEPROM and a mock cloud (see test/WLDHalMock.h), installed by pointing the
+ * firmware's global "hal" pointer at it before setup() is called.  This allows loop() and the
+ * alarm logic to be run, tested and timed without a live device.
+ *
+ * analogReadBurst() reads a block of samples of one analog pin back to back, for oversampling.
+ * An implementation with a free running ADC can fill the block by DMA.
+ *
+ * startThread() starts a thread that runs "function" for ever, at a priority relative to the default
+ * priority of the application thread.
+ *
+ * startWatchdog() starts a watchdog that calls "expired" (in a thread of its own) when loop() has not
+ * come around for "timeout" milliseconds.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Added heapStats()
+ * version 1.2: 10/17/26.  WLDHal is a WLDPublisher, so it can deliver queued events
+ * version 1.3: 10/17/26.  Added delay()
+ * version 1.4: 10/17/26.  Added analogReadBurst()
+ * version 1.5: 10/17/26.  Added startThread()
+ * version 1.6: 10/17/26.  Added unixTime(), resetReason(), reset() and startWatchdog()
+ * version 1.7: 10/17/26.  WLDHal is a pure interface; the Device OS methods are in WLDHalPhoton
+ * version 1.8: 10/17/26.  The heap holes leave out the free chunk at the top of the heap
+ *
+ *******************************************************************************/
+#ifndef wldhal
+#define wldhal
+
+#include <stdint.h>
+#include <stddef.h>
+#include <WLDPublisher.h>
+
+// Heap usage, in bytes
+struct WLDHeapStats {
+    uint32_t inUse;     // bytes allocated by the application and system
+    uint32_t free;      // total free memory
+    uint32_t holes;     // free bytes inside the heap arena below its top free chunk, i.e. fragmented free space
+};
+
+class WLDHal : public WLDPublisher  {
+    public:
+        virtual ~WLDHal() {}
+
+        // Time base
+        virtual unsigned long millis() = 0;
+        virtual unsigned long micros() = 0;
+        virtual void delay(unsigned long milliseconds) = 0;     // wait, running cloud processing meanwhile
+        virtual uint32_t unixTime() = 0;                        // 0 until the time is set from the cloud
+
+        // Threads
+        virtual void startThread(const char *name, void (*function)(void *), void *arg, int priority,
+                                 size_t stackSize) = 0;     // priority is relative to the default priority
+
+        // Resets
+        virtual int resetReason(uint32_t *data) = 0;            // Device OS reason and data of the last reset
+        virtual void reset() = 0;
+        virtual void startWatchdog(unsigned long timeout, void (*expired)()) = 0;
+
+        // Pins; the mode is a Device OS PinMode (INPUT, OUTPUT, INPUT_PULLUP, ...)
+        virtual void pinMode(int pin, int mode) = 0;
+        virtual int analogRead(int pin) = 0;
+        virtual void analogReadBurst(int pin, uint16_t *samples, int count) = 0;
+        virtual int digitalRead(int pin) = 0;
+        virtual void digitalWrite(int pin, int value) = 0;
+
+        // Servo meter
+        virtual void servoAttach(int pin) = 0;
+        virtual void servoWrite(int position) = 0;
+
+        // Non-volatile storage
+        virtual void eepromRead(int address, void *data, size_t length) = 0;
+        virtual void eepromWrite(int address, const void *data, size_t length) = 0;
+
+        // Memory
+        virtual void heapStats(WLDHeapStats *stats) = 0;
+
+        // Cloud (WLDPublisher)
+        virtual bool cloudConnected() = 0;
+        virtual bool publish(const char *eventName, const char *eventData) = 0;
+};
+
+#endif
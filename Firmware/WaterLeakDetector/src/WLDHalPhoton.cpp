@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * WLDHalPhoton:  the WLDHal of the Photon, which forwards to Device OS
+ *
+ * See WLDHalPhoton.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release; the Device OS methods of WLDHal 1.6
+ * version 1.1: 10/17/26.  The heap holes leave out the free space at the top of the heap
+ * version 1.2: 10/17/26.  publish() publishes private events
+ *
+ *******************************************************************************/
+#include <WLDHalPhoton.h>
+#include <malloc.h>
+
+// Constructor
+WLDHalPhoton::WLDHalPhoton() {
+    // nothing to initialize; the servo is attached in servoAttach()
+}   // end of Constructor
+
+// Time base
+
+unsigned long WLDHalPhoton::millis() {
+    return ::millis();
+}   // end of millis()
+
+unsigned long WLDHalPhoton::micros() {
+    return ::micros();
+}   // end of micros()
+
+void WLDHalPhoton::delay(unsigned long milliseconds) {
+    ::delay(milliseconds);
+}   // end of delay()
+
+uint32_t WLDHalPhoton::unixTime() {
+    return Time.isValid() ? (uint32_t)Time.now() : 0;
+}   // end of unixTime()
+
+// Threads
+
+// start a Device OS thread; it is never stopped, so the Thread object is never deleted
+void WLDHalPhoton::startThread(const char *name, void (*function)(void *), void *arg, int priority, size_t stackSize) {
+    new Thread(name, function, arg, (os_thread_prio_t)(OS_THREAD_PRIORITY_DEFAULT + priority), stackSize);
+}   // end of startThread()
+
+// Resets
+
+int WLDHalPhoton::resetReason(uint32_t *data) {
+    *data = System.resetReasonData();
+    return System.resetReason();
+}   // end of resetReason()
+
+void WLDHalPhoton::reset() {
+    System.reset();
+}   // end of reset()
+
+// start the application watchdog; it is never stopped, so the ApplicationWatchdog object is never deleted
+void WLDHalPhoton::startWatchdog(unsigned long timeout, void (*expired)()) {
+    new ApplicationWatchdog(timeout, expired, 1536);    // stack for the forensics record
+}   // end of startWatchdog()
+
+// Pins
+
+void WLDHalPhoton::pinMode(int pin, int mode) {
+    ::pinMode(pin, (PinMode)mode);
+}   // end of pinMode()
+
+int WLDHalPhoton::analogRead(int pin) {
+    return ::analogRead(pin);
+}   // end of analogRead()
+
+// read "count" samples of an analog pin, back to back, into "samples"
+void WLDHalPhoton::analogReadBurst(int pin, uint16_t *samples, int count) {
+    for(int i = 0; i < count; i++) {
+        samples[i] = ::analogRead(pin);
+    }
+}   // end of analogReadBurst()
+
+int WLDHalPhoton::digitalRead(int pin) {
+    return ::digitalRead(pin);
+}   // end of digitalRead()
+
+void WLDHalPhoton::digitalWrite(int pin, int value) {
+    ::digitalWrite(pin, value);
+}   // end of digitalWrite()
+
+// Servo meter
+
+void WLDHalPhoton::servoAttach(int pin) {
+    _servo.attach(pin);
+}   // end of servoAttach()
+
+void WLDHalPhoton::servoWrite(int position) {
+    _servo.write(position);
+}   // end of servoWrite()
+
+// Non-volatile storage
+
+// read "length" bytes of emulated EEPROM starting at "address" into "data"
+void WLDHalPhoton::eepromRead(int address, void *data, size_t length) {
+    uint8_t *bytes = (uint8_t *)data;
+
+    for(size_t i = 0; i < length; i++) {
+        bytes[i] = EEPROM.read(address + i);
+    }
+}   // end of eepromRead()
+
+// write "length" bytes from "data" to emulated EEPROM starting at "address"
+void WLDHalPhoton::eepromWrite(int address, const void *data, size_t length) {
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    for(size_t i = 0; i < length; i++) {
+        EEPROM.write(address + i, bytes[i]);
+    }
+}   // end of eepromWrite()
+
+// Memory
+
+// report heap usage from the C library allocator and Device OS
+void WLDHalPhoton::heapStats(WLDHeapStats *stats) {
+    struct mallinfo info = mallinfo();
+
+    stats->inUse = info.uordblks;
+    stats->holes = info.fordblks - info.keepcost;   // the free chunk at the top of the heap is not a hole
+    stats->free = System.freeMemory();
+}   // end of heapStats()
+
+// Cloud
+
+bool WLDHalPhoton::cloudConnected() {
+    return Particle.connected();
+}   // end of cloudConnected()
+
+bool WLDHalPhoton::publish(const char *eventName, const char *eventData) {
+    return Particle.publish(eventName, eventData, PRIVATE);
+}   // end of publish()
@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * WLDHalPhoton:  the WLDHal of the Photon, which forwards to Device OS
+ *
+ * The methods of this class simply forward to the Device OS time, pin, servo, EEPROM and cloud
+ * APIs (see WLDHal.h for the interface):
+ *
+ * - analogReadBurst() reads the block of samples with analogRead(), which on the Photon already
+ * averages a short DMA burst of conversions.
+ *
+ * - startThread() starts a Device OS thread.
+ *
+ * - heapStats() takes the heap holes from mallinfo():  the free bytes of the arena (fordblks) less
+ * the free chunk at its top (keepcost), which any allocation that fits can still use.
+ *
+ * - startWatchdog() starts the Device OS application watchdog.  resetReason() requires the
+ * FEATURE_RESET_INFO system feature.
+ *
+ * - publish() publishes a private event with Particle.publish().
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release; the Device OS methods of WLDHal 1.6
+ * version 1.1: 10/17/26.  The heap holes leave out the free space at the top of the heap
+ * version 1.2: 10/17/26.  publish() publishes private events
+ *
+ *******************************************************************************/
+#ifndef wldhalphoton
+#define wldhalphoton
+
+#include "application.h"
+#include <WLDHal.h>
+
+class WLDHalPhoton : public WLDHal  {
+    private:
+        Servo _servo;   // the meter servo
+
+    public:
+        // Constructor
+        WLDHalPhoton();
+
+        // Time base
+        unsigned long millis();
+        unsigned long micros();
+        void delay(unsigned long milliseconds);
+        uint32_t unixTime();
+
+        // Threads
+        void startThread(const char *name, void (*function)(void *), void *arg, int priority, size_t stackSize);
+
+        // Resets
+        int resetReason(uint32_t *data);
+        void reset();
+        void startWatchdog(unsigned long timeout, void (*expired)());
+
+        // Pins
+        void pinMode(int pin, int mode);
+        int analogRead(int pin);
+        void analogReadBurst(int pin, uint16_t *samples, int count);
+        int digitalRead(int pin);
+        void digitalWrite(int pin, int value);
+
+        // Servo meter
+        void servoAttach(int pin);
+        void servoWrite(int position);
+
+        // Non-volatile storage
+        void eepromRead(int address, void *data, size_t length);
+        void eepromWrite(int address, const void *data, size_t length);
+
+        // Memory
+        void heapStats(WLDHeapStats *stats);
+
+        // Cloud
+        bool cloudConnected();
+        bool publish(const char *eventName, const char *eventData);
+};
+
+#endif
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * WLDHeapMonitor:  class to track heap usage and fragmentation over the life of the device
+ *
+ * See WLDHeapMonitor.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include <WLDHeapMonitor.h>
+
+// Constructor
+WLDHeapMonitor::WLDHeapMonitor() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDHeapMonitor::begin(WLDHal *hal) {
+    _hal = hal;
+    _hal->heapStats(&_current);
+    _maxInUse = _current.inUse;
+    _minFree = _current.free;
+    _steadyInUse = _current.inUse;
+    _growthCount = 0;
+    _steady = false;
+}   // end of begin()
+
+// declare that startup allocations are done; any later growth of the heap is counted
+void WLDHeapMonitor::steadyState() {
+    _hal->heapStats(&_current);
+    _steadyInUse = _current.inUse;
+    _steady = true;
+}   // end of steadyState()
+
+// Sampling
+
+// sample the heap and update the high-water marks and the growth count
+void WLDHeapMonitor::update() {
+    uint32_t lastInUse = _current.inUse;
+
+    _hal->heapStats(&_current);
+    if(_current.inUse > _maxInUse) {
+        _maxInUse = _current.inUse;
+    }
+    if(_current.free < _minFree) {
+        _minFree = _current.free;
+    }
+    if(_steady == true && _current.inUse > lastInUse && _current.inUse > _steadyInUse) {
+        _growthCount++;
+    }
+}   // end of update()
+
+// Results
+
+// write the heap summary into buffer; returns the length written
+size_t WLDHeapMonitor::format(char *buffer, size_t size) {
+    int written = snprintf(buffer, size, "inUse=%lu,maxInUse=%lu,free=%lu,minFree=%lu,holes=%lu,growth=%lu",
+        (unsigned long)_current.inUse, (unsigned long)_maxInUse, (unsigned long)_current.free,
+        (unsigned long)_minFree, (unsigned long)_current.holes, (unsigned long)_growthCount);
+    if(written < 0) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    return ((size_t)written < size) ? written : size - 1;
+}   // end of format()
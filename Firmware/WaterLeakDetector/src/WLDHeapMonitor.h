@@ -0,0 +1,56 @@
+/*******************************************************************************
+ * WLDHeapMonitor:  class to track heap usage and fragmentation over the life of the device
+ *
+ * The WLD firmware calls update() periodically (once per second) from loop().  Each update
+ * samples the heap and records:
+ *
+ * - the highest heap use and the lowest free memory ever seen (high-water marks);
+ * - the current fragmented free space inside the heap;
+ * - the number of updates, after steady state was declared, at which heap use had grown.
+ *
+ * The firmware calls steadyState() once startup is over: setup() has finished, the cloud
+ * connection is up and the first readings have been formatted.  From then on, the cloud visible
+ * status is kept in preallocated buffers, so heap use should never grow: a "growth" count that
+ * stays at zero proves that the loop does not allocate.  format() writes a summary for a cloud variable.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#ifndef wldhm
+#define wldhm
+
+#include "application.h"
+#include <WLDHal.h>
+
+class WLDHeapMonitor  {
+    private:
+        // Variables
+        WLDHal *_hal;
+        WLDHeapStats _current;      // most recent sample
+        uint32_t _maxInUse;         // high-water mark of heap use
+        uint32_t _minFree;          // low-water mark of free memory
+        uint32_t _steadyInUse;      // heap use when steady state was declared
+        uint32_t _growthCount;      // updates in steady state at which heap use had grown
+        bool _steady;
+
+    public:
+        // Constructor
+        WLDHeapMonitor();
+
+        // Initialization
+        void begin(WLDHal *hal);
+        void steadyState();
+
+        // Sampling
+        void update();
+
+        // Results
+        bool steady() { return _steady; }
+        uint32_t growthCount() { return _growthCount; }
+        size_t format(char *buffer, size_t size);
+};
+
+#endif
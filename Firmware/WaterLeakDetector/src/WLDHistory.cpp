@@ -0,0 +1,285 @@
+/*******************************************************************************
+ * WLDHistory:  compact multi-resolution history of the WLD readings, kept on the device
+ *
+ * See WLDHistory.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  A block is emptied before the newest block moves on to it, so that a reset
+ *  between the two cannot leave the oldest records as the newest
+ *
+ *******************************************************************************/
+#include <WLDHistory.h>
+
+static_assert(VARINT_MAX_SIZE * HISTORY_MAX_FIELDS <= HISTORY_BLOCK_DATA, "a block must hold any record");
+
+// Constructor
+WLDHistory::WLDHistory() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDHistory::begin(WLDHal *hal, int probes) {
+    _hal = hal;
+    _probes = constrain(probes, 0, HISTORY_MAX_PROBES);
+    _fields = 2 + _probes;
+    _numTiers = 0;
+}   // end of begin()
+
+// Adding readings
+
+// add the readings to the slot in progress of every tier; a tier whose slot has ended keeps a record of it first
+void WLDHistory::add(int16_t temperature, int16_t humidity, const uint16_t *millivolts) {
+    uint32_t time = _hal->unixTime();
+
+    if(time == 0) {
+        return;     // a record is no use without its time
+    }
+
+    for(int i = 0; i < _numTiers; i++) {
+        WLDHistoryTier *tier = &_tiers[i];
+        uint32_t slot = time / tier->header->interval;
+
+        if(tier->samples > 0 && slot != tier->slot) {
+            endSlot(tier);
+        }
+        tier->slot = slot;
+        tier->samples++;
+        if(temperature != HISTORY_NO_READING && humidity != HISTORY_NO_READING) {
+            tier->temperatureSum += temperature;
+            tier->humiditySum += humidity;
+            tier->readings++;
+        }
+        for(int probe = 0; probe < _probes; probe++) {
+            if(millivolts[probe] > tier->peaks[probe]) {
+                tier->peaks[probe] = millivolts[probe];
+            }
+        }
+    }
+}   // end of add()
+
+// Reporting
+
+// write a page of the records of a tier, from a Unix time on (see WLDHistory.h); returns the records written
+int WLDHistory::format(char *buffer, size_t size, int tierNumber, uint32_t from) {
+    const int HEADER_SIZE = 32;     // room kept for the header, which is written last
+    char record[12 * (1 + HISTORY_MAX_FIELDS)];
+    int length = 0, records = 0;
+    uint32_t next = 0, runEnd = 0;
+
+    if(tierNumber < 0 || tierNumber >= _numTiers) {
+        return -1;
+    }
+    if(size <= HEADER_SIZE) {
+        return 0;
+    }
+    WLDHistoryTier *tier = &_tiers[tierNumber];
+    uint16_t interval = tier->header->interval;
+    char *body = buffer + HEADER_SIZE;
+    size_t bodySize = size - HEADER_SIZE;
+
+    // the blocks from the oldest to the newest, and the records of each in order
+    for(int i = 1; i <= tier->header->blocks && next == 0; i++) {
+        const WLDHistoryBlock *block = &tier->blocks[(tier->header->newest + i) % tier->header->blocks];
+        int32_t fields[HISTORY_MAX_FIELDS] = { 0 };
+        int offset = 0;
+
+        for(int n = 0; n < block->count; n++) {
+            uint32_t time = block->time + (uint32_t)n * interval;
+            int recordLength = 0;
+
+            offset += decodeRecord(block, offset, fields);
+            if(time < from) {
+                continue;
+            }
+            if(records == 0 || time != runEnd) {     // the start of a run
+                recordLength = snprintf(record, sizeof(record), ";%lu:", (unsigned long)time);
+            } else {
+                record[recordLength++] = ',';
+            }
+            for(int field = 0; field < _fields; field++) {
+                if(field < 2 && fields[field] == HISTORY_NO_READING) {
+                    recordLength += snprintf(record + recordLength, sizeof(record) - recordLength, "%s-",
+                                             field == 0 ? "" : "/");
+                } else {
+                    recordLength += snprintf(record + recordLength, sizeof(record) - recordLength, "%s%ld",
+                                             field == 0 ? "" : "/", (long)fields[field]);
+                }
+            }
+            if(length + recordLength >= (int)bodySize) {
+                next = time;    // out of room; the next page starts here
+                break;
+            }
+            memcpy(body + length, record, recordLength);
+            length += recordLength;
+            records++;
+            runEnd = time + interval;
+        }
+    }
+    body[length] = '\0';
+
+    // the header goes just in front of the records
+    char header[HEADER_SIZE];
+    int headerLength = snprintf(header, sizeof(header), "%d,%u,%lu", tierNumber, interval, (unsigned long)next);
+    memcpy(buffer, header, headerLength);
+    memmove(buffer + headerLength, body, length + 1);
+    return records;
+}   // end of format()
+
+// private methods
+
+// take a store for a tier; keep its records if the store is intact, but for the blocks that are not
+bool WLDHistory::addTier(WLDHistoryHeader *header, WLDHistoryBlock *blocks, int numBlocks, uint16_t interval) {
+    if(_numTiers >= HISTORY_MAX_TIERS || interval == 0) {
+        return false;
+    }
+    WLDHistoryTier *tier = &_tiers[_numTiers++];
+
+    memset(tier, 0, sizeof(WLDHistoryTier));
+    tier->header = header;
+    tier->blocks = blocks;
+
+    if(header->marker != HISTORY_STORE_MARKER || header->version != HISTORY_STORE_VERSION ||
+       header->interval != interval || header->blocks != numBlocks || header->fields != _fields ||
+       header->newest >= numBlocks || header->crc != headerCrc(header)) {
+        memset(header, 0, sizeof(WLDHistoryHeader));
+        header->marker = HISTORY_STORE_MARKER;
+        header->version = HISTORY_STORE_VERSION;
+        header->interval = interval;
+        header->blocks = numBlocks;
+        header->fields = _fields;
+        header->crc = headerCrc(header);
+        memset(blocks, 0, numBlocks * sizeof(WLDHistoryBlock));
+    }
+    startTier(tier);
+    return true;
+}   // end of addTier()
+
+// empty the blocks of a tier that are not intact, and take the last record from the newest block
+void WLDHistory::startTier(WLDHistoryTier *tier) {
+    for(int i = 0; i < tier->header->blocks; i++) {
+        WLDHistoryBlock *block = &tier->blocks[i];
+        bool intact = (block->length <= HISTORY_BLOCK_DATA && block->crc == blockCrc(block));
+
+        // every record must decode within the data, as later blocks are read without checking
+        for(int n = 0, offset = 0; intact == true && n < block->count; n++) {
+            int recordLength = decodeRecord(block, offset, tier->last);
+            intact = (recordLength > 0);
+            offset += recordLength;
+        }
+        if(intact == false) {
+            memset(block, 0, sizeof(WLDHistoryBlock));
+            block->crc = blockCrc(block);
+        }
+    }
+
+    // the fields of the newest record are the base of the next one
+    WLDHistoryBlock *newest = &tier->blocks[tier->header->newest];
+    memset(tier->last, 0, sizeof(tier->last));
+    for(int n = 0, offset = 0; n < newest->count; n++) {
+        offset += decodeRecord(newest, offset, tier->last);
+    }
+    tier->lastValid = (newest->count > 0);
+}   // end of startTier()
+
+// keep a record of the slot in progress of a tier, and start the next slot
+void WLDHistory::endSlot(WLDHistoryTier *tier) {
+    int32_t fields[HISTORY_MAX_FIELDS];
+    int32_t readings = tier->readings;
+
+    fields[0] = fields[1] = HISTORY_NO_READING;
+    if(readings > 0) {  // averages, rounded to the nearest tenth
+        fields[0] = (tier->temperatureSum + (tier->temperatureSum >= 0 ? readings : -readings) / 2) / readings;
+        fields[1] = (tier->humiditySum + readings / 2) / readings;
+    }
+    for(int probe = 0; probe < _probes; probe++) {
+        fields[2 + probe] = tier->peaks[probe];
+    }
+    addRecord(tier, tier->slot * tier->header->interval, fields);
+
+    tier->samples = 0;
+    tier->readings = 0;
+    tier->temperatureSum = 0;
+    tier->humiditySum = 0;
+    memset(tier->peaks, 0, sizeof(tier->peaks));
+}   // end of endSlot()
+
+// add a record to the newest block of a tier, or, if it does not fit or follow on, start the next block with it
+void WLDHistory::addRecord(WLDHistoryTier *tier, uint32_t time, const int32_t *fields) {
+    static const int32_t ZERO[HISTORY_MAX_FIELDS] = { 0 };
+    uint8_t encoded[VARINT_MAX_SIZE * HISTORY_MAX_FIELDS];
+    WLDHistoryBlock *block = &tier->blocks[tier->header->newest];
+    int length = 0;
+
+    if(tier->lastValid == true && block->count < 255 &&
+       time == block->time + (uint32_t)block->count * tier->header->interval) {
+        length = encodeRecord(fields, tier->last, encoded);
+        if(block->length + length > HISTORY_BLOCK_DATA) {
+            length = 0;     // the block is full
+        }
+    }
+
+    if(length == 0) {
+        // the oldest block is emptied before the header moves on to it:  after a reset between the two, the
+        //  newest block is still the one before it, and after a reset within either, a CRC is wrong
+        int next = (tier->header->newest + 1) % tier->header->blocks;
+        block = &tier->blocks[next];
+        block->time = time;
+        block->count = 0;
+        block->length = 0;
+        block->crc = blockCrc(block);
+        tier->header->newest = next;
+        tier->header->crc = headerCrc(tier->header);
+        length = encodeRecord(fields, ZERO, encoded);
+    }
+
+    memcpy(block->data + block->length, encoded, length);
+    block->length += length;
+    block->count++;
+    block->crc = blockCrc(block);
+    memcpy(tier->last, fields, _fields * sizeof(int32_t));
+    tier->lastValid = true;
+}   // end of addRecord()
+
+// encode the fields of a record as differences from "base"; returns the length
+int WLDHistory::encodeRecord(const int32_t *fields, const int32_t *base, uint8_t *buffer) {
+    int length = 0;
+
+    for(int field = 0; field < _fields; field++) {
+        length += putVarint(buffer + length, zigzag(fields[field] - base[field]));
+    }
+    return length;
+}   // end of encodeRecord()
+
+// decode the record at "offset" in a block, with "fields" holding the record before it on entry; returns the
+//  length of the record, or 0 if it runs off the end of the data
+int WLDHistory::decodeRecord(const WLDHistoryBlock *block, int offset, int32_t *fields) {
+    int start = offset;
+
+    for(int field = 0; field < _fields; field++) {
+        uint32_t value;
+        int length = getVarint(block->data + offset, block->length - offset, &value);
+        if(length == 0) {
+            return 0;
+        }
+        fields[field] += unzigzag(value);
+        offset += length;
+    }
+    return offset - start;
+}   // end of decodeRecord()
+
+// CRC of a block; the CRC field itself and the unused data are not included
+uint16_t WLDHistory::blockCrc(const WLDHistoryBlock *block) {
+    uint16_t crc = crc16(&block->time, sizeof(block->time));
+    crc = crc16(&block->count, sizeof(block->count) + sizeof(block->length), crc);
+    return crc16(block->data, block->length <= HISTORY_BLOCK_DATA ? block->length : 0, crc);
+}   // end of blockCrc()
+
+// CRC of the layout of a store; the marker, version and CRC fields themselves are not included
+uint16_t WLDHistory::headerCrc(const WLDHistoryHeader *header) {
+    const uint8_t *contents = (const uint8_t *)&header->crc + sizeof(header->crc);
+
+    return crc16(contents, sizeof(WLDHistoryHeader) - (contents - (const uint8_t *)header));
+}   // end of headerCrc()
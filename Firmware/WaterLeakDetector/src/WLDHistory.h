@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * WLDHistory:  compact multi-resolution history of the WLD readings, kept on the device
+ *
+ * After a leak, the temperature, humidity and probe voltages of the hours before it tell what
+ * happened (a burst steam pipe, a slow seep, a freeze), but streaming every reading to the cloud
+ * costs too much.  A WLDHistory keeps them on the device, in tiers of decreasing resolution (for
+ * example every 10 seconds for the last hour and every minute for the last day), for the app to
+ * fetch when it wants them:
+ *
+ * - The firmware calls add() with the current readings more often than the shortest tier
+ * interval.  Each tier collects the readings of its current interval (its "slot"), and when the
+ * time moves into the next slot it keeps one record of the slot:  the average temperature and
+ * humidity, in tenths, and the highest voltage of each probe, in millivolts, so that a short wet
+ * reading is not averaged away.  A temperature and humidity of HISTORY_NO_READING means that there
+ * was no good reading in the slot.  Records are only kept once the time has been set from the cloud.
+ *
+ * - Each tier is a ring of WLDHistoryBlocks in a WLDHistoryStore supplied by the caller.  A block
+ * holds the records of consecutive slots from the time of its first record, as LEB128 varints (see
+ * WLDVarint.h):  for each record, each field as the zigzag encoded difference from the same field
+ * of the record before it, and the first record of the block from zero.  A quiet slot takes one
+ * byte per field, so a 128 byte block holds about half an hour of slots with two probes.  A record
+ * that does not fit, or that does not follow on from the last one (after a reset, or when the time
+ * is set), starts the next block, over the oldest one.  Adding a record is constant time:  the
+ * fields of the last record are kept, and only the CRC of the block written to is updated.
+ *
+ * - Each store has a marker, layout version and CRC, as the event queue store does, and each block
+ * has a CRC of its own.  The firmware places the store of the shortest tier in retained memory:
+ * addTier() keeps the records of a store that is intact, and empties only the blocks whose CRC is
+ * wrong (a block that was being written at a reset).
+ *
+ * format() writes a page of records of one tier, from a Unix time on, for a cloud variable:
+ *      "<tier>,<interval s>,<next>;<time>:<temperature>/<humidity>/<mv>/...,<temperature>/...;<time>:..."
+ * Each ";" starts a run of records of consecutive slots from <time>; the temperature (F) and
+ * humidity (%RH) are in tenths, or "-" if there was no reading.  <next> is the time to ask for
+ * the next page from, or 0 if the page holds the newest record.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  A block is emptied before the newest block moves on to it, so that a reset
+ *  between the two cannot leave the oldest records as the newest
+ *
+ *******************************************************************************/
+#ifndef wldhistory
+#define wldhistory
+
+#include "application.h"
+#include <WLDHal.h>
+#include <WLDCrc.h>
+#include <WLDVarint.h>
+
+// Sizes of the history
+const int HISTORY_MAX_TIERS = 3;
+const int HISTORY_MAX_PROBES = 4;           // probe voltages kept in each record
+const int HISTORY_MAX_FIELDS = 2 + HISTORY_MAX_PROBES;
+const int HISTORY_BLOCK_DATA = 120;         // bytes of records in a block
+const int16_t HISTORY_NO_READING = -32768;  // temperature and humidity of a slot without a good reading
+
+// One block of records of consecutive slots
+struct WLDHistoryBlock {
+    uint32_t time;                          // Unix time of the first record
+    uint16_t crc;                           // CRC of the time, count, length and the used data
+    uint8_t count;                          // records in the block; 0 if the block is empty
+    uint8_t length;                         // bytes of data used
+    uint8_t data[HISTORY_BLOCK_DATA];
+};
+
+// Layout of a store
+struct WLDHistoryHeader {
+    uint32_t marker;                        // HISTORY_STORE_MARKER when the store has been initialized
+    uint16_t version;                       // layout version of the store
+    uint16_t crc;                           // CRC of the fields below
+    uint16_t interval;                      // seconds per record
+    uint16_t blocks;                        // blocks in the store
+    uint8_t fields;                         // fields per record
+    uint8_t newest;                         // index of the block being added to
+};
+
+// Storage for one tier; may be placed in retained memory
+template <int BLOCKS>
+struct WLDHistoryStore {
+    static_assert(BLOCKS >= 2 && BLOCKS <= 256, "a store has 2 to 256 blocks");
+
+    WLDHistoryHeader header;
+    WLDHistoryBlock blocks[BLOCKS];
+};
+
+// State of one tier, kept by the WLDHistory
+struct WLDHistoryTier {
+    WLDHistoryHeader *header;
+    WLDHistoryBlock *blocks;
+    int32_t last[HISTORY_MAX_FIELDS];       // fields of the newest record, the base of the next one
+    bool lastValid;                         // the newest block can be added to
+
+    // readings of the slot in progress
+    uint32_t slot;                          // Unix time / interval
+    uint16_t samples;                       // readings added
+    uint16_t readings;                      // of which with a good temperature and humidity
+    int32_t temperatureSum;
+    int32_t humiditySum;
+    uint16_t peaks[HISTORY_MAX_PROBES];     // highest probe voltages
+};
+
+class WLDHistory  {
+    private:
+        // Constants
+        static const uint32_t HISTORY_STORE_MARKER = 0x574c4448;  // "WLDH"
+        static const uint16_t HISTORY_STORE_VERSION = 1;
+
+        // Variables
+        WLDHal *_hal;
+        int _probes;                        // probe voltages in each record
+        int _fields;                        // fields in each record
+        int _numTiers;
+        WLDHistoryTier _tiers[HISTORY_MAX_TIERS];
+
+        // Private methods (internal use only)
+        bool addTier(WLDHistoryHeader *header, WLDHistoryBlock *blocks, int numBlocks, uint16_t interval);
+        void startTier(WLDHistoryTier *tier);
+        void endSlot(WLDHistoryTier *tier);
+        void addRecord(WLDHistoryTier *tier, uint32_t time, const int32_t *fields);
+        int encodeRecord(const int32_t *fields, const int32_t *base, uint8_t *buffer);
+        int decodeRecord(const WLDHistoryBlock *block, int offset, int32_t *fields);
+        uint16_t blockCrc(const WLDHistoryBlock *block);
+        uint16_t headerCrc(const WLDHistoryHeader *header);
+
+    public:
+        // Constructor
+        WLDHistory();
+
+        // Initialization; each record holds "probes" probe voltages
+        void begin(WLDHal *hal, int probes);
+
+        // Add a tier of records every "interval" seconds, kept in "store"; tiers are numbered from 0 in the
+        //  order they are added.  False if there are too many tiers
+        template <int BLOCKS>
+        bool addTier(WLDHistoryStore<BLOCKS> *store, uint16_t interval) {
+            return addTier(&store->header, store->blocks, BLOCKS, interval);
+        }
+
+        // Add the current readings to every tier:  tenths of a degree F and of a %RH (HISTORY_NO_READING if
+        //  there is no good reading), and millivolts of each probe
+        void add(int16_t temperature, int16_t humidity, const uint16_t *millivolts);
+
+        // Write the records of "tier" from Unix time "from" on into buffer (see above); returns the number of
+        //  records written, or -1 if there is no such tier
+        int format(char *buffer, size_t size, int tier, uint32_t from);
+
+        // Status
+        int numTiers() { return _numTiers; }
+};
+
+#endif
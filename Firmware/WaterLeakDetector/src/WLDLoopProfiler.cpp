@@ -0,0 +1,192 @@
+/*******************************************************************************
+ * WLDLoopProfiler:  class to measure how long each phase of the WLD loop() takes
+ *
+ * See WLDLoopProfiler.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Added the publish phase
+ * version 1.2: 10/17/26.  Added the idle phase
+ * version 1.3: 10/17/26.  The nominal sample interval can be changed, for adaptive sampling
+ * version 1.4: 10/17/26.  Added stall monitoring and the config phase
+ *
+ *******************************************************************************/
+#include <WLDLoopProfiler.h>
+#include <WLDForensics.h>
+
+// short names of the phases, in WLDLoopPhase order, for the cloud variable
+static const char * const PHASE_NAMES[NUM_LOOP_PHASES] = {
+    "loop", "gap", "dht", "water", "alarms", "status", "outputs", "publish", "idle", "interval", "jitter", "config"
+};
+
+// Constructor
+WLDLoopProfiler::WLDLoopProfiler() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDLoopProfiler::begin(WLDHal *hal, unsigned long nominalSampleIntervalMs) {
+    _hal = hal;
+    _nominalInterval = nominalSampleIntervalMs * 1000UL;
+    _enabled = false;   // profiling is off until enabled from the cloud
+    _timing = false;
+    _forensics = NULL;
+    _current = _outside = PHASE_GAP;    // setup() is outside of loop()
+    _stalled = false;
+    reset();
+}   // end of begin()
+
+// report phases longer than "budget" microseconds to "forensics" as stalls of "thread", from now on
+void WLDLoopProfiler::setStallMonitor(WLDForensics *forensics, uint8_t thread, uint32_t budget) {
+    _forensics = forensics;
+    _thread = thread;
+    _budget = budget;
+    _timing = true;
+}   // end of setStallMonitor()
+
+// Control
+
+// turn profiling on or off; the histograms are kept
+void WLDLoopProfiler::enable(bool on) {
+    _enabled = on;
+    _timing = on || (_forensics != NULL);
+    _haveLastSample = false;    // don't count the time spent disabled as a sample interval
+    _haveLoopEnd = false;       // or as time spent outside of loop()
+}   // end of enable()
+
+// clear all of the histograms
+void WLDLoopProfiler::reset() {
+    memset(_counts, 0, sizeof(_counts));
+    for(int phase = 0; phase < NUM_LOOP_PHASES; phase++) {
+        _total[phase] = 0;
+        _min[phase] = 0xffffffff;
+        _max[phase] = 0;
+        _start[phase] = 0;
+    }
+    _haveLastSample = false;
+    _haveLoopEnd = false;
+}   // end of reset()
+
+// Measurement
+
+// add a duration, in microseconds, to the histogram of a phase
+void WLDLoopProfiler::record(int phase, uint32_t microseconds) {
+    if(_enabled == false) {
+        return;
+    }
+
+    _counts[phase][bucketOf(microseconds)]++;
+    _total[phase]++;
+    if(microseconds < _min[phase]) {
+        _min[phase] = microseconds;
+    }
+    if(microseconds > _max[phase]) {
+        _max[phase] = microseconds;
+    }
+}   // end of record()
+
+// called each time the water sensors are sampled to record the sample interval and its jitter
+void WLDLoopProfiler::markSample() {
+    if(_timing == false) {
+        return;
+    }
+
+    unsigned long now = _hal->micros();
+    if(_haveLastSample == true) {
+        uint32_t interval = now - _lastSample;
+        record(PHASE_SAMPLE_INTERVAL, interval);
+        if(interval > _nominalInterval) {
+            checkStall(PHASE_SAMPLE_INTERVAL, interval - _nominalInterval);     // how late the sample was
+        }
+        if(interval > _nominalInterval) {
+            record(PHASE_SAMPLE_JITTER, interval - _nominalInterval);
+        } else {
+            record(PHASE_SAMPLE_JITTER, _nominalInterval - interval);
+        }
+    }
+    _lastSample = now;
+    _haveLastSample = true;
+}   // end of markSample()
+
+// Reporting
+
+const char *WLDLoopProfiler::phaseName(int phase) {
+    return (phase >= 0 && phase < NUM_LOOP_PHASES) ? PHASE_NAMES[phase] : "?";
+}   // end of phaseName()
+
+// write "phase:min/p50/p99/max" for every phase with data into buffer; returns the length written
+size_t WLDLoopProfiler::format(char *buffer, size_t size) {
+    size_t length = 0;
+
+    buffer[0] = '\0';
+    for(int phase = 0; phase < NUM_LOOP_PHASES; phase++) {
+        if(_total[phase] == 0) {
+            continue;
+        }
+        int written = snprintf(buffer + length, size - length, "%s%s:%lu/%lu/%lu/%lu",
+            (length == 0) ? "" : ",", PHASE_NAMES[phase],
+            (unsigned long)_min[phase], (unsigned long)percentile(phase, 50),
+            (unsigned long)percentile(phase, 99), (unsigned long)_max[phase]);
+        if(written < 0 || (size_t)written >= size - length) {
+            buffer[length] = '\0';  // out of room; drop the partial entry
+            break;
+        }
+        length += written;
+    }
+    return length;
+}   // end of format()
+
+// private methods
+
+// report a phase that took longer than the budget as a stall
+void WLDLoopProfiler::checkStall(int phase, uint32_t microseconds) {
+    if(_forensics != NULL && microseconds > _budget) {
+        _forensics->recordStall(_thread, phase, microseconds);
+        _stalled = true;
+    }
+}   // end of checkStall()
+
+// histogram bucket for a duration: values below 4 have their own bucket, then 4 buckets per power of two
+int WLDLoopProfiler::bucketOf(uint32_t microseconds) {
+    if(microseconds < (uint32_t)SUB_BUCKETS) {
+        return microseconds;
+    }
+
+    int msb = 31 - __builtin_clz(microseconds);
+    if(msb > MAX_POWER) {
+        return NUM_BUCKETS - 1;     // clamp very long durations into the last bucket
+    }
+    return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + ((microseconds >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+}   // end of bucketOf()
+
+// the largest duration that falls into a bucket
+uint32_t WLDLoopProfiler::bucketUpperEdge(int bucket) {
+    if(bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+
+    int msb = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    uint32_t width = 1UL << (msb - SUB_BUCKET_BITS);
+    uint32_t lower = (uint32_t)(SUB_BUCKETS + (bucket % SUB_BUCKETS)) * width;
+    return lower + width - 1;
+}   // end of bucketUpperEdge()
+
+// approximate percentile of a phase: the upper edge of the bucket holding it, limited to the true maximum
+uint32_t WLDLoopProfiler::percentile(int phase, int percent) {
+    uint32_t target = (uint32_t)(((uint64_t)_total[phase] * percent + 99) / 100);
+    uint32_t cumulative = 0;
+
+    if(target == 0) {
+        target = 1;
+    }
+    for(int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+        cumulative += _counts[phase][bucket];
+        if(cumulative >= target) {
+            uint32_t edge = bucketUpperEdge(bucket);
+            return (edge < _max[phase]) ? edge : _max[phase];
+        }
+    }
+    return _max[phase];
+}   // end of percentile()
@@ -0,0 +1,181 @@
+/*******************************************************************************
+ * WLDLoopProfiler:  class to measure how long each phase of the WLD loop() takes
+ *
+ * The WLD firmware calls beginLoop() and endLoop() at the top and bottom of loop(), and brackets
+ * each phase of loop() (DHT polling, the water measurement, alarm processing, writing the alarm
+ * status string and refreshing the indicator/buzzer) with calls to start() and stop().  The
+ * elapsed time of each phase, in microseconds, is recorded into a fixed-size histogram.  The
+ * time between loop() calls, spent in system and cloud processing, is recorded as well.  The
+ * firmware also calls markSample() each time the water sensors are read, so that the actual
+ * sample-to-sample interval and its deviation from the nominal interval (jitter) are recorded
+ * too.  When loop() waits for its next scheduled task, it brackets the wait with beginIdle() and
+ * endIdle(); the wait is recorded as the idle phase and is not counted as part of the loop or of
+ * the time between loop() calls.
+ *
+ * Histograms are log-scale: each power of two is split into 4 buckets, so every bucket is
+ * within 25% of its neighbor from 1 microsecond up to several seconds, using a constant amount
+ * of memory.  The minimum and maximum are tracked exactly; the 50th and 99th percentiles are
+ * reported as the upper edge of the bucket that contains them.
+ *
+ * The profiler is disabled after begin() and costs one test of a flag per start()/stop() call
+ * while disabled.  It is enabled and reset from the cloud.  format() writes a summary of the
+ * form "phase:min/p50/p99/max,..." (all in microseconds) for a cloud variable.
+ *
+ * Stall monitoring:  after setStallMonitor(), the phases are timed whether or not profiling is
+ * enabled, and a phase that takes longer than the budget is reported to a WLDForensics (see
+ * WLDForensics.h) as a stall of that phase, as are a time between loop() calls longer than the
+ * budget (as the gap phase), a water sample that comes more than the budget after it was due (as
+ * the interval phase), and a loop() longer than the budget that no phase of it accounts for (as
+ * the loop phase).  currentPhase() is the phase in progress, for a watchdog that fires while a
+ * phase never ends.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Added the publish phase
+ * version 1.2: 10/17/26.  Added the idle phase
+ * version 1.3: 10/17/26.  The nominal sample interval can be changed, for adaptive sampling
+ * version 1.4: 10/17/26.  Added stall monitoring and the config phase
+ *
+ *******************************************************************************/
+#ifndef wldlp
+#define wldlp
+
+#include "application.h"
+#include <WLDHal.h>
+
+class WLDForensics;
+
+// The phases of loop() that are measured
+enum WLDLoopPhase {
+    PHASE_LOOP = 0,         // the whole of loop()
+    PHASE_GAP,              // time spent outside of loop() (system and cloud processing)
+    PHASE_DHT,              // DHT polling and processing of a new temperature/humidity reading
+    PHASE_WATER,            // reading the water sensors and integrating the readings
+    PHASE_ALARMS,           // alarm processing by the WLDAlarmProcessor
+    PHASE_STATUS,           // writing the alarm status string
+    PHASE_OUTPUTS,          // push button, indicator and buzzer refresh
+    PHASE_PUBLISH,          // publishing a queued event to the cloud
+    PHASE_IDLE,             // waiting for the next scheduled task
+    PHASE_SAMPLE_INTERVAL,  // actual time between water sensor samples
+    PHASE_SAMPLE_JITTER,    // deviation of the sample interval from the nominal interval
+    PHASE_CONFIG,           // writing the settings to EEPROM
+    NUM_LOOP_PHASES
+};
+
+class WLDLoopProfiler  {
+    private:
+        // Constants
+        static const int SUB_BUCKET_BITS = 2;                       // 4 buckets per power of two
+        static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static const int MAX_POWER = 22;                            // 2^22 us (about 4 seconds) and above share the last bucket
+        static const int NUM_BUCKETS = (MAX_POWER - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+        // Variables
+        WLDHal *_hal;
+        bool _enabled;
+        uint32_t _counts[NUM_LOOP_PHASES][NUM_BUCKETS];     // histogram of each phase
+        uint32_t _total[NUM_LOOP_PHASES];                   // number of recorded durations of each phase
+        uint32_t _min[NUM_LOOP_PHASES];                     // shortest recorded duration
+        uint32_t _max[NUM_LOOP_PHASES];                     // longest recorded duration
+        unsigned long _start[NUM_LOOP_PHASES];              // start time of a phase in progress
+        unsigned long _nominalInterval;                     // nominal sample interval in microseconds
+        unsigned long _lastSample;                          // time of the last water sample
+        bool _haveLastSample;
+        unsigned long _loopEnd;                             // time that the last loop() returned
+        bool _haveLoopEnd;
+
+        // Stall monitoring
+        WLDForensics *_forensics;                           // stalls are reported here, or NULL
+        uint8_t _thread;                                    // WLDForensicsThread of the stalls
+        uint32_t _budget;                                   // microseconds
+        bool _timing;                                       // profiling or stall monitoring
+        int _current;                                       // phase in progress
+        int _outside;                                       // phase in progress outside of start()/stop()
+        bool _stalled;                                      // a stall has been reported during this loop()
+
+        // Private methods (internal use only)
+        static int bucketOf(uint32_t microseconds);
+        static uint32_t bucketUpperEdge(int bucket);
+        uint32_t percentile(int phase, int percent);
+        void checkStall(int phase, uint32_t microseconds);
+
+    public:
+        // Constructor
+        WLDLoopProfiler();
+
+        // Initialization
+        void begin(WLDHal *hal, unsigned long nominalSampleIntervalMs);
+        void setSampleInterval(unsigned long nominalSampleIntervalMs) { _nominalInterval = nominalSampleIntervalMs * 1000UL; }
+
+        // Stall monitoring, by "thread" (a WLDForensicsThread), of phases longer than budget microseconds
+        void setStallMonitor(WLDForensics *forensics, uint8_t thread, uint32_t budget);
+        int currentPhase() { return _current; }
+
+        // Control
+        void enable(bool on);
+        bool enabled() { return _enabled; }
+        void reset();
+
+        // Measurement
+        inline void beginLoop() {
+            if(_timing) {
+                unsigned long now = _hal->micros();
+                if(_haveLoopEnd) {
+                    record(PHASE_GAP, now - _loopEnd);
+                    checkStall(PHASE_GAP, now - _loopEnd);
+                }
+                _start[PHASE_LOOP] = now;
+                _current = _outside = PHASE_LOOP;
+                _stalled = false;
+            }
+        }
+        inline void endLoop() {
+            if(_timing) {
+                _loopEnd = _hal->micros();
+                _haveLoopEnd = true;
+                record(PHASE_LOOP, _loopEnd - _start[PHASE_LOOP]);
+                if(_stalled == false) {
+                    checkStall(PHASE_LOOP, _loopEnd - _start[PHASE_LOOP]);
+                }
+                _current = _outside = PHASE_GAP;
+            }
+        }
+        inline void beginIdle() {
+            if(_timing) {
+                _start[PHASE_IDLE] = _hal->micros();
+                _current = PHASE_IDLE;
+            }
+        }
+        inline void endIdle() {
+            if(_timing) {
+                unsigned long now = _hal->micros();
+                record(PHASE_IDLE, now - _start[PHASE_IDLE]);
+                _loopEnd = now;     // the gap to the next loop() starts after the wait
+                _current = _outside;
+            }
+        }
+        inline void start(int phase) {
+            if(_timing) {
+                _start[phase] = _hal->micros();
+                _current = phase;
+            }
+        }
+        inline void stop(int phase) {
+            if(_timing) {
+                uint32_t microseconds = _hal->micros() - _start[phase];
+                record(phase, microseconds);
+                checkStall(phase, microseconds);
+                _current = _outside;
+            }
+        }
+        void record(int phase, uint32_t microseconds);
+        void markSample();
+
+        // Reporting
+        size_t format(char *buffer, size_t size);
+        static const char *phaseName(int phase);
+};
+
+#endif
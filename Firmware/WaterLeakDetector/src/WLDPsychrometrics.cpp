@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * WLDPsychrometrics:  dew point and heat index in integer arithmetic
+ *
+ * See WLDPsychrometrics.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include <WLDPsychrometrics.h>
+
+// Constants
+
+// log2(1 + i/32), i = 0..32, with 16 fractional bits
+static const uint32_t LOG2_TABLE[33] = {
+        0,  2909,  5732,  8473, 11136, 13727, 16248, 18704, 21098, 23433, 25711,
+    27936, 30109, 32234, 34312, 36346, 38336, 40286, 42196, 44068, 45904, 47705,
+    49472, 51207, 52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047, 65536
+};
+static const int32_t LOG2_100_PERCENT = 959700;     // log2(intToFixed(100)), 16 fractional bits
+static const int32_t LN_2 = 45426;                  // ln(2), 16 fractional bits
+
+// Magnus formula, as in PietteTech_DHT::getDewPoint()
+static const int64_t MAGNUS_A = 1131872;            // 17.271, 16 fractional bits
+static const int64_t MAGNUS_B = 60851;              // 237.7 degrees C, 8 fractional bits
+
+// Rothfusz regression in degrees C, as in PietteTech_DHT::getHeatIndex(), with 32 fractional
+//  bits:  HI = A(T) + RH * (B(T) + RH * C(T)), where A, B and C are quadratics in T
+static const int64_t HI_A0 = -37729976680LL;        // -8.78469475556
+static const int64_t HI_A1 = 6920885003LL;          //  1.61139411 * T
+static const int64_t HI_A2 = -52862861LL;           // -0.012308094 * T^2
+static const int64_t HI_B0 = 10043990783LL;         //  2.33854883889 * RH
+static const int64_t HI_B1 = -627563656LL;          // -0.14611605 * T * RH
+static const int64_t HI_B2 = 9499317LL;             //  0.002211732 * T^2 * RH
+static const int64_t HI_C0 = -70544098LL;           // -0.0164248277778 * RH^2
+static const int64_t HI_C1 = 3115827LL;             //  0.00072546 * T * RH^2
+static const int64_t HI_C2 = -15385LL;              // -0.000003582 * T^2 * RH^2
+
+// Private functions (internal use only)
+
+// log2 of a positive integer, with 16 fractional bits
+static int32_t log2Fixed(uint32_t value) {
+    int exponent = 31 - __builtin_clz(value);
+    uint32_t mantissa = value << (31 - exponent);   // leading 1 in bit 31
+    int index = (mantissa >> 26) & 0x1f;            // next 5 bits select the table interval
+    uint32_t fraction = (mantissa >> 10) & 0xffff;  // and the next 16 interpolate within it
+
+    return (exponent << 16) + LOG2_TABLE[index] +
+        (int32_t)(((LOG2_TABLE[index + 1] - LOG2_TABLE[index]) * fraction) >> 16);
+}
+
+// a / b rounded to the nearest integer, for b > 0
+static int32_t divideRounded(int32_t a, int32_t b) {
+    return (a >= 0) ? (a + b / 2) / b : (a - b / 2) / b;
+}
+
+// degrees F to degrees C and back, in fixed point
+static fixed_t fahrenheitToCelsius(fixed_t fahrenheit) {
+    return divideRounded((fahrenheit - intToFixed(32)) * 5, 9);
+}
+
+static fixed_t celsiusToFahrenheit(fixed_t celsius) {
+    return divideRounded(celsius * 9, 5) + intToFixed(32);
+}
+
+// evaluate p0 + p1 * x + p2 * x^2, where the coefficients have 32 fractional bits and x is
+//  fixed point; the result has 32 fractional bits
+static int64_t quadratic(int64_t p0, int64_t p1, int64_t p2, fixed_t x) {
+    int64_t result = p2;
+
+    result = ((result * x) >> FIXED_FRACTION_BITS) + p1;
+    return ((result * x) >> FIXED_FRACTION_BITS) + p0;
+}
+
+static fixed_t limitHumidity(fixed_t humidity) {
+    if(humidity < intToFixed(1)) {
+        return intToFixed(1);
+    }
+    if(humidity > intToFixed(100)) {
+        return intToFixed(100);
+    }
+    return humidity;
+}
+
+// Public functions
+
+fixed_t dewPoint(fixed_t temperature, fixed_t humidity) {
+    fixed_t celsius = fahrenheitToCelsius(temperature);
+
+    // gamma = ln(RH / 100) + a * T / (b + T), with 16 fractional bits
+    int64_t lnHumidity = ((int64_t)(log2Fixed(limitHumidity(humidity)) - LOG2_100_PERCENT) * LN_2) >> 16;
+    int64_t gamma = lnHumidity + (MAGNUS_A * celsius) / (MAGNUS_B + celsius);
+
+    // dew point = b * gamma / (a - gamma)
+    fixed_t dewPointCelsius = (fixed_t)((MAGNUS_B * gamma) / (MAGNUS_A - gamma));
+    return celsiusToFahrenheit(dewPointCelsius);
+}   // end of dewPoint()
+
+fixed_t heatIndex(fixed_t temperature, fixed_t humidity) {
+    fixed_t celsius = fahrenheitToCelsius(temperature);
+    fixed_t rh = limitHumidity(humidity);
+
+    int64_t a = quadratic(HI_A0, HI_A1, HI_A2, celsius);
+    int64_t b = quadratic(HI_B0, HI_B1, HI_B2, celsius);
+    int64_t c = quadratic(HI_C0, HI_C1, HI_C2, celsius);
+
+    int64_t result = ((c * rh) >> FIXED_FRACTION_BITS) + b;
+    result = ((result * rh) >> FIXED_FRACTION_BITS) + a;
+
+    // 32 to FIXED_FRACTION_BITS fractional bits, rounded
+    fixed_t heatIndexCelsius = (fixed_t)((result + (1LL << (31 - FIXED_FRACTION_BITS))) >> (32 - FIXED_FRACTION_BITS));
+    return celsiusToFahrenheit(heatIndexCelsius);
+}   // end of heatIndex()
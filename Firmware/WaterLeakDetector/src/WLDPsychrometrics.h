@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * WLDPsychrometrics:  dew point and heat index in integer arithmetic
+ *
+ * PietteTech_DHT computes the dew point and heat index in double precision with log(), log10()
+ * and pow(), which the Photon (no floating point unit) runs as software library calls.  These
+ * functions compute the same quantities from the WLD firmware's fixed-point temperature
+ * (degrees F) and humidity (%RH), using integer arithmetic only, so they can be computed for
+ * every zone on every reading:
+ *
+ * - dewPoint() uses the same Magnus formula as PietteTech_DHT::getDewPoint() (a = 17.271,
+ * b = 237.7 degrees C).  The natural log of the humidity comes from a 33 entry table of
+ * log2(1 + i/32), interpolated linearly, and the normalizing shift of the humidity.
+ *
+ * - heatIndex() evaluates the same Rothfusz regression as PietteTech_DHT::getHeatIndex(), in
+ * degrees C, with the coefficients in 32 bit fixed point and the polynomial factored for
+ * Horner evaluation, then converts the result to degrees F.  Like getHeatIndex(), it applies the
+ * regression at every temperature and humidity, although it is only meaningful above about
+ * 80 F and 40 %RH.
+ *
+ * Humidity is limited to 1..100 %RH (the dew point is undefined at 0 %RH).
+ *
+ * Maximum error against the PietteTech_DHT double precision functions, for every DHT22 reading
+ * (0.1 C and 0.1 %RH steps) over 1..100 %RH and the DHT11 range (0..50 C) / the DHT22 range
+ * (-40..80 C), as checked by test/PsychrometricsTest.cpp:
+ *      dewPoint()      0.04 F / 0.05 F     against getDewPoint()
+ *                      0.42 F / 0.64 F     against getDewPointSlow() (NOAA); this is the
+ *                                          error of the Magnus formula itself
+ *      heatIndex()     0.07 F / 0.13 F     against getHeatIndex(); the largest errors are at
+ *                                          high temperature and humidity, where the heat
+ *                                          index is hundreds of degrees
+ * That is well below the 1 degree and 1 %RH resolution of the DHT11.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Corrected the maximum errors, as measured by test/PsychrometricsTest.cpp
+ *
+ *******************************************************************************/
+#ifndef wldpsy
+#define wldpsy
+
+#include "application.h"
+#include <WLDFixedPoint.h>
+
+// dew point (degrees F) of air at "temperature" (degrees F) and "humidity" (%RH)
+fixed_t dewPoint(fixed_t temperature, fixed_t humidity);
+
+// heat index (apparent temperature, degrees F) at "temperature" (degrees F) and "humidity" (%RH)
+fixed_t heatIndex(fixed_t temperature, fixed_t humidity);
+
+#endif
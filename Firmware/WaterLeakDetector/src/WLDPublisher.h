@@ -0,0 +1,29 @@
+/*******************************************************************************
+ * WLDPublisher:  interface to whatever delivers WLD events to the cloud
+ *
+ * The WLDEventQueue class delivers queued events through a WLDPublisher.  On the device the
+ * publisher is the WLDHalPhoton object, which forwards to Particle.publish().  Any other class that
+ * implements this interface (for example a mock that records events locally, or that refuses
+ * events to simulate a cloud outage) can be given to the queue instead.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#ifndef wldpub
+#define wldpub
+
+class WLDPublisher  {
+    public:
+        virtual ~WLDPublisher() {}
+
+        // true if events can be published right now
+        virtual bool cloudConnected() = 0;
+
+        // publish one event; returns true if the event was delivered
+        virtual bool publish(const char *eventName, const char *eventData) = 0;
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * WLDScheduler:  cooperative scheduler of periodic tasks for the WLD loop()
+ *
+ * See WLDScheduler.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  A task can change its own period
+ *
+ *******************************************************************************/
+#include <WLDScheduler.h>
+
+// Constructor
+WLDScheduler::WLDScheduler() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDScheduler::begin(WLDHal *hal) {
+    _hal = hal;
+    _numTasks = 0;
+    _nextDeadline = _hal->millis();
+    _overruns = 0;
+}   // end of begin()
+
+// register a task to be run every "period" milliseconds, the first time after "firstDelay"
+int WLDScheduler::addTask(WLDTaskFunction function, unsigned long period, unsigned long firstDelay) {
+    if(_numTasks >= MAX_TASKS) {
+        return -1;
+    }
+
+    Task *task = &_tasks[_numTasks];
+    task->function = function;
+    task->period = period;
+    task->deadline = _hal->millis() + firstDelay;
+    if(_numTasks == 0 || timeReached(_nextDeadline, task->deadline)) {
+        _nextDeadline = task->deadline;
+    }
+    return _numTasks++;
+}   // end of addTask()
+
+// change the period of a task; the next run is one new period after the last run
+void WLDScheduler::setPeriod(int task, unsigned long period) {
+    if(task < 0 || task >= _numTasks) {
+        return;
+    }
+    _tasks[task].deadline = _tasks[task].deadline - _tasks[task].period + period;
+    _tasks[task].period = period;
+    if(timeReached(_nextDeadline, _tasks[task].deadline)) {
+        _nextDeadline = _tasks[task].deadline;
+    }
+}   // end of setPeriod()
+
+// run every task whose deadline has been reached, and find the next deadline
+void WLDScheduler::run() {
+    unsigned long now = _hal->millis();
+    bool first = true;
+
+    for(int i = 0; i < _numTasks; i++) {
+        Task *task = &_tasks[i];
+
+        if(timeReached(now, task->deadline)) {
+            task->deadline += task->period;     // keep to the period, without drift
+            if(timeReached(now, task->deadline)) {
+                task->deadline = now + task->period;    // too far behind to catch up
+                _overruns++;
+            }
+            task->function();                   // after its next deadline is set, so it can change its period
+        }
+
+        if(first == true || timeReached(_nextDeadline, task->deadline)) {
+            _nextDeadline = task->deadline;
+            first = false;
+        }
+    }
+}   // end of run()
+
+// milliseconds until the next task is due; 0 if a task is already due
+unsigned long WLDScheduler::timeToNextDeadline() {
+    unsigned long now = _hal->millis();
+
+    if(timeReached(now, _nextDeadline)) {
+        return 0;
+    }
+    return _nextDeadline - now;
+}   // end of timeToNextDeadline()
+
+// wait until the next task is due, but no longer than maxIdle milliseconds
+void WLDScheduler::idle(unsigned long maxIdle) {
+    unsigned long wait = timeToNextDeadline();
+
+    if(wait > maxIdle) {
+        wait = maxIdle;
+    }
+    if(wait > 0) {
+        _hal->delay(wait);
+    }
+}   // end of idle()
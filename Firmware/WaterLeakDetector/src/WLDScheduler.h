@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * WLDScheduler:  cooperative scheduler of periodic tasks for the WLD loop()
+ *
+ * Each periodic job of the WLD firmware (reading the water sensors, starting and polling a DHT
+ * reading, reading the switches, flashing the indicator, ...) is a task: a function with no
+ * arguments that is registered with addTask() together with its period in milliseconds.  A task
+ * does not keep its own timer; the scheduler keeps one deadline per task.
+ *
+ * loop() calls run() once per pass.  run() reads the time once, calls every task whose deadline
+ * has been reached, in the order the tasks were added, and moves each deadline forward by exactly
+ * one period, so the period does not drift by the time it took to get around to the task.  A
+ * task that has fallen more than one period behind is rescheduled one period from now instead of
+ * being run several times in a row; each such skip is counted as an overrun.  run() also finds
+ * the earliest deadline of all tasks, so loop() can then call idle() to wait until that deadline
+ * instead of spinning.  idle() waits with the HAL's delay(), which keeps the cloud connection
+ * serviced meanwhile.
+ *
+ * setPeriod() changes the period of a task; the next run is one new period after the last run.  A
+ * task may change its own period while it runs (run() sets the next deadline before calling the
+ * task), which is how the water sensor task switches between slow and fast sampling.
+ *
+ * There are only a handful of tasks, so the deadlines are kept in a small array that run()
+ * scans; all times are compared with the wrap-safe functions in WLDTime.h.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  A task can change its own period
+ *
+ *******************************************************************************/
+#ifndef wldsched
+#define wldsched
+
+#include "application.h"
+#include <WLDHal.h>
+#include <WLDTime.h>
+
+typedef void (*WLDTaskFunction)();
+
+class WLDScheduler  {
+    public:
+        // Constants
+        static const int MAX_TASKS = 12;
+
+    private:
+        // One registered task
+        struct Task {
+            WLDTaskFunction function;
+            unsigned long period;       // milliseconds between runs
+            unsigned long deadline;     // time of the next run
+        };
+
+        // Variables
+        WLDHal *_hal;
+        Task _tasks[MAX_TASKS];
+        int _numTasks;
+        unsigned long _nextDeadline;    // earliest deadline of all tasks, as of the last run()
+        uint32_t _overruns;             // runs skipped because a task fell more than a period behind
+
+    public:
+        // Constructor
+        WLDScheduler();
+
+        // Initialization
+        void begin(WLDHal *hal);
+        int addTask(WLDTaskFunction function, unsigned long period, unsigned long firstDelay = 0);  // returns the task number, or -1
+        void setPeriod(int task, unsigned long period);
+        unsigned long period(int task) { return _tasks[task].period; }
+
+        // Running tasks
+        void run();                                 // run every task that is due
+        unsigned long timeToNextDeadline();         // milliseconds until the next task is due
+        void idle(unsigned long maxIdle);           // wait until the next task is due, at most maxIdle
+
+        // Status
+        int numTasks() { return _numTasks; }
+        uint32_t overruns() { return _overruns; }
+};
+
+#endif
@@ -0,0 +1,157 @@
+/*******************************************************************************
+ * WLDSensorBus:  class to read any number of DHT temperature/humidity sensors, one per zone
+ *
+ * See WLDSensorBus.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Retry a failed zone sooner; format() the DHT timing statistics
+ * version 1.2: 10/17/26.  Use the PietteTech_DHT_T driver without the edge timing log
+ * version 1.3: 10/17/26.  Added dewPoint() and heatIndex()
+ * version 1.4: 10/17/26.  Keep the last good reading of each zone, unsmoothed
+ *
+ *******************************************************************************/
+#include <WLDSensorBus.h>
+
+// Constructor
+WLDSensorBus::WLDSensorBus() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDSensorBus::begin(WLDHal *hal, const WLDDhtZone *zones, int numZones, unsigned long sampleInterval) {
+    unsigned long now;
+
+    _hal = hal;
+    _numZones = (numZones > MAX_ZONES) ? MAX_ZONES : numZones;
+    _interval = (sampleInterval < MIN_READ_INTERVAL) ? MIN_READ_INTERVAL : sampleInterval;
+    _active = -1;
+    _lastZone = _numZones - 1;      // so that zone 0 is read first
+    _acquisitions = 0;
+    _failures = 0;
+
+    now = _hal->millis();
+    for(int zone = 0; zone < _numZones; zone++) {
+        _sensors[zone].begin(zones[zone].pin, zones[zone].type);
+
+        // spread the readings of the zones evenly over the interval
+        _nextRead[zone] = now + SETTLE_TIME + zone * (_interval / _numZones);
+        _temperature[zone] = 0;
+        _humidity[zone] = 0;
+        _lastTemperature[zone] = 0;
+        _lastHumidity[zone] = 0;
+        _readings[zone] = 0;
+        _errors[zone] = 0;
+        _status[zone] = DHTLIB_ERROR_NOTSTARTED;
+    }
+}   // end of begin()
+
+// finish the reading in progress, if it is done, and start the next reading that is due
+uint8_t WLDSensorBus::poll() {
+    unsigned long now = _hal->millis();
+    uint8_t completed = 0;
+
+    if(_active >= 0) {
+        if(_sensors[_active].acquiring() == true) {     // also moves the start pulse along
+            if(timeSince(now, _activeStart) < ACQUIRE_TIMEOUT) {
+                return 0;   // still reading; the bus is busy
+            }
+            _sensors[_active].abort();
+        }
+        finish(_active);
+        if(_status[_active] != DHTLIB_OK) {
+            _nextRead[_active] = now + MIN_READ_INTERVAL;   // retry sooner
+        }
+        completed = 1 << _active;
+        _active = -1;
+    }
+
+    // start the next zone that is due, taking the zones in turn
+    for(int i = 1; i <= _numZones; i++) {
+        int zone = (_lastZone + i) % _numZones;
+
+        if(timeReached(now, _nextRead[zone])) {
+            _nextRead[zone] += _interval;
+            if(timeReached(now, _nextRead[zone])) {
+                _nextRead[zone] = now + _interval;  // too far behind to catch up
+            }
+            _lastZone = zone;
+            if(_sensors[zone].acquire() == DHTLIB_ACQUIRING) {
+                _active = zone;
+                _activeStart = now;
+                _acquisitions++;
+            }
+            break;
+        }
+    }
+    return completed;
+}   // end of poll()
+
+// write the DHT timing statistics of all zones:  for each zone the good readings, the
+// counts of error codes -1 to -7, the learned 1 threshold and data and response windows
+// (microseconds) and the non-zero edge time histogram buckets (lower edge:count)
+void WLDSensorBus::format(char *buffer, int size) {
+    uint32_t histogram[DHT_HISTOGRAM_BUCKETS];
+    int length = 0;
+
+    buffer[0] = 0;
+    for(int zone = 0; zone < _numZones && length < size; zone++) {
+        Sensor *dht = &_sensors[zone];
+
+        length += snprintf(buffer + length, size - length, "%sz%d ok %lu err", (zone > 0) ? "; " : "",
+            zone, (unsigned long)dht->getOkCount());
+        for(int code = -1; code >= -DHTLIB_NUM_ERRORS && length < size; code--) {
+            length += snprintf(buffer + length, size - length, "%c%lu", (code == -1) ? ' ' : '/',
+                (unsigned long)dht->getErrorCount(code));
+        }
+        if(length >= size) {
+            break;
+        }
+        length += snprintf(buffer + length, size - length, " 1>%d d%d-%d r%d-%d h", dht->getOneThreshold(),
+            dht->getDataMin(), dht->getDataMax(), dht->getResponseMin(), dht->getResponseMax());
+
+        dht->getEdgeHistogram(histogram);
+        for(int i = 0; i < DHT_HISTOGRAM_BUCKETS && length < size; i++) {
+            if(histogram[i] != 0) {
+                length += snprintf(buffer + length, size - length, " %d:%lu", i * DHT_HISTOGRAM_BUCKET_US,
+                    (unsigned long)histogram[i]);
+            }
+        }
+    }
+}   // end of format()
+
+// private methods
+
+// take the result of a finished reading into the zone's smoothed values
+void WLDSensorBus::finish(int zone) {
+    int status = _sensors[zone].getStatus();
+
+    _status[zone] = status;
+    if(status != DHTLIB_OK) {
+        _failures++;
+        if(_errors[zone] < 0xffff) {
+            _errors[zone]++;
+        }
+        return;
+    }
+
+    fixed_t currentTemp = floatToFixed(_sensors[zone].getFahrenheit());
+    fixed_t currentHumidity = floatToFixed(_sensors[zone].getHumidity());
+
+    _lastTemperature[zone] = currentTemp;
+    _lastHumidity[zone] = currentHumidity;
+
+    if(_readings[zone] == 0) {  // first time init
+        _temperature[zone] = currentTemp;
+        _humidity[zone] = currentHumidity;
+    }
+
+    // 10 point moving average: smoothed = 0.9 * smoothed + 0.1 * current, in fixed point
+    _temperature[zone] += (currentTemp - _temperature[zone]) / 10;
+    _humidity[zone] += (currentHumidity - _humidity[zone]) / 10;
+
+    _readings[zone]++;
+    _errors[zone] = 0;
+}   // end of finish()
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * WLDSensorBus:  class to read any number of DHT temperature/humidity sensors, one per zone
+ *
+ * Each zone (room) has its own DHT11/21/22 sensor on its own interrupt capable pin, listed in a
+ * table of WLDDhtZone entries given to begin().  The WLDSensorBus owns one DHT driver object per
+ * zone and coordinates their readings:
+ *
+ * - Only one sensor is read at a time, so the edge interrupts of two sensors never overlap and
+ * each ISR sees undisturbed timing.
+ * - Each zone is read once per sample interval (never more often than the 2 second minimum of
+ * the DHT sensors).  The first reading of each zone is offset by 1/N of the interval, so the N
+ * readings are spread evenly over the interval instead of queueing behind each other.
+ * - A sensor that does not complete its reading within ACQUIRE_TIMEOUT is abandoned with an error
+ * so that it cannot hold up the other zones.
+ *
+ * The WLD firmware calls poll() frequently (every few tens of milliseconds).  poll() never
+ * blocks: each call ends a completed or timed out reading, if any, and starts the next reading
+ * that is due, if any.  poll() returns a bit mask of the zones whose reading completed during the
+ * call, successfully or not.
+ *
+ * For each zone the bus keeps the smoothed temperature (degrees F) and humidity (%RH) in fixed
+ * point, using the same 10 point moving average as the WLD firmware always has, along with the
+ * number of good readings, the number of consecutive failed readings and the last status code.
+ * Alarm limits are applied to the smoothed values by the WLD firmware.  The dew point and heat
+ * index of a zone are computed from its smoothed values when asked for, in integer arithmetic
+ * (see WLDPsychrometrics.h).
+ *
+ * A zone whose reading failed is read again after MIN_READ_INTERVAL rather than a full sample
+ * interval.  The DHT driver learns each sensor's bit timing from its good readings and keeps
+ * counts of good readings, of each error code and a histogram of edge times; format() writes
+ * these for all zones as a string for a cloud variable.  The drivers are PietteTech_DHT_T
+ * specialized without the edge timing log that PietteTech_DHT carries, to save its RAM, and with
+ * the DHTStats statistics policy, which keeps these counts for format().
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Retry a failed zone sooner; format() the DHT timing statistics
+ * version 1.2: 10/17/26.  Use the PietteTech_DHT_T driver without the edge timing log
+ * version 1.3: 10/17/26.  Added dewPoint() and heatIndex()
+ * version 1.4: 10/17/26.  Keep the last good reading of each zone, unsmoothed
+ * version 1.5: 10/17/26.  Use the DHTStats statistics policy of PietteTech_DHT 0.0.21
+ *
+ *******************************************************************************/
+#ifndef wldsb
+#define wldsb
+
+#include "application.h"
+#include <PietteTech_DHT.h>
+#include <WLDHal.h>
+#include <WLDFixedPoint.h>
+#include <WLDPsychrometrics.h>
+#include <WLDTime.h>
+
+// Wiring of one zone's sensor
+struct WLDDhtZone {
+    uint8_t pin;                // interrupt capable pin the sensor data line is on
+    uint8_t type;               // DHT11, DHT21 or DHT22
+};
+
+class WLDSensorBus  {
+    public:
+        // Types
+        typedef PietteTech_DHT_T<DHTAnyType, DHTLearnedTiming, DHTNoEdges, DHTStats> Sensor;
+
+        // Constants
+        static const int MAX_ZONES = 4;
+        static const unsigned long MIN_READ_INTERVAL = 2000;    // DHT sensors can't be read more often
+        static const unsigned long SETTLE_TIME = 1000;          // sensors settle after power up
+        static const unsigned long ACQUIRE_TIMEOUT = 200;       // a reading takes about 25 milliseconds
+
+    private:
+        // Variables
+        WLDHal *_hal;
+        Sensor _sensors[MAX_ZONES];
+        int _numZones;
+        unsigned long _interval;                // time between readings of one zone
+        int _active;                            // zone being read, or -1
+        int _lastZone;                          // zone that was read last
+        unsigned long _activeStart;             // time the active reading was started
+
+        // Per-zone state
+        unsigned long _nextRead[MAX_ZONES];     // time the next reading of the zone is due
+        fixed_t _temperature[MAX_ZONES];        // smoothed temperature, degrees F
+        fixed_t _humidity[MAX_ZONES];           // smoothed humidity, %RH
+        fixed_t _lastTemperature[MAX_ZONES];    // last good reading, unsmoothed
+        fixed_t _lastHumidity[MAX_ZONES];
+        uint32_t _readings[MAX_ZONES];          // number of good readings
+        uint16_t _errors[MAX_ZONES];            // consecutive failed readings
+        int8_t _status[MAX_ZONES];              // status code of the last reading
+
+        // Counters
+        uint32_t _acquisitions;
+        uint32_t _failures;
+
+        // Private methods (internal use only)
+        void finish(int zone);
+
+    public:
+        // Constructor
+        WLDSensorBus();
+
+        // Initialization
+        void begin(WLDHal *hal, const WLDDhtZone *zones, int numZones, unsigned long sampleInterval);
+
+        // Sampling
+        uint8_t poll();         // returns a bit mask of the zones whose reading completed
+
+        // Readings
+        int numZones() { return _numZones; }
+        fixed_t temperature(int zone) { return _temperature[zone]; }
+        fixed_t humidity(int zone) { return _humidity[zone]; }
+        fixed_t lastTemperature(int zone) { return _lastTemperature[zone]; }
+        fixed_t lastHumidity(int zone) { return _lastHumidity[zone]; }
+        fixed_t dewPoint(int zone) { return ::dewPoint(_temperature[zone], _humidity[zone]); }
+        fixed_t heatIndex(int zone) { return ::heatIndex(_temperature[zone], _humidity[zone]); }
+        uint32_t readings(int zone) { return _readings[zone]; }
+        int errors(int zone) { return _errors[zone]; }
+        int status(int zone) { return _status[zone]; }
+
+        // Status
+        uint32_t acquisitions() { return _acquisitions; }
+        uint32_t failures() { return _failures; }
+        void format(char *buffer, int size);   // DHT timing statistics of all zones
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * WLDSpscQueue:  lock-free queue from one producer thread to one consumer thread
+ *
+ * The WLD firmware reads the water sensors and drives the indicator and buzzer in a sensing
+ * thread of its own, so that the cloud, publishing and EEPROM work of the application loop()
+ * cannot delay them.  The sensing thread passes what it detects to loop() through a
+ * WLDSpscQueue:  a ring of SIZE items with a head index that only the consumer writes and a tail
+ * index that only the producer writes.
+ *
+ * - push() (producer only) copies an item into the slot at the tail and then advances the tail;
+ * pop() (consumer only) copies the item out of the slot at the head and then advances the head.
+ * Each index is an atomic that is stored with release and loaded with acquire ordering, so the
+ * other thread sees a slot's item before it sees the index that hands the slot over.  Neither
+ * side ever waits for, or locks out, the other, and on the Photon's Cortex-M3 each index is a
+ * plain 32 bit load or store.
+ *
+ * - The indexes count up without wrapping to the size of the ring; the number of items is
+ * tail - head, which is correct across the 32 bit overflow, and SIZE must be a power of two so
+ * that the slot of an index is index % SIZE across the overflow too.
+ *
+ * - A push() onto a full queue fails and is counted as an overflow; the item is not queued.  The
+ * producer decides what to do about it (the water sensing thread tries again at its next reading).
+ *
+ * Items are copied by value, so they should be small, plain structs.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#ifndef wldspsc
+#define wldspsc
+
+#include "application.h"
+#include <atomic>
+
+template <typename T, int SIZE>
+class WLDSpscQueue  {
+    static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+    private:
+        // Variables
+        T _items[SIZE];
+        std::atomic<uint32_t> _head;    // index of the oldest item; written by the consumer only
+        std::atomic<uint32_t> _tail;    // index of the next free slot; written by the producer only
+        uint32_t _overflows;            // failed push()es; written by the producer only
+
+    public:
+        // Constructor
+        WLDSpscQueue() {
+            // follow convention and put all initializations in begin() method
+        }   // end of Constructor
+
+        // Initialization, before either thread uses the queue
+        void begin() {
+            _head.store(0, std::memory_order_relaxed);
+            _tail.store(0, std::memory_order_relaxed);
+            _overflows = 0;
+        }   // end of begin()
+
+        // Producer:  add an item; false (and counted as an overflow) if the queue is full
+        bool push(const T &item) {
+            uint32_t tail = _tail.load(std::memory_order_relaxed);
+
+            if(tail - _head.load(std::memory_order_acquire) >= (uint32_t)SIZE) {
+                _overflows++;
+                return false;
+            }
+            _items[tail % SIZE] = item;
+            _tail.store(tail + 1, std::memory_order_release);   // hand the slot to the consumer
+            return true;
+        }   // end of push()
+
+        // Consumer:  remove the oldest item into "item"; false if the queue is empty
+        bool pop(T *item) {
+            uint32_t head = _head.load(std::memory_order_relaxed);
+
+            if(head == _tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+            *item = _items[head % SIZE];
+            _head.store(head + 1, std::memory_order_release);   // hand the slot back to the producer
+            return true;
+        }   // end of pop()
+
+        // Status; from either thread, a snapshot that may already have changed
+        int count() {
+            uint32_t head = _head.load(std::memory_order_acquire);    // first, so that the tail is not behind it
+            return (int)(_tail.load(std::memory_order_acquire) - head);
+        }
+        uint32_t overflows() { return _overflows; }
+};
+
+#endif
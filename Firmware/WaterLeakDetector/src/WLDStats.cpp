@@ -0,0 +1,296 @@
+/*******************************************************************************
+ * WLDStats:  rolling statistics of a temperature or humidity over several time windows
+ *
+ * See WLDStats.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include <WLDStats.h>
+
+const unsigned long MILLIS_PER_HOUR = 3600000;
+
+// windows of a WLDStats, and their names in format()
+const unsigned long WINDOW_TIMES[WLDStats::NUM_WINDOWS] = { 60000, MILLIS_PER_HOUR, 24 * MILLIS_PER_HOUR };
+const char *WINDOW_NAMES[WLDStats::NUM_WINDOWS] = { "1m", "1h", "1d" };
+
+// integer square root (the largest r with r * r <= value)
+static uint32_t squareRoot(uint64_t value) {
+    uint64_t root = 0;
+
+    for(uint64_t bit = (uint64_t)1 << 62; bit != 0; bit >>= 2) {
+        if(value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+    }
+    return (uint32_t)root;
+}   // end of squareRoot()
+
+// WLDWindowStats
+
+// Constructor
+WLDWindowStats::WLDWindowStats() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDWindowStats::begin(unsigned long window, unsigned long now) {
+    _slotTime = window / SLOTS;
+    _slotStart = now;
+    clear();
+}   // end of begin()
+
+// drop the slots that are now out of the window, starting a new slot for each slot time that
+//  has passed
+void WLDWindowStats::advance(unsigned long now) {
+    unsigned long elapsed = timeSince(now, _slotStart);
+
+    if(elapsed >= _slotTime * SLOTS) {     // every slot is out of the window
+        clear();
+        _slotStart = now - elapsed % _slotTime;
+        return;
+    }
+    while(elapsed >= _slotTime) {
+        nextSlot();
+        elapsed -= _slotTime;
+    }
+}   // end of advance()
+
+void WLDWindowStats::add(fixed_t value, unsigned long now) {
+    advance(now);
+
+    Slot *slot = &_slots[_current];
+    if(slot->count == 0 || value < slot->lowest) {
+        slot->lowest = value;
+    }
+    if(slot->count == 0 || value > slot->highest) {
+        slot->highest = value;
+    }
+    slot->count++;
+    slot->sum += value;
+    slot->sumSquares += (int64_t)value * value;
+
+    _count++;
+    _sum += value;
+    _sumSquares += (int64_t)value * value;
+}   // end of add()
+
+fixed_t WLDWindowStats::lowest() {
+    Slot *slot = &_slots[_current];
+    fixed_t result;
+
+    if(_lowLength > 0) {
+        result = _slots[_lowQueue[_lowFront]].lowest;
+        if(slot->count > 0 && slot->lowest < result) {
+            result = slot->lowest;
+        }
+        return result;
+    }
+    return (slot->count > 0) ? slot->lowest : 0;
+}   // end of lowest()
+
+fixed_t WLDWindowStats::highest() {
+    Slot *slot = &_slots[_current];
+    fixed_t result;
+
+    if(_highLength > 0) {
+        result = _slots[_highQueue[_highFront]].highest;
+        if(slot->count > 0 && slot->highest > result) {
+            result = slot->highest;
+        }
+        return result;
+    }
+    return (slot->count > 0) ? slot->highest : 0;
+}   // end of highest()
+
+fixed_t WLDWindowStats::average() {
+    if(_count == 0) {
+        return 0;
+    }
+    return (fixed_t)(_sum / (int64_t)_count);
+}   // end of average()
+
+// population variance:  (n * sum(x^2) - sum(x)^2) / n^2, in units squared
+fixed_t WLDWindowStats::variance() {
+    if(_count == 0) {
+        return 0;
+    }
+    int64_t n = _count;
+    int64_t squared = (n * _sumSquares - _sum * _sum) / (n * n);     // FIXED_FRACTION_BITS * 2 fraction bits
+    return (fixed_t)(squared >> FIXED_FRACTION_BITS);
+}   // end of variance()
+
+fixed_t WLDWindowStats::deviation() {
+    if(_count == 0) {
+        return 0;
+    }
+    int64_t n = _count;
+    int64_t squared = (n * _sumSquares - _sum * _sum) / (n * n);
+    return (fixed_t)squareRoot((squared > 0) ? squared : 0);
+}   // end of deviation()
+
+// change per hour from the average of the oldest slot that has samples to that of the newest
+fixed_t WLDWindowStats::ratePerHour() {
+    int newest = -1;
+
+    // the newest slot with samples is usually the current slot
+    for(int i = 0; i < SLOTS; i++) {
+        int slot = (_current + SLOTS - i) % SLOTS;
+        if(_slots[slot].count > 0) {
+            newest = slot;
+            break;
+        }
+    }
+    if(newest < 0) {
+        return 0;
+    }
+
+    // look for the oldest slot with samples, from the slot after the current one
+    for(int i = 1; i < SLOTS; i++) {
+        int slot = (_current + i) % SLOTS;
+        if(slot == newest) {
+            return 0;       // only one slot has samples
+        }
+        if(_slots[slot].count > 0) {
+            int slots = (newest + SLOTS - slot) % SLOTS;
+            int64_t change = slotAverage(newest) - slotAverage(slot);
+            return (fixed_t)(change * (int64_t)MILLIS_PER_HOUR / ((int64_t)slots * (int64_t)_slotTime));
+        }
+    }
+    return 0;
+}   // end of ratePerHour()
+
+// private methods
+
+// empty every slot
+void WLDWindowStats::clear() {
+    for(int slot = 0; slot < SLOTS; slot++) {
+        _slots[slot].count = 0;
+        _slots[slot].sum = 0;
+        _slots[slot].sumSquares = 0;
+    }
+    _current = 0;
+    _count = 0;
+    _sum = 0;
+    _sumSquares = 0;
+    _lowFront = 0;
+    _lowLength = 0;
+    _highFront = 0;
+    _highLength = 0;
+}   // end of clear()
+
+// close the current slot and start the next one, dropping the oldest slot from the window
+void WLDWindowStats::nextSlot() {
+    Slot *slot = &_slots[_current];
+
+    // the closed slot joins the back of the monotonic queues, after the slots that it beats leave
+    if(slot->count > 0) {
+        while(_lowLength > 0 &&
+              _slots[_lowQueue[(_lowFront + _lowLength - 1) % SLOTS]].lowest >= slot->lowest) {
+            _lowLength--;
+        }
+        _lowQueue[(_lowFront + _lowLength) % SLOTS] = _current;
+        _lowLength++;
+
+        while(_highLength > 0 &&
+              _slots[_highQueue[(_highFront + _highLength - 1) % SLOTS]].highest <= slot->highest) {
+            _highLength--;
+        }
+        _highQueue[(_highFront + _highLength) % SLOTS] = _current;
+        _highLength++;
+    }
+
+    _current = (_current + 1) % SLOTS;
+    _slotStart += _slotTime;
+
+    // the oldest slot leaves the window and is reused
+    slot = &_slots[_current];
+    if(slot->count > 0) {
+        _count -= slot->count;
+        _sum -= slot->sum;
+        _sumSquares -= slot->sumSquares;
+    }
+    if(_lowLength > 0 && _lowQueue[_lowFront] == _current) {
+        _lowFront = (_lowFront + 1) % SLOTS;
+        _lowLength--;
+    }
+    if(_highLength > 0 && _highQueue[_highFront] == _current) {
+        _highFront = (_highFront + 1) % SLOTS;
+        _highLength--;
+    }
+    slot->count = 0;
+    slot->sum = 0;
+    slot->sumSquares = 0;
+}   // end of nextSlot()
+
+fixed_t WLDWindowStats::slotAverage(int slot) {
+    return (fixed_t)(_slots[slot].sum / _slots[slot].count);
+}   // end of slotAverage()
+
+// WLDStats
+
+// Constructor
+WLDStats::WLDStats() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDStats::begin(unsigned long now) {
+    for(int window = 0; window < NUM_WINDOWS; window++) {
+        _windows[window].begin(WINDOW_TIMES[window], now);
+    }
+}   // end of begin()
+
+void WLDStats::advance(unsigned long now) {
+    for(int window = 0; window < NUM_WINDOWS; window++) {
+        _windows[window].advance(now);
+    }
+}   // end of advance()
+
+void WLDStats::add(fixed_t value, unsigned long now) {
+    for(int window = 0; window < NUM_WINDOWS; window++) {
+        _windows[window].add(value, now);
+    }
+}   // end of add()
+
+// write "name:low/high/average/deviation/rate" for each window, comma separated, with one
+//  decimal place; a window without samples is written as "name:-"
+int WLDStats::format(char *buffer, int size) {
+    fixed_t values[5];
+    char text[16];
+    int length = 0;
+
+    buffer[0] = '\0';
+    for(int window = 0; window < NUM_WINDOWS && length < size; window++) {
+        WLDWindowStats *stats = &_windows[window];
+
+        length += snprintf(buffer + length, size - length, "%s%s:", (window == 0) ? "" : ",",
+                           WINDOW_NAMES[window]);
+        if(stats->count() == 0) {
+            if(length < size) {
+                length += snprintf(buffer + length, size - length, "-");
+            }
+            continue;
+        }
+
+        values[0] = stats->lowest();
+        values[1] = stats->highest();
+        values[2] = stats->average();
+        values[3] = stats->deviation();
+        values[4] = stats->ratePerHour();
+        for(int i = 0; i < 5 && length < size; i++) {
+            const char *t;
+
+            formatFixed(text, sizeof(text), values[i]);
+            for(t = text; *t == ' '; t++);  // skip the padding
+            length += snprintf(buffer + length, size - length, "%s%s", (i == 0) ? "" : "/", t);
+        }
+    }
+    return length;
+}   // end of format()
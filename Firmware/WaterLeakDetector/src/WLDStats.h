@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * WLDStats:  rolling statistics of a temperature or humidity over several time windows
+ *
+ * A WLDWindowStats keeps the lowest, highest and average value, the variance (and standard
+ * deviation) and the rate of change of the samples of the last "window" milliseconds.  The
+ * window is divided into SLOTS equal time slots; each slot holds the count, sum, sum of squares,
+ * lowest and highest value of the samples that arrived during it.  As time passes the oldest
+ * slot is dropped and reused, so the statistics cover between 11/12 and all of the window, in
+ * fixed memory however many samples arrive:
+ *
+ * - The count, sum and sum of squares of the whole window are kept as running totals: a sample
+ * is added to them, and a dropped slot's totals are subtracted from them.  The totals are
+ * integers, so they are exact and the variance n * sum(x^2) - sum(x)^2 has none of the
+ * cancellation error that Welford's update is used to avoid in floating point.
+ * - The lowest and highest values come from two monotonic queues of slot indexes, whose slot
+ * minimums (maximums) increase (decrease) from the front of the queue to its back.  A closing
+ * slot removes the slots from the back of the queue that it beats, then joins the back; a dropped
+ * slot leaves from the front.  The front of the queue is the extreme of the closed slots.
+ * - The rate of change is the difference between the averages of the newest and the oldest slot
+ * that have samples, per hour.
+ *
+ * Adding a sample is O(1); starting a new slot is O(1) amortized.  Reading the rate of change
+ * looks for the oldest slot with samples, so it is at worst O(SLOTS); the other results are
+ * O(1).  The variance is exact as long as a window holds fewer than about 65000 samples.
+ *
+ * A WLDStats keeps the statistics of one temperature or humidity over three windows:  the last
+ * minute, the last hour and the last day.  The WLD firmware keeps one for the temperature and
+ * one for the humidity of each zone, adds each good reading, and reports them in the "Stats"
+ * cloud variable.  Values are fixed point (see WLDFixedPoint.h); the rate of change is in units
+ * per hour.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#ifndef wldstats
+#define wldstats
+
+#include "application.h"
+#include <WLDFixedPoint.h>
+#include <WLDTime.h>
+
+class WLDWindowStats  {
+    public:
+        // Constants
+        static const int SLOTS = 12;
+
+    private:
+        // Types
+        struct Slot {
+            int64_t sum;                // of the samples
+            int64_t sumSquares;
+            fixed_t lowest;
+            fixed_t highest;
+            uint16_t count;
+        };
+
+        // Variables
+        Slot _slots[SLOTS];
+        int _current;                   // slot that samples are added to
+        unsigned long _slotTime;        // length of a slot, milliseconds
+        unsigned long _slotStart;       // time the current slot started
+
+        // Totals of the whole window
+        uint32_t _count;
+        int64_t _sum;
+        int64_t _sumSquares;
+
+        // Monotonic queues of closed slots (rings of slot indexes)
+        uint8_t _lowQueue[SLOTS];
+        uint8_t _lowFront;
+        uint8_t _lowLength;
+        uint8_t _highQueue[SLOTS];
+        uint8_t _highFront;
+        uint8_t _highLength;
+
+        // Private methods (internal use only)
+        void clear();
+        void nextSlot();
+        fixed_t slotAverage(int slot);
+
+    public:
+        // Constructor
+        WLDWindowStats();
+
+        // Initialization
+        void begin(unsigned long window, unsigned long now);
+
+        // Sampling
+        void advance(unsigned long now);    // drop the slots that are now out of the window
+        void add(fixed_t value, unsigned long now);
+
+        // Results; all are 0 while the window has no samples
+        unsigned long window() { return _slotTime * SLOTS; }
+        uint32_t count() { return _count; }
+        fixed_t lowest();
+        fixed_t highest();
+        fixed_t average();
+        fixed_t variance();             // units squared
+        fixed_t deviation();            // standard deviation
+        fixed_t ratePerHour();
+};
+
+class WLDStats  {
+    public:
+        // Constants
+        enum {
+            WINDOW_MINUTE = 0,
+            WINDOW_HOUR,
+            WINDOW_DAY,
+            NUM_WINDOWS
+        };
+
+    private:
+        // Variables
+        WLDWindowStats _windows[NUM_WINDOWS];
+
+    public:
+        // Constructor
+        WLDStats();
+
+        // Initialization
+        void begin(unsigned long now);
+
+        // Sampling
+        void advance(unsigned long now);
+        void add(fixed_t value, unsigned long now);
+
+        // Results
+        WLDWindowStats *window(int window) { return &_windows[window]; }
+        int format(char *buffer, int size);     // "1m:low/high/average/deviation/rate,1h:...,1d:..."
+};
+
+#endif
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * WLDTelemetry:  batched, delta encoded history of the WLD readings
+ *
+ * See WLDTelemetry.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  The varint encoding is shared with WLDHistory (see WLDVarint.h)
+ *
+ *******************************************************************************/
+#include <WLDTelemetry.h>
+
+// RFC 4648 base64 alphabet
+static const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Constructor
+WLDTelemetry::WLDTelemetry() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDTelemetry::begin(WLDHal *hal, WLDPublisher *publisher, WLDEventQueue *eventQueue, const char *eventName,
+                         int probes, int window) {
+    _hal = hal;
+    _publisher = publisher;
+    _eventQueue = eventQueue;
+    _eventName = eventName;
+    _probes = constrain(probes, 0, TELEMETRY_PROBES);
+    _window = constrain(window, 1, TELEMETRY_SAMPLES);
+
+    _head = 0;
+    _count = 0;
+    _lastFailure = 0;
+    _failed = false;
+
+    _published = 0;
+    _dropped = 0;
+    _failures = 0;
+}   // end of begin()
+
+// add a sample at the current time; when the ring is full, the oldest sample is dropped
+bool WLDTelemetry::add(WLDTelemetrySample *sample) {
+    uint32_t time = _hal->unixTime();
+
+    if(time == 0) {
+        return false;   // a sample is no use without its time
+    }
+    if(_count == TELEMETRY_SAMPLES) {
+        _head = (_head + 1) % TELEMETRY_SAMPLES;
+        _count--;
+        _dropped++;
+    }
+    sample->time = time;
+    _samples[(_head + _count) % TELEMETRY_SAMPLES] = *sample;
+    _count++;
+    return true;
+}   // end of add()
+
+// publish the oldest samples once a window of them is waiting
+void WLDTelemetry::process() {
+    int samples;
+
+    if(_count < _window) {
+        return;
+    }
+    if(_failed == true && (_hal->millis() - _lastFailure) < RETRY_INTERVAL) {
+        return;     // back off after a failed publish
+    }
+    if(_publisher->cloudConnected() == false || _eventQueue->claimToken() == false) {
+        return;
+    }
+
+    base64(_binary, encode(&samples), _data);
+    if(_publisher->publish(_eventName, _data) == true) {
+        _head = (_head + samples) % TELEMETRY_SAMPLES;
+        _count -= samples;
+        _published += samples;
+        _failed = false;
+    } else {
+        _failures++;
+        _failed = true;
+        _lastFailure = _hal->millis();
+    }
+}   // end of process()
+
+// private methods
+
+// encode as many of the oldest samples as fit into one event (see WLDTelemetry.h); returns the length of
+//  the record and the number of samples in it
+int WLDTelemetry::encode(int *samples) {
+    static const WLDTelemetrySample ZERO = {};
+    uint8_t encoded[MAX_SAMPLE_SIZE];
+    const WLDTelemetrySample *previous = &ZERO;
+    int length = 3;     // after the header
+    int count = 0;
+
+    while(count < _count && count < TELEMETRY_SAMPLES) {
+        const WLDTelemetrySample *sample = &_samples[(_head + count) % TELEMETRY_SAMPLES];
+        int size = 0;
+
+        size += putVarint(encoded + size, zigzag((int32_t)(sample->time - previous->time)));
+        size += putVarint(encoded + size, sample->alarms ^ previous->alarms);
+        size += putVarint(encoded + size, sample->leaks ^ previous->leaks);
+        size += putVarint(encoded + size, zigzag(sample->temperature - previous->temperature));
+        size += putVarint(encoded + size, zigzag(sample->humidity - previous->humidity));
+        for(int probe = 0; probe < _probes; probe++) {
+            size += putVarint(encoded + size, zigzag(sample->levels[probe] - previous->levels[probe]));
+        }
+        if(length + size > MAX_BINARY_SIZE) {
+            break;      // the event is full
+        }
+        memcpy(_binary + length, encoded, size);
+        length += size;
+        previous = sample;
+        count++;
+    }
+
+    _binary[0] = TELEMETRY_FORMAT;
+    _binary[1] = _probes;
+    _binary[2] = count;
+    *samples = count;
+    return length;
+}   // end of encode()
+
+// write the base64 of "length" bytes of binary, with padding and a terminating null, into text
+void WLDTelemetry::base64(const uint8_t *binary, int length, char *text) {
+    int i;
+
+    for(i = 0; i + 2 < length; i += 3) {
+        uint32_t group = ((uint32_t)binary[i] << 16) | ((uint32_t)binary[i + 1] << 8) | binary[i + 2];
+        *text++ = BASE64_ALPHABET[(group >> 18) & 0x3f];
+        *text++ = BASE64_ALPHABET[(group >> 12) & 0x3f];
+        *text++ = BASE64_ALPHABET[(group >> 6) & 0x3f];
+        *text++ = BASE64_ALPHABET[group & 0x3f];
+    }
+    if(i < length) {    // one or two bytes left over
+        uint32_t group = (uint32_t)binary[i] << 16;
+        if(i + 1 < length) {
+            group |= (uint32_t)binary[i + 1] << 8;
+        }
+        *text++ = BASE64_ALPHABET[(group >> 18) & 0x3f];
+        *text++ = BASE64_ALPHABET[(group >> 12) & 0x3f];
+        *text++ = (i + 1 < length) ? BASE64_ALPHABET[(group >> 6) & 0x3f] : '=';
+        *text++ = '=';
+    }
+    *text = '\0';
+}   // end of base64()
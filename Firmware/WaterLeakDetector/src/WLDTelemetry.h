@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * WLDTelemetry:  batched, delta encoded history of the WLD readings
+ *
+ * Publishing every reading was given up in 2021 because of the cloud pricing, so the cloud kept no
+ * history at all.  A WLDTelemetry keeps a sample of the readings every minute (or whatever interval
+ * the firmware adds them at) and publishes a whole window of samples as one event, so that a day
+ * of minute by minute history costs a hundred or so publishes instead of 1440:
+ *
+ * - add() puts a WLDTelemetrySample (the Unix time, the alarm conditions, the leaking probes, the
+ * smoothed temperature and humidity in tenths and the level of each water sensor probe in ADC counts)
+ * into a ring of TELEMETRY_SAMPLES.  Samples are only taken once the time has been set from the
+ * cloud.  When the ring is full, the oldest sample is dropped and counted.
+ *
+ * - process() publishes once at least "window" samples are waiting, the cloud is connected and the
+ * event queue gives up a token of the cloud rate limit (see WLDEventQueue::claimToken()), so
+ * queued alarms always go first.  Each publish takes as many of the oldest samples as fit in one
+ * event, and they are removed from the ring only when the publish succeeds; a failed publish is
+ * retried after RETRY_INTERVAL.  After an outage the backlog goes out one event at a time.
+ *
+ * The event data is base64 (RFC 4648, with padding) of a binary record of at most
+ * TELEMETRY_DATA_SIZE - 1 characters, the cloud's limit on event data:
+ *      <format> <probes> <count> <sample> ...
+ * where <format> is 1, <probes> is the number of probe levels in each sample and <count> the
+ * number of samples, one byte each.  Each sample is a series of LEB128 varints (7 bits per byte,
+ * least significant first, the top bit set on all but the last byte; see WLDVarint.h):
+ *      <time> <alarms> <leaks> <temperature> <humidity> <level> ...
+ * Every field is encoded against the same field of the previous sample, and the first sample
+ * against zero:  the alarm bits (bit n for WLDAlarmType n) and the leak bits (bit n for probe n) as
+ * the exclusive or of the two, and the others as the zigzag encoded difference (0, -1, 1, -2, 2 ...
+ * as 0, 1, 2, 3, 4 ...).  So a quiet minute takes a byte per field:  a window of 15 samples of
+ * two probes is about 150 characters, and an hour of them fits in one event.  A temperature and
+ * humidity of TELEMETRY_NO_READING means that there was no good reading yet.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  The varint encoding is shared with WLDHistory (see WLDVarint.h)
+ *
+ *******************************************************************************/
+#ifndef wldtelemetry
+#define wldtelemetry
+
+#include "application.h"
+#include <WLDHal.h>
+#include <WLDPublisher.h>
+#include <WLDEventQueue.h>
+#include <WLDVarint.h>
+
+// Sizes of the telemetry
+const int TELEMETRY_SAMPLES = 60;           // samples kept until they are published; an hour at one a minute
+const int TELEMETRY_PROBES = 8;             // probe levels kept in each sample
+const int TELEMETRY_DATA_SIZE = 621;        // event data, including the terminating null; a multiple of 4 characters
+const int16_t TELEMETRY_NO_READING = -32768;    // temperature and humidity before the first good reading
+
+// One sample of the readings
+struct WLDTelemetrySample {
+    uint32_t time;                          // Unix time
+    uint32_t alarms;                        // bit n is set when the condition of WLDAlarmType n is present
+    uint16_t leaks;                         // bit n is set when water sensor probe n is in alarm
+    int16_t temperature;                    // smoothed temperature, tenths of a degree F
+    int16_t humidity;                       // smoothed humidity, tenths of a %RH
+    uint16_t levels[TELEMETRY_PROBES];      // water sensor probe readings, ADC counts
+};
+
+class WLDTelemetry  {
+    static_assert(TELEMETRY_SAMPLES < 256, "the sample count of an event is one byte");
+
+    private:
+        // Constants
+        static const uint8_t TELEMETRY_FORMAT = 1;
+        static const int MAX_BINARY_SIZE = (TELEMETRY_DATA_SIZE - 1) / 4 * 3;  // binary record of one event
+        static const int MAX_SAMPLE_SIZE = VARINT_MAX_SIZE * (5 + TELEMETRY_PROBES);         // worst case encoded sample
+        static const unsigned long RETRY_INTERVAL = 30000;      // wait before retrying a failed publish
+
+        // Variables
+        WLDHal *_hal;
+        WLDPublisher *_publisher;
+        WLDEventQueue *_eventQueue;         // holds the cloud rate limit
+        const char *_eventName;
+        int _probes;                        // probe levels in each sample
+        int _window;                        // samples to wait for before publishing
+        WLDTelemetrySample _samples[TELEMETRY_SAMPLES];
+        int _head;                          // index of the oldest sample
+        int _count;                         // samples waiting
+        unsigned long _lastFailure;         // time of the last failed publish
+        bool _failed;                       // the last publish failed
+        uint8_t _binary[MAX_BINARY_SIZE];   // the record of the event being published
+        char _data[TELEMETRY_DATA_SIZE];    // and its base64
+
+        // Counters
+        uint32_t _published;                // samples published
+        uint32_t _dropped;                  // samples dropped from a full ring
+        uint32_t _failures;                 // failed publishes
+
+        // Private methods (internal use only)
+        int encode(int *samples);
+        static void base64(const uint8_t *binary, int length, char *text);
+
+    public:
+        // Constructor
+        WLDTelemetry();
+
+        // Initialization; events named "eventName" carry "probes" levels per sample, once "window" samples wait
+        void begin(WLDHal *hal, WLDPublisher *publisher, WLDEventQueue *eventQueue, const char *eventName,
+                   int probes, int window);
+
+        // Add a sample; the time is filled in here.  False if the time is not set yet
+        bool add(WLDTelemetrySample *sample);
+
+        // Publish the oldest samples if a window is waiting and the cloud and the rate limit allow
+        void process();
+
+        // Status
+        int pending() { return _count; }
+        uint32_t published() { return _published; }
+        uint32_t dropped() { return _dropped; }
+        uint32_t failures() { return _failures; }
+};
+
+#endif
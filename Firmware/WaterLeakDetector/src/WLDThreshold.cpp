@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * WLDThreshold:  threshold alarm condition with hysteresis and a minimum dwell
+ *
+ * See WLDThreshold.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include <WLDThreshold.h>
+
+// Constructor
+WLDThreshold::WLDThreshold() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDThreshold::begin(WLDThresholdDirection direction) {
+    _direction = direction;
+    _changes = 0;
+    reset();
+}   // end of begin()
+
+// take a reading, and change the condition once the readings have asked for it for the dwell time
+bool WLDThreshold::update(fixed_t value, fixed_t limit, fixed_t deadband, unsigned long dwell, unsigned long now) {
+    bool wanted;
+
+    if(_present == false) {     // set when beyond the limit
+        wanted = (_direction == THRESHOLD_ABOVE) ? (value > limit) : (value < limit);
+    } else {                    // cleared only when inside the limit by the deadband
+        wanted = (_direction == THRESHOLD_ABOVE) ? (value > limit - deadband) : (value < limit + deadband);
+    }
+
+    if(wanted == _present) {
+        _pending = false;       // a change, if one was asked for, starts over
+        return _present;
+    }
+    if(_pending == false) {
+        _pending = true;
+        _since = now;
+    }
+    if((now - _since) >= dwell) {   // unsigned arithmetic is correct across millis() overflow
+        _present = wanted;
+        _pending = false;
+        _changes++;
+    }
+    return _present;
+}   // end of update()
+
+// forget the readings
+void WLDThreshold::reset() {
+    _present = false;
+    _pending = false;
+    _since = 0;
+}   // end of reset()
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * WLDThreshold:  threshold alarm condition with hysteresis and a minimum dwell
+ *
+ * A temperature that hovers at an alarm limit crosses it back and forth with every reading.
+ * Compared directly against the limit, the alarm condition would come and go with it, and the
+ * WLDAlarmProcessor would re-arm the alarm every time the condition went away, so that every
+ * crossing sent another alarm despite the holdoff.  A WLDThreshold decides whether the condition
+ * of one threshold alarm is present, from a series of readings:
+ *
+ * - The condition becomes present when the reading is beyond the limit (above it for a
+ * THRESHOLD_ABOVE alarm, below it for a THRESHOLD_BELOW alarm), and goes away only when the
+ * reading is back inside the limit by at least the deadband:  a reading within the deadband of
+ * the limit leaves the condition as it is (hysteresis).
+ *
+ * - Either change only happens once every reading has asked for it for at least the dwell time,
+ * measured from the first reading that asked for it; a reading that does not ask for it starts
+ * the dwell over.  So a spike, or a dip back inside, shorter than the dwell changes nothing.
+ *
+ * With a deadband and dwell of 0, the condition is present exactly when the reading is beyond the
+ * limit, as with a direct compare.  The deadband and dwell are given with every reading, so that
+ * settings changed from the cloud take effect at the next one.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#ifndef wldthreshold
+#define wldthreshold
+
+#include "application.h"
+#include <WLDFixedPoint.h>
+
+// The side of the limit that the alarm is on
+enum WLDThresholdDirection {
+    THRESHOLD_BELOW = 0,    // a reading below the limit is an alarm
+    THRESHOLD_ABOVE         // a reading above the limit is an alarm
+};
+
+class WLDThreshold  {
+    private:
+        // Variables
+        WLDThresholdDirection _direction;
+        bool _present;                      // the alarm condition is present
+        bool _pending;                      // the readings since _since ask for the condition to change
+        unsigned long _since;               // time of the first reading that asked for the change
+        uint32_t _changes;                  // changes of the condition
+
+    public:
+        // Constructor
+        WLDThreshold();
+
+        // Initialization; the condition starts out not present
+        void begin(WLDThresholdDirection direction);
+
+        // Take a reading; returns whether the condition is present
+        bool update(fixed_t value, fixed_t limit, fixed_t deadband, unsigned long dwell, unsigned long now);
+
+        // Forget the readings; the condition is not present
+        void reset();
+
+        // Status
+        bool present() { return _present; }
+        uint32_t changes() { return _changes; }
+};
+
+#endif
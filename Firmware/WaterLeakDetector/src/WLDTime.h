@@ -0,0 +1,30 @@
+/*******************************************************************************
+ * WLDTime:  wrap-safe arithmetic on millis() and micros() time values
+ *
+ * millis() overflows back to zero about every 49.7 days, and micros() about every 71.6 minutes.
+ * Subtracting two unsigned long times gives the correct elapsed time across an overflow, as
+ * long as the true elapsed time is less than the full range, so no overflow test is needed.
+ * All WLD code that measures or compares times uses these functions.
+ *
+ * timeSince() is the time elapsed from "then" to "now".  timeReached() is true once "now" is at
+ * or after "deadline"; it is correct as long as the deadline is less than half the range of the
+ * time value (about 24.8 days of milliseconds) in the past or the future.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#ifndef wldtime
+#define wldtime
+
+inline unsigned long timeSince(unsigned long now, unsigned long then) {
+    return now - then;
+}
+
+inline bool timeReached(unsigned long now, unsigned long deadline) {
+    return (long)(now - deadline) >= 0;
+}
+
+#endif
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * WLDTrend:  fit the recent trend of a temperature and predict when it will reach a limit
+ *
+ * See WLDTrend.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include <WLDTrend.h>
+
+const int64_t SECONDS_PER_HOUR = 3600;
+const int64_t MAX_SECONDS = 4000000;    // times to a limit beyond this (46 days) are NEVER
+
+// Constructor
+WLDTrend::WLDTrend() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDTrend::begin() {
+    _newest = MAX_POINTS - 1;
+    _points = 0;
+    _sum = 0;
+    _count = 0;
+    _levelTime = 0;
+    _level = 0;
+    _rate = 0;
+    _significant = false;
+}   // end of begin()
+
+// add a reading to the current point, closing the point first once POINT_TIME has passed since
+//  its first reading
+void WLDTrend::add(fixed_t value, unsigned long now) {
+    if(_count > 0 && timeSince(now, _first) >= POINT_TIME) {
+        closePoint();
+    }
+    if(_count == 0) {
+        _first = now;
+    }
+    _last = now;
+    _sum += value;
+    _count++;
+}   // end of add()
+
+unsigned long WLDTrend::timeToFall(fixed_t limit, unsigned long now) {
+    if(_points == 0) {
+        return NEVER;
+    }
+    if(_level <= limit) {
+        return 0;
+    }
+    if(_significant == false || _rate >= 0) {
+        return NEVER;
+    }
+    return timeTo(_level - limit, -_rate, now);
+}   // end of timeToFall()
+
+unsigned long WLDTrend::timeToRise(fixed_t limit, unsigned long now) {
+    if(_points == 0) {
+        return NEVER;
+    }
+    if(_level >= limit) {
+        return 0;
+    }
+    if(_significant == false || _rate <= 0) {
+        return NEVER;
+    }
+    return timeTo(limit - _level, _rate, now);
+}   // end of timeToRise()
+
+// private methods
+
+// average the readings of the current point into a new point, and fit the trend again
+void WLDTrend::closePoint() {
+    _newest = (_newest + 1) % MAX_POINTS;
+    _times[_newest] = _first + (_last - _first) / 2;
+    _values[_newest] = (fixed_t)(_sum / _count);
+    if(_points < MAX_POINTS) {
+        _points++;
+    }
+    _sum = 0;
+    _count = 0;
+    fit();
+}   // end of closePoint()
+
+// fit the trend over the last SHORT_POINTS and the last MAX_POINTS points.  The trend is
+//  significant only when both fits are significant and agree in direction:  a heating cycle gives
+//  a short trend that comes and goes, but little long trend.  The level and rate are those of the
+//  short fit, which follows a change in the trend sooner.
+void WLDTrend::fit() {
+    fixed_t longLevel, longRate;
+    bool longSignificant;
+
+    _levelTime = _times[_newest];
+    _significant = fitLine(SHORT_POINTS, &_level, &_rate);
+    longSignificant = fitLine(MAX_POINTS, &longLevel, &longRate);
+    if(longSignificant == false || (longRate < 0) != (_rate < 0)) {
+        _significant = false;
+    }
+}   // end of fit()
+
+// least squares fit of value = level + rate * t to the newest "maxPoints" points that are no
+//  older than "maxPoints" point times, where t is in seconds before the newest point.  The sums
+//  of squares are multiplied out as n * sum(a * b) - sum(a) * sum(b), so that they are exact in
+//  64 bit integers.  Returns true when the rate is significant.
+bool WLDTrend::fitLine(int maxPoints, fixed_t *level, fixed_t *rate) {
+    int64_t n = 0, sumT = 0, sumX = 0, sumTT = 0, sumTX = 0, sumXX = 0;
+    unsigned long newestTime = _times[_newest];
+
+    for(int i = 0; i < _points && i < maxPoints; i++) {
+        int point = (_newest + MAX_POINTS - i) % MAX_POINTS;
+        unsigned long age = timeSince(newestTime, _times[point]);
+        if(age >= maxPoints * POINT_TIME) {
+            break;          // older points are from before a long sensor failure
+        }
+        int64_t t = -(int64_t)(age / 1000);
+        int64_t x = _values[point];
+        n++;
+        sumT += t;
+        sumX += x;
+        sumTT += t * t;
+        sumTX += t * x;
+        sumXX += x * x;
+    }
+
+    int64_t sxx = n * sumTT - sumT * sumT;      // n times the centered sums
+    int64_t sxy = n * sumTX - sumT * sumX;
+    int64_t syy = n * sumXX - sumX * sumX;
+    if(n < 2 || sxx == 0) {
+        *level = _values[_newest];
+        *rate = 0;
+        return false;
+    }
+    *rate = (fixed_t)(sxy * SECONDS_PER_HOUR / sxx);
+    *level = (fixed_t)((sumX * sxx - sxy * sumT) / (n * sxx));
+
+    // the standard error of the rate is sqrt(residual / ((n - 2) * sxx)), where the residual sum
+    //  of squares is syy - sxy^2 / sxx; the rate is significant when
+    //  rate^2 = (sxy / sxx)^2 > SIGNIFICANCE^2 * residual / ((n - 2) * sxx)
+    int64_t explained = (sxy / n) * (sxy / n) / (sxx / n);   // explained sum of squares
+    int64_t residual = syy / n - explained;
+    return (n >= MIN_POINTS) && (explained * (n - 2) > (int64_t)SIGNIFICANCE * SIGNIFICANCE * residual);
+}   // end of fitLine()
+
+// time from "now" until the trend moves "distance" at "rate" per hour (both positive), counted
+//  from the time of the fitted level
+unsigned long WLDTrend::timeTo(fixed_t distance, fixed_t rate, unsigned long now) {
+    int64_t seconds = (int64_t)distance * SECONDS_PER_HOUR / rate;
+    unsigned long elapsed = timeSince(now, _levelTime);
+
+    if(seconds >= MAX_SECONDS) {
+        return NEVER;
+    }
+    if((uint64_t)seconds * 1000 <= elapsed) {
+        return 0;
+    }
+    return (unsigned long)(seconds * 1000 - elapsed);
+}   // end of timeTo()
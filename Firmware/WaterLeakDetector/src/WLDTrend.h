@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * WLDTrend:  fit the recent trend of a temperature and predict when it will reach a limit
+ *
+ * The WLD firmware raises a low or high temperature alarm when the smoothed temperature of a
+ * zone has crossed a limit.  The smoothing lags the real temperature, and by then the pipes may
+ * already be freezing.  A WLDTrend fits a straight line to the last MAX_POINTS minutes of raw
+ * readings and extrapolates it, so that the firmware can warn that a limit will be reached
+ * before it is:
+ *
+ * - The readings of each POINT_TIME (one minute) are averaged into one point, which reduces the
+ * noise and the 1 degree C steps of the DHT11 before the fit, and keeps the fit to a fixed number
+ * of points however often the sensor is read.
+ *
+ * - Each time a point is closed, least squares lines are fitted to the last SHORT_POINTS (30)
+ * and the last MAX_POINTS (60) points, by their actual times (a point is missing while the sensor
+ * fails).  The short fit gives the level (the fitted value at the newest point) and the rate of
+ * change per hour.
+ *
+ * - A fit is significant only when it has at least MIN_POINTS points and its rate is at least
+ * SIGNIFICANCE times the standard error of the rate, so that noise and the 1 degree steps are not
+ * taken for a trend.  The test is done on squares, in 64 bit integers.  The trend is significant
+ * only when both fits are, in the same direction:  the short fit alone follows the falling half
+ * of a heating cycle, which the long fit averages out.
+ *
+ * timeToFall() (timeToRise()) is the time from "now" until the fitted line falls (rises) to a
+ * limit:  0 once the level is at or past the limit, and NEVER when there is no significant trend
+ * towards the limit.
+ *
+ * test/TrendReplay.cpp replays simulated DHT11 readings against a 40 F low limit, warning when
+ * the limit is predicted within 20 minutes as the WLD firmware does.  It checks that steady
+ * cooling of 4 F per hour or faster is warned of well before the limit alarm, that steady
+ * temperatures give no warnings and that a heating cycle 8 F or more above the limit gives fewer
+ * than one a day.  Slow cooling (2 F per
+ * hour) gets less warning, and a heating cycle within a few degrees of the limit gives some
+ * warnings, as the level comes within a DHT11 step of the limit.
+ * Each alarm type repeats at most once a day, so the user gets at most one warning text a day.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Describe test/TrendReplay.cpp instead of a table of replay results
+ *
+ *******************************************************************************/
+#ifndef wldtrend
+#define wldtrend
+
+#include "application.h"
+#include <WLDFixedPoint.h>
+#include <WLDTime.h>
+
+class WLDTrend  {
+    public:
+        // Constants
+        static const int MAX_POINTS = 60;           // points in the long fit
+        static const int SHORT_POINTS = 30;         // points in the short fit
+        static const int MIN_POINTS = 10;           // points needed for a significant trend
+        static const int SIGNIFICANCE = 3;          // rate / standard error of the rate needed
+        static const unsigned long POINT_TIME = 60000;  // readings averaged into each point, milliseconds
+        static const unsigned long NEVER = 0xffffffff;  // time to a limit that won't be reached
+
+    private:
+        // Variables
+        unsigned long _times[MAX_POINTS];   // time of each point (the middle of its readings)
+        fixed_t _values[MAX_POINTS];        // average of each point's readings
+        int _newest;                        // index of the newest point
+        int _points;                        // number of points
+
+        int64_t _sum;                       // of the readings of the point being collected
+        unsigned long _first;               // time of its first reading
+        unsigned long _last;                // time of its last reading
+        uint16_t _count;                    // number of its readings
+
+        // Results of the last fit
+        unsigned long _levelTime;           // time of the newest point
+        fixed_t _level;                     // fitted value at _levelTime
+        fixed_t _rate;                      // units per hour
+        bool _significant;
+
+        // Private methods (internal use only)
+        void closePoint();
+        void fit();
+        bool fitLine(int maxPoints, fixed_t *level, fixed_t *rate);
+        unsigned long timeTo(fixed_t distance, fixed_t rate, unsigned long now);
+
+    public:
+        // Constructor
+        WLDTrend();
+
+        // Initialization
+        void begin();
+
+        // Sampling
+        void add(fixed_t value, unsigned long now);
+
+        // Results
+        int points() { return _points; }
+        bool significant() { return _significant; }
+        fixed_t level() { return _level; }
+        fixed_t ratePerHour() { return _rate; }
+        unsigned long timeToFall(fixed_t limit, unsigned long now);    // milliseconds, or NEVER
+        unsigned long timeToRise(fixed_t limit, unsigned long now);
+};
+
+#endif
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * WLDVarint:  variable length integers for the WLD delta encoded records
+ *
+ * putVarint() writes an unsigned value as a LEB128 varint:  7 bits per byte, least significant
+ * first, with the top bit set on all but the last byte, so values below 128 take one byte and a
+ * 32 bit value at most VARINT_MAX_SIZE bytes.  getVarint() reads one back.
+ *
+ * zigzag() maps a signed difference to an unsigned value that is small when the difference is
+ * small (0, -1, 1, -2, 2 ... to 0, 1, 2, 3, 4 ...), so that small differences of either sign take
+ * one byte as a varint; unzigzag() maps it back.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#ifndef wldvarint
+#define wldvarint
+
+#include "application.h"
+
+const int VARINT_MAX_SIZE = 5;              // bytes of the largest 32 bit varint
+
+// write a varint into buffer; returns its length
+inline int putVarint(uint8_t *buffer, uint32_t value) {
+    int length = 0;
+
+    while(value >= 0x80) {
+        buffer[length++] = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+    buffer[length++] = value;
+    return length;
+}
+
+// read a varint of at most "size" bytes from buffer into value; returns its length, or 0 if it is cut off
+inline int getVarint(const uint8_t *buffer, int size, uint32_t *value) {
+    uint32_t result = 0;
+
+    for(int length = 0; length < size && length < VARINT_MAX_SIZE; length++) {
+        result |= (uint32_t)(buffer[length] & 0x7f) << (7 * length);
+        if((buffer[length] & 0x80) == 0) {
+            *value = result;
+            return length + 1;
+        }
+    }
+    return 0;
+}
+
+inline uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+#endif
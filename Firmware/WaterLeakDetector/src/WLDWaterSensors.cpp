@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * WLDWaterSensors:  class to read, threshold and integrate any number of water sensor probes
+ *
+ * See WLDWaterSensors.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Integer-only thresholding in ADC counts
+ * version 1.2: 10/17/26.  Adaptive sampling rate, with a shorter integration when fast; ADC read
+ *  and detection time accounting
+ * version 1.3: 10/17/26.  Oversampling:  each reading is the median of a burst of samples
+ * version 1.5: 10/17/26.  The readings and the accounting are atomic, for readers on another thread
+ *
+ *******************************************************************************/
+#include <WLDWaterSensors.h>
+
+// median of "count" samples, which are sorted in place; insertion sort, as there are only a few
+static uint16_t median(uint16_t *samples, int count) {
+    for(int i = 1; i < count; i++) {
+        uint16_t sample = samples[i];
+        int j = i;
+        while(j > 0 && samples[j - 1] > sample) {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        samples[j] = sample;
+    }
+    return samples[count / 2];
+}   // end of median()
+
+// Constructor
+WLDWaterSensors::WLDWaterSensors() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDWaterSensors::begin(WLDHal *hal, const WLDWaterChannel *channels, int numChannels,
+                            const uint8_t *muxSelectPins, int numMuxSelectPins,
+                            uint16_t thresholdCounts, uint8_t alarmLimit) {
+    _hal = hal;
+    _channels = channels;
+    _numChannels = (numChannels > MAX_CHANNELS) ? MAX_CHANNELS : numChannels;
+    _muxSelectPins = muxSelectPins;
+    _numMuxSelectPins = numMuxSelectPins;
+    _threshold = thresholdCounts;
+    _alarmLimit = alarmLimit;
+    _oversampling = 1;
+
+    for(int i = 0; i < _numMuxSelectPins; i++) {
+        _hal->pinMode(_muxSelectPins[i], OUTPUT);
+    }
+    _currentMuxAddress = NO_MUX;    // force the select pins to be driven on the first read
+
+    for(int i = 0; i < MAX_CHANNELS; i++) {
+        _reading[i].store(0, std::memory_order_relaxed);
+        _integrator[i] = 0;
+    }
+    _alarmBits = 0;
+
+    _adaptive = false;              // never fast until setAdaptive()
+    _nearThreshold = thresholdCounts;
+    _fastAlarmLimit = alarmLimit;
+    _clearSamples = 1;
+    _quietSamples = 0;
+    _fast = false;
+
+    _reads.store(0, std::memory_order_relaxed);
+    _detections.store(0, std::memory_order_relaxed);
+    _detecting = false;
+    _lastDetectionTime.store(0, std::memory_order_relaxed);
+}   // end of begin()
+
+// read each channel as the median of a burst of "samples" samples
+void WLDWaterSensors::setOversampling(uint8_t samples) {
+    if(samples < 1) {
+        samples = 1;
+    } else if(samples > MAX_OVERSAMPLING) {
+        samples = MAX_OVERSAMPLING;
+    }
+    _oversampling = samples;
+}   // end of setOversampling()
+
+// sample fast, integrating to "fastAlarmLimit", while any reading is above "nearThresholdCounts"
+//  or any channel is counting or in alarm, until "clearSamples" samples in a row are quiet
+void WLDWaterSensors::setAdaptive(uint16_t nearThresholdCounts, uint8_t fastAlarmLimit, uint8_t clearSamples) {
+    _adaptive = true;
+    _nearThreshold = nearThresholdCounts;
+    _fastAlarmLimit = fastAlarmLimit;
+    _clearSamples = clearSamples;
+}   // end of setAdaptive()
+
+/* sample():  read every channel, threshold each reading and integrate the thresholds
+    return:
+        true if any channel is in alarm.  A channel goes into alarm after _alarmLimit (_fastAlarmLimit
+            while sampling fast) more readings above threshold than below, and stays in alarm until
+            its integrator counts back down to zero.
+*/
+bool WLDWaterSensors::sample() {
+    const int limit = _fast ? _fastAlarmLimit : _alarmLimit;
+    const uint16_t allBits = (1UL << _numChannels) - 1;
+    uint16_t readings[MAX_CHANNELS];
+
+    // acquire: read each probe, switching the multiplexer only when the address changes
+    for(int i = 0; i < _numChannels; i++) {
+        uint8_t address = _channels[i].muxAddress;
+        if(address != NO_MUX && address != _currentMuxAddress) {
+            selectMuxAddress(address);
+        }
+        if(_oversampling == 1) {
+            readings[i] = _hal->analogRead(_channels[i].pin);
+        } else {
+            uint16_t burst[MAX_OVERSAMPLING];
+            _hal->analogReadBurst(_channels[i].pin, burst, _oversampling);
+            readings[i] = median(burst, _oversampling);
+        }
+        _reading[i].store(readings[i], std::memory_order_relaxed);
+    }
+
+    // this is the only thread that writes the accounting, so a load and a store update it
+    _reads.store(_reads.load(std::memory_order_relaxed) + _numChannels * _oversampling, std::memory_order_relaxed);
+
+    // threshold and integrate: no data-dependent branches, so the cost is the same for every channel
+    uint16_t setBits = 0;
+    uint16_t clearBits = 0;
+    uint16_t nearBits = 0;
+    for(int i = 0; i < _numChannels; i++) {
+        int over = readings[i] > _threshold;        // 1 if the threshold was exceeded, else 0
+        nearBits |= (uint16_t)(readings[i] > _nearThreshold) << i;
+        int value = _integrator[i] + 2 * over - 1;  // count up on a threshold, down otherwise
+        value += (value < 0);                       // clamp at zero
+        value -= (value > limit);                   // clamp at the alarm limit
+        _integrator[i] = value;
+        setBits |= (uint16_t)(value >= limit) << i;
+        clearBits |= (uint16_t)(value == 0) << i;
+    }
+
+    // time the detection of an alarm from the first reading above threshold of a channel that is
+    //  not in alarm; a count that goes back to zero was a false reading
+    uint16_t countingBits = ~clearBits & ~_alarmBits & allBits;
+    uint16_t newBits = setBits & ~_alarmBits;
+    if(newBits != 0) {
+        _lastDetectionTime.store((_detecting == true) ? _hal->millis() - _detectStart : 0, std::memory_order_relaxed);
+        _detections.store(_detections.load(std::memory_order_relaxed) + __builtin_popcount(newBits),
+                          std::memory_order_relaxed);
+        _detecting = false;
+    } else if(countingBits == 0) {
+        _detecting = false;
+    } else if(_detecting == false) {
+        _detectStart = _hal->millis();
+        _detecting = true;
+    }
+
+    // a channel enters alarm at the limit, leaves it at zero, and otherwise keeps its state
+    _alarmBits = (_alarmBits & ~clearBits) | setBits;
+
+    // sample fast while any reading is near the threshold, or any channel is counting or in
+    //  alarm; go slow again after enough quiet samples
+    if(_adaptive == true && (nearBits | (~clearBits & allBits) | _alarmBits) != 0) {
+        _fast = true;
+        _quietSamples = 0;
+    } else if(_fast == true && ++_quietSamples >= _clearSamples) {
+        _fast = false;
+    }
+    return _alarmBits != 0;
+}   // end of sample()
+
+// private methods
+
+// drive a multiplexer address onto the select pins, least significant bit first
+void WLDWaterSensors::selectMuxAddress(uint8_t address) {
+    for(int i = 0; i < _numMuxSelectPins; i++) {
+        _hal->digitalWrite(_muxSelectPins[i], (address >> i) & 1);
+    }
+    _currentMuxAddress = address;
+}   // end of selectMuxAddress()
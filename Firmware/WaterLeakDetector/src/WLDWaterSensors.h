@@ -0,0 +1,153 @@
+/*******************************************************************************
+ * WLDWaterSensors:  class to read, threshold and integrate any number of water sensor probes
+ *
+ * The WLD firmware describes each water sensor probe (channel) with a WLDWaterChannel entry: the
+ * analog pin that the probe is read on and, for probes connected through an analog multiplexer,
+ * the multiplexer address of the probe.  Multiplexer address bits are driven onto the select
+ * pins given to begin(), least significant bit first.  Probes wired directly to an analog pin
+ * use the address NO_MUX.
+ *
+ * Each call to sample() reads every channel and compares each ADC reading to the water level
+ * threshold, which is given to begin() in ADC counts (see voltsToAdcCounts() in WLDFixedPoint.h)
+ * so that no reading has to be converted to a voltage.  Each channel has its own integrator that
+ * counts up (to the alarm limit) for each reading above the threshold and down (to zero) for each
+ * reading at or below the threshold.  A channel goes into alarm when its integrator reaches the alarm
+ * limit, and comes out of alarm when its integrator reaches zero.  This filters out false
+ * readings and adds hysteresis to the alarm/reset process, exactly as the original two-probe
+ * alarmIntegrator() did, but separately for each probe.
+ *
+ * Oversampling:  after setOversampling(), each reading of a channel is the median of a burst of
+ * samples read back to back (see WLDHal::analogReadBurst()).  A median ignores up to half of the
+ * burst, less one, being spikes, where the integrator alone needs one more count for each spike it
+ * must ride out, so the integrator can count to a lower alarm limit for the same false alarm rate.
+ * test/OversamplingTest.cpp simulates a spiky probe read every 10 ms and checks that the median
+ * of 5 samples with a lower alarm limit gives no more false alarms than single samples and
+ * detects a leak sooner.  The burst costs more ADC reads, which reads() counts.
+ *
+ * Channel state is kept as a struct of arrays (readings and integrators) plus one bit per
+ * channel for the alarm state, and the threshold and integrate steps run over all channels with
+ * no data-dependent branches, so the cost per sample grows only linearly and predictably with
+ * the number of channels.
+ *
+ * Adaptive sampling:  after setAdaptive(), the sensors ask to be sampled slowly while every
+ * probe is dry, and fast while any reading is above a "near" threshold (below the water level
+ * threshold), any integrator is counting or any channel is in alarm.  While fast, the integrators
+ * count to a shorter alarm limit, so a leak is detected in a short burst of fast samples instead
+ * of the full integration at the slow rate.  Once "clearSamples" fast samples in a row are all
+ * quiet, the sensors ask to go slow again.  fast() tells the WLD firmware which rate to sample at;
+ * the class does not keep time itself.  Without setAdaptive() the sensors never ask to go fast,
+ * and integrate to the alarm limit given to begin(), as before.
+ *
+ * For latency and energy accounting the class counts the ADC reads (reads()), and measures the
+ * detection time of each alarm:  from the first reading above threshold to the channel going into
+ * alarm (lastDetectionTime()).  The time from a probe getting wet to that first reading is up to
+ * one slow sample interval, which the firmware adds to report the worst case detection latency.
+ *
+ * One thread calls sample() and the other methods.  The readings (reading(), millivolts()) and
+ * the accounting (reads(), detections(), lastDetectionTime()) are atomic, so that other threads
+ * can read them too:  the WLD firmware's loop() tasks read them while its sensing thread samples.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Integer-only thresholding in ADC counts
+ * version 1.2: 10/17/26.  Adaptive sampling rate, with a shorter integration when fast; ADC read
+ *  and detection time accounting
+ * version 1.3: 10/17/26.  Oversampling:  each reading is the median of a burst of samples
+ * version 1.4: 10/17/26.  Describe test/OversamplingTest.cpp instead of a table of simulation results
+ * version 1.5: 10/17/26.  The readings and the accounting are atomic, for readers on another thread
+ *
+ *******************************************************************************/
+#ifndef wldws
+#define wldws
+
+#include "application.h"
+#include <WLDHal.h>
+#include <WLDFixedPoint.h>
+#include <atomic>
+
+// Wiring of one water sensor probe
+struct WLDWaterChannel {
+    uint8_t pin;            // analog pin the probe (or its multiplexer) is read on
+    uint8_t muxAddress;     // multiplexer address of the probe, or WLDWaterSensors::NO_MUX
+};
+
+class WLDWaterSensors  {
+    public:
+        // Constants
+        static const int MAX_CHANNELS = 16;         // one bit per channel in a uint16_t
+        static const uint8_t NO_MUX = 0xff;         // the probe is wired directly to its analog pin
+        static const int MAX_OVERSAMPLING = 9;      // samples per reading
+
+    private:
+        // Variables
+        WLDHal *_hal;
+        const WLDWaterChannel *_channels;           // wiring of each channel
+        int _numChannels;
+        const uint8_t *_muxSelectPins;              // multiplexer address pins, least significant bit first
+        int _numMuxSelectPins;
+        uint8_t _currentMuxAddress;                 // address currently driven onto the select pins
+        uint16_t _threshold;                        // water level threshold in ADC counts
+        uint8_t _alarmLimit;                        // number of readings above threshold to alarm
+        uint8_t _oversampling;                      // samples per reading
+
+        // Adaptive sampling
+        bool _adaptive;                             // setAdaptive() has been called
+        uint16_t _nearThreshold;                    // a reading above this asks for fast sampling, ADC counts
+        uint8_t _fastAlarmLimit;                    // alarm limit while sampling fast
+        uint8_t _clearSamples;                      // quiet fast samples before going slow again
+        uint8_t _quietSamples;                      // quiet fast samples in a row so far
+        bool _fast;                                 // sampling fast
+
+        // Accounting; atomic, as other threads read it
+        std::atomic<uint32_t> _reads;               // ADC reads
+        std::atomic<uint32_t> _detections;          // channels that went into alarm
+        unsigned long _detectStart;                 // time of the first reading above threshold
+        bool _detecting;                            // an integrator is counting towards an alarm
+        std::atomic<unsigned long> _lastDetectionTime;  // milliseconds from the first reading above threshold to
+                                                        //  the alarm
+
+        // Channel state, one array entry per channel
+        std::atomic<uint16_t> _reading[MAX_CHANNELS];   // raw ADC reading; atomic, as other threads read it
+        uint8_t _integrator[MAX_CHANNELS];          // threshold exceeded accumulator
+        uint16_t _alarmBits;                        // bit n is set when channel n is in alarm
+
+        // Private methods (internal use only)
+        void selectMuxAddress(uint8_t address);
+
+    public:
+        // Constructor
+        WLDWaterSensors();
+
+        // Initialization
+        void begin(WLDHal *hal, const WLDWaterChannel *channels, int numChannels,
+                   const uint8_t *muxSelectPins, int numMuxSelectPins,
+                   uint16_t thresholdCounts, uint8_t alarmLimit);
+
+        void setOversampling(uint8_t samples);      // each reading is the median of "samples" samples
+        void setAdaptive(uint16_t nearThresholdCounts, uint8_t fastAlarmLimit, uint8_t clearSamples);
+
+        // Read, threshold and integrate all channels; returns true if any channel is in alarm
+        bool sample();
+        bool fast() { return _fast; }       // sample at the fast rate
+
+        // Results
+        int numChannels() { return _numChannels; }
+        bool anyAlarm() { return _alarmBits != 0; }
+        bool channelAlarm(int channel) { return (_alarmBits >> channel) & 1; }
+        uint16_t alarmBits() { return _alarmBits; }
+        uint16_t reading(int channel) {     // median of the last burst
+            return _reading[channel].load(std::memory_order_relaxed);
+        }
+        uint16_t millivolts(int channel) { return adcCountsToMillivolts(reading(channel)); }
+
+        // Accounting
+        uint32_t reads() { return _reads.load(std::memory_order_relaxed); }
+        uint32_t detections() { return _detections.load(std::memory_order_relaxed); }
+        unsigned long lastDetectionTime() {     // of the last alarm
+            return _lastDetectionTime.load(std::memory_order_relaxed);
+        }
+};
+
+#endif
@@ -2,17 +2,19 @@
     WaterLeakDetector: Detect a water leak and sound the alarm!  Read the ambient temperature
         and humidity, display them on a "servo meter" and publich the data to the cloud."
 
-        This program reads two water level sensor analog outputs, converts each to a voltage,
-        thresholds the voltages to detect a water leak condition, integrates the thresholds to filter
-        out false readings, introduces some hysteresis into the alarm/reset process, and indicates the alarm.
-        The program uses a non-blocking delay that reads each sensor every 20 milliseconds and requires
-        5 readings above a threshold for either sensor in order to trigger an alarm.
+        This program reads the analog outputs of the water level sensors listed in WATER_CHANNELS (two, as
+        built), converts each to a voltage, thresholds the voltages to detect a water leak condition,
+        integrates the thresholds to filter out false readings, introduces some hysteresis into the
+        alarm/reset process, and indicates the alarm.  Each reading of a sensor is the median of 5 ADC
+        samples.  The sensors are read every 100 milliseconds while every sensor is dry, and every 10
+        milliseconds while any sensor is near the threshold or wet.  3 readings above the threshold (2 while
+        reading every 10 milliseconds) for any sensor trigger an alarm, and as many below it reset it.
 
         This program supports both an alarm and an indicator.  The indicator turns on and off
         based solely upon the threshold hysteresis.  The alarm also turns on and off based upon the
         threshold hysteresis but, additionally, mutes when a pushbutton is pressed and stays muted until the
-        alarm indication is cleared.  Although two sensors are supported, there is only a single alarm
-        indication.  Either sensor can trigger the alarm and both sensors must be in the non-alarm
+        alarm indication is cleared.  Although several sensors are supported, there is only a single alarm
+        indication.  Any sensor can trigger the alarm and every sensor must be in the non-alarm
         state for the alarm indication to be cleared.
 
         The indicator is normally lit to show that the system is working.  The indicator flashes when
@@ -42,6 +44,198 @@
 
     (c) 2017, 2021, 2022 Bob Glicksman and Jim Schrempp, Team Practical Projects
 
+20261017:  Version 2.26:  WLDHal is now a pure interface (see WLDHal.h), and the Device OS implementation of it is the
+    new WLDHalPhoton class.  The firmware builds and runs on a Linux host with the CMake project in test/ (see
+    test/README.md), which has Device OS stub headers and a simulated device (WLDHalMock) with a simulated clock,
+    scripted ADC and GPIO inputs, simulated DHT sensors, an in-memory EEPROM and a mock cloud, and a benchmark of
+    loop() that reports loop() passes per second and the cost of each phase.  project.properties no longer names
+    PietteTech_DHT 0.0.14 as a dependency, so the build uses the library in lib/, now 0.0.21:  a DHT 22 or 21 start
+    pulse (1.5 ms) is held with a busy wait, as ending it from the DHT poll task could hold it past the 20 ms that
+    the sensor allows.  A DHT 11 start pulse is still ended by the DHT poll task (see test/DhtStartPulseTest.cpp).
+    The DHT driver's statistics (counts of good readings and of each error code, and the edge time histogram) are
+    now a template policy, like its edge timing log; WLDSensorBus keeps them for the DhtStats cloud variable.
+    test/PsychrometricsTest.cpp checks the dew point and heat index of every DHT 22 reading against the library's.
+    test/TrendReplay.cpp measures how early WLDTrend warns of the low temperature limit and how often it warns falsely.
+    test/OversamplingTest.cpp measures the false alarms and detection time of the water sensors with oversampling.
+    test/ConfigJournalTest.cpp tears config journal writes at every byte and checks what loads after the reset.
+    The LoopProfiler cloud function no longer enables or resets the sensing thread's profiler from loop():  it posts
+    the request in an atomic flag, which the sensing thread takes at the start of its next pass (sensingPass()).
+    test/SensingThreadTest.cpp runs the sensing thread on a host thread with loop() held up, and checks the water
+    sensor reading interval and the buzzer.  The event queue now holds event names of up to 27 characters, as the
+    predicted alarm events were published with their names cut to 23 (e.g. "WLDAlarmHighTempPredict").
+    The predicted temperature alarm conditions now follow the zones' predicted alarm flags, and so their deadband
+    and dwell, and the minutes they report are held at PREDICTION_HORIZON plus PREDICTION_DEADBAND (25) while a
+    zone keeps its alarm after its trend stops reaching the limit.  test/ThresholdReplay.cpp runs the firmware with
+    a noisy temperature wandering across, hovering at and approaching the high limit.
+    The host build leaves WLDHalPhoton out (there is no PLATFORM_ID) and is warning-free with -Wall.
+    A history block is now emptied before the newest block moves on to it, so that a reset between the two cannot
+    leave the oldest records as the newest.  test/HistoryTest.cpp pages through, rolls over and damages the history.
+    The heap holes of the Heap cloud variable no longer count the free space at the top of the heap.
+    Events are published as private events (PRIVATE), which the webhooks of the device's own account still receive.
+    waterFast and the water sensor readings and counts, which the sensing thread writes and the loop() tasks read, are
+    now std::atomic.
+
+20261017:  Version 2.25:  Hysteresis and a minimum dwell for the temperature alarms (see WLDThreshold.h).  A temperature
+    hovering at a limit used to set and clear the alarm condition with every reading, and every re-arm let the next
+    crossing send another alarm despite the one day holdoff.  Now a low (high) temperature alarm condition is set
+    when a zone is below (above) the limit for the dwell time, and cleared only when it has been back inside the limit
+    by the deadband for the dwell time.  The deadband (tenths of a degree F, default 1 degree) and dwell (seconds,
+    default 60) of each alarm are settings in the config journal, set with the new "SetAlarmHysteresis" cloud
+    function ("<low deadband>,<high deadband>,<low dwell>,<high dwell>") and shown in the new "AlarmHysteresis" cloud
+    variable.  The predicted alarms use the dwell of their limit alarm and a deadband of PREDICTION_DEADBAND (5
+    minutes).  test/ThresholdReplay.cpp counts the alarms sent for a noisy temperature at the high limit, with and
+    without hysteresis.
+
+20261017:  Version 2.24:  On-device history (see WLDHistory.h).  Every HISTORY_SAMPLE_INTERVAL (5 seconds) the
+    smoothed temperature and humidity of zone 0 and the voltage of each water sensor probe are added to a history of
+    10 second records for the last hour, kept in retained memory so that it survives a reset, and of 1 minute records
+    for the last day.  Each record holds the average temperature and humidity and the highest probe voltages of its
+    interval, delta and varint encoded in CRC protected blocks.  The app fetches a page at a time with the new
+    "History" cloud function ("<tier>,<from Unix time>", tier 0 for 10 second and 1 for 1 minute records), which
+    writes the page into the new "History" cloud variable and returns the number of records in it.
+
+20261017:  Version 2.23:  Telemetry history.  Every PARTICLE_PUBLISH_INTERVAL (60 seconds) a sample of the alarm
+    conditions, the leaking probes, the smoothed temperature and humidity of zone 0 and the level of each water sensor
+    probe is kept by a WLDTelemetry (see WLDTelemetry.h), and once TELEMETRY_WINDOW (15) samples are waiting they are
+    published as one "WLDTelemetry" event, delta and varint encoded and packed in base64, so the cloud gets minute by
+    minute history for one publish per 15 minutes.  Telemetry is only published when no alarm event is waiting, within
+    the cloud rate limit of the event queue.  An hour of samples is kept through a cloud outage.
+
+20261017:  Version 2.22:  Stall and reset forensics (see WLDForensics.h).  Any phase of loop() longer than
+    LOOP_STALL_BUDGET (100 ms), time between loop() calls longer than that, any sensing thread task longer than
+    SENSING_STALL_BUDGET (20 ms) and any water sensor reading more than that late is recorded as a stall, with its
+    thread, phase, duration, time and boot, in a ring of the last 16 stalls in retained memory, and counted per
+    thread and phase.  The application watchdog resets the device when loop() has not come around for
+    WATCHDOG_TIMEOUT (60 seconds), and loop() resets it when the sensing thread has not come around for
+    SENSING_WATCHDOG_TIMEOUT (5 seconds); either way the phase that never ended is recorded first.  The boots, the
+    reason for the last reset and the watchdog resets are kept too.  The new "Forensics" cloud variable reports the
+    record, and the "Forensics" cloud function clears it ("clear").  Writing the settings to EEPROM is timed as the
+    new config phase.
+
+20261017:  Version 2.21:  A sensing thread.  The cloud connection runs in its own system thread (SYSTEM_THREAD), and
+    the water sensors, the mute pushbutton, the indicator and the buzzer are run by their own scheduler in a
+    sensing thread at a higher priority than loop(), so that publishing, cloud function calls and EEPROM writes in
+    loop() can no longer delay a water sensor reading or the alarm.  The sensing thread passes each change of the
+    water sensor alarms to loop(), which sends the alarms, through a lock-free queue (see WLDSpscQueue.h).  The
+    temperature/humidity sensors stay in loop() with the processing of their readings.  The LoopStats cloud
+    variable reports the sensing thread after ";sensing:".  The Info reset time is written once the time has been
+    set from the cloud, as setup() no longer waits for the cloud connection.
+
+20261017:  Version 2.20:  The new "State" cloud variable holds all of the current state in one compact, versioned
+    snapshot, so the app can draw its screen with one request instead of one per variable:  sequence number, uptime,
+    firmware version, every alarm condition, the leaking probes, the temperature and humidity, the alarm limits and
+    the health of the temperature sensor (see writeStateString()).  It is rewritten, with the next sequence number,
+    only when the state changes.  The separate variables are kept for existing apps.
+
+20261017:  Version 2.19:  The temperature alarm limits are kept in a WLDConfigJournal (see WLDConfigJournal.h):  a
+    wear-leveled journal of CRC protected, sequence numbered records over EEPROM addresses 128..1983, which survives a
+    torn write and has room for more settings.  A change from the cloud is written 10 seconds after the last change,
+    and not at all if the limits are unchanged.  Limits that were saved at EEPROM address 100 by earlier versions are
+    loaded, and journaled, the first time this version runs.
+
+20261017:  Version 2.18:  Oversampled water sensor readings.  Each reading of a probe is the median of a burst of
+    WATER_OVERSAMPLING (5) ADC samples, which rejects spikes before the integrator sees them, so the integrators count
+    to 3 (ALARM_LIMIT, was 5) and to 2 (FAST_ALARM_LIMIT, was 3) with a lower false alarm rate than before (see
+    test/OversamplingTest.cpp).  The worst case detection latency is 110 ms.  The burst is read through the new
+    WLDHal::analogReadBurst().
+
+20261017:  Version 2.17:  Adaptive water sensor sampling.  The probes are read every WATER_SLOW_INTERVAL (100 ms)
+    while every reading is below WATER_NEAR_THRESHOLD (0.25 volts), and every WATER_FAST_INTERVAL (10 ms), counting to
+    FAST_ALARM_LIMIT (3) instead of ALARM_LIMIT, while any probe is near the threshold, counting or in alarm, until
+    WATER_CLEAR_SAMPLES quiet readings in a row.  Dry probes are read 10 times a second instead of 50, and the worst
+    case detection latency is 120 ms (100 ms before).  The new "WaterStats" cloud variable reports the sampling mode,
+    ADC reads per second, the detection time of the last leak and the worst case detection latency.
+
+20261017:  Version 2.16:  Predicted temperature alarms.  A WLDTrend (see WLDTrend.h) per zone fits the trend of the
+    last 30 and 60 minutes of raw readings, and the new predicted low and high temperature alarms are sent when a
+    zone is predicted to reach a temperature limit within PREDICTION_HORIZON (20 minutes), before the limit alarm.
+    The alarm value is the minutes to the limit.  The Zones cloud variable shows them as flags 8 and 16.
+
+20261017:  Version 2.15:  Rolling statistics of the temperature and humidity of every zone over the last minute, hour
+    and day:  lowest, highest, average, standard deviation and rate of change per hour, to spot slow freezes and
+    HVAC failures.  A WLDStats (see WLDStats.h) per zone and quantity takes each good (unsmoothed) reading in fixed
+    memory and constant time.  The new "Stats" cloud variable reports them, and the alarm logic can read them from
+    temperatureStats[] and humidityStats[].
+
+20261017:  Version 2.14:  The new "DewPoint" and "HeatIndex" cloud variables report the dew point and heat index
+    (degrees F) of zone 0, updated with every reading.  They are computed by WLDPsychrometrics in integer arithmetic,
+    within 0.05 F (dew point) and 0.13 F (heat index) of the double precision PietteTech_DHT functions, instead of
+    calling log() and pow() in software floating point.
+
+20261017:  Version 2.13:  Uses PietteTech_DHT 0.0.19, in which the DHT driver is a class template specialized at
+    compile time.  The sensor bus uses it without the 41 byte edge timing log that every PietteTech_DHT carries,
+    saving about 48 bytes of RAM per zone.
+
+20261017:  Version 2.12:  Uses PietteTech_DHT 0.0.18, which learns each sensor's 0/1 bit threshold and its data and
+    response timing windows from its good readings, instead of relying on fixed windows that are marginal on some
+    sensors and devices.  A zone whose reading failed is retried after 2 seconds rather than a full sample
+    interval.  The new "DhtStats" cloud variable reports, for each zone, the good readings, the count of each
+    error code, the learned timing and a histogram of the edge times, to tune and diagnose the sensors in the field.
+
+20261017:  Version 2.11:  Temperature and humidity can be monitored in several zones (rooms), each with its own DHT
+    sensor listed in DHT_ZONES.  A WLDSensorBus (see WLDSensorBus.h) reads the sensors one at a time so that their
+    interrupts never overlap, spreads the readings of the zones evenly over DHT_SAMPLE_INTERVAL, gives up on a
+    sensor that does not respond, and keeps smoothed readings per zone.  Zone 0 drives the servo meter and the
+    Temperature and Humidity cloud variables as before.  The low and high temperature alarms are present when any
+    zone is beyond a limit, and the sensor fault alarm when any zone's sensor has failed 5 readings in a row.  The
+    new "Zones" cloud variable reports "temperature/humidity/flags" for each zone.
+
+20261017:  Version 2.10:  Uses PietteTech_DHT 0.0.15, in which a DHT 11 reading never blocks.  Previously acquire()
+    held the start pulse with delay(18), stalling the water sensor sampling for 18 ms every 4 seconds, and begin()
+    delayed setup() by 1 second.  The pulse is now ended by the DHT poll task (every DHT_POLL_INTERVAL), so the
+    worst-case "dht" phase in LoopStats drops from about 18 ms to tens of microseconds.
+
+20261017:  Version 2.09:  loop() no longer polls a separate timer for every periodic job.  Each job (water sensors,
+    switches, DHT 11 start and completion, indicator, buzzer, loop statistics, heap) is a task function registered
+    with a WLDScheduler (see WLDScheduler.h) with its period.  loop() runs the tasks that are due, processes alarms
+    and publishes, and then waits until the next task is due instead of spinning.  Task deadlines advance by
+    exactly one period, so the water sample interval no longer drifts by the time each pass of loop() takes.  The
+    wait is reported as the "idle" phase in LoopStats.  The diff() function is replaced by the wrap-safe time
+    functions in WLDTime.h.
+
+20261017:  Version 2.08:  Alarms are table driven (see WLDAlarmProcessor.h).  Each new reading only reports whether
+    each alarm condition is present, with setCondition(), and loop() then calls service() once, which sends or re-arms
+    every alarm type in one pass; the alarm status string is updated at the same point.  The "dht" and "water" loop
+    phases no longer include alarm and status processing.  A water leak alarm is placed ahead of other waiting
+    events.  Failed DHT 11 readings are no longer smoothed into the temperature and humidity; 5 in a row raise the
+    new sensor fault alarm.  Fixed a high temperature alarm being sent on the first (bogus) DHT 11 reading.
+
+20261017:  Version 2.07:  Alarm events are no longer published from inside the leak sampling path.  The
+    WLDAlarmProcessor adds them to a WLDEventQueue (see WLDEventQueue.h), which loop() drains at the end of each
+    pass, at most one event per pass, only while the cloud is connected, and no faster than the cloud's limit of
+    1 event per second (burst of 4).  A waiting alarm of the same type is updated rather than duplicated, a
+    failed publish is retried, and waiting events are kept in retained memory so that they survive a reset.
+
+20261017:  Version 2.06:  The cloud variables (Info, Temperature, Humidity, Alarms and the alarm limits) are now
+    fixed-size char buffers instead of Strings.  Each is rewritten only when the value it shows changes: the
+    alarm status string is compared as a packed word on every water measurement and rebuilt only when an alarm
+    changes, and the temperature/humidity strings only when the displayed tenth changes.  The new "Heap" cloud
+    variable (see WLDHeapMonitor.h) reports heap use and free memory, their high/low-water marks, fragmented
+    free space, and the number of times heap use has grown after the first minute of uptime, which should stay 0.
+
+20261017:  Version 2.05:  Removed floating point math from the sensor pipeline; the Photon has no FPU.  The water
+    level threshold is computed at compile time in ADC counts (WLDFixedPoint.h), so water sensor readings are
+    never converted to volts.  Temperature and humidity are smoothed, limit-tested and displayed in fixed point
+    (1/256 degree), and the alarm limits are converted to fixed point only when they change instead of calling
+    toFloat() on every reading.
+
+20261017:  Version 2.04:  The hard-coded two-probe alarmIntegrator() is replaced by an instance of the WLDWaterSensors
+    class (see WLDWaterSensors.h), which thresholds and integrates any number of probes (up to 16), wired directly
+    to analog pins or through an analog multiplexer as listed in WATER_CHANNELS.  Each probe has its own integrator
+    and alarm state.  Any probe in alarm raises the water leak alarm, which clears when no probe is in alarm.  The
+    "Alarms" cloud variable now has one more field per probe after the leak alarm field.
+
+20261017:  Version 2.03:  Added loop profiling (see WLDLoopProfiler.h).  When turned on with the "LoopProfiler"
+    cloud function ("on", "off", "reset"), the duration of each phase of loop(), the time spent outside of loop(),
+    and the actual water sample interval and its jitter are recorded into log-scale histograms.  The cloud
+    variable "LoopStats" reports "phase:min/p50/p99/max" for each phase, in microseconds.  Note that the "dht"
+    and "water" phases include the alarm and status processing that they trigger.
+
+20261017:  Version 2.02:  All pin, time, servo, EEPROM and cloud access now goes through a WLDHal object (see
+    WLDHal.h) via the global "hal" pointer.  On the Photon, WLDHal simply forwards to Device OS.  A simulation
+    can derive from WLDHal and install itself before setup() in order to run and time loop(), alarmIntegrator(),
+    readDHT() and the WLDAlarmProcessor against a simulated clock, scripted inputs and a mock cloud.
+
 20221028:  Version 2.01:  Added a flag to not send out alarms on the first temp/Rh reading, because
     the DHT11 library gives a false reading the first time through.  This was a legacy bug which did
     not impact anything because there were no alarms.  Now, we got a low temperature alarm when the
@@ -73,12 +267,39 @@
 20170530a: Added Blynk application notification of water detection with Blynk Terminal and LED.
 ***********************************************************************************************************/
 #include <PietteTech_DHT.h> // non-blocking library for DHT11
+#include <WLDSensorBus.h>  // temperature/humidity sensors of every zone
 #include <WLDAlarmProcessor.h>  // the alarm processor class
+#include <WLDHal.h>  // hardware abstraction layer
+#include <WLDHalPhoton.h>  // hardware abstraction layer of the Photon
+#include <WLDLoopProfiler.h>  // loop phase timing histograms
+#include <WLDWaterSensors.h>  // water sensor probe thresholding and integration
+#include <WLDFixedPoint.h>  // integer and fixed-point sensor math
+#include <WLDHeapMonitor.h>  // heap high-water and fragmentation tracking
+#include <WLDEventQueue.h>  // rate limited, reset-proof outbound event queue
+#include <WLDScheduler.h>  // periodic task scheduler
+#include <WLDTime.h>  // wrap-safe time arithmetic
+#include <WLDStats.h>  // rolling temperature/humidity statistics
+#include <WLDTrend.h>  // temperature trend prediction
+#include <WLDConfigJournal.h>  // settings journal in EEPROM
+#include <WLDSpscQueue.h>  // lock-free queue from the sensing thread to loop()
+#include <WLDForensics.h>  // stall and reset record in retained memory
+#include <WLDTelemetry.h>  // batched, delta encoded telemetry publishing
+#include <WLDHistory.h>  // multi-resolution history of the readings
+#include <WLDThreshold.h>  // alarm threshold hysteresis and dwell
+#include <atomic>  // state shared by loop() and the sensing thread
+
+// keep unsent alarm events in retained memory so that they survive a reset
+STARTUP(System.enableFeature(FEATURE_RETAINED_MEMORY));
+
+// keep the reason for the last reset, for the forensics record
+STARTUP(System.enableFeature(FEATURE_RESET_INFO));
+
+// run the cloud connection in the system thread, so that neither loop() nor the sensing thread waits for it
+SYSTEM_THREAD(ENABLED);
 
 // Constants and definitions
+#define FIRMWARE_VERSION "2.26"
 #define DHTTYPE  DHT11              // Sensor type DHT11/21/22/AM2301/AM2302
-const int WATER_SENSOR_A_PIN = A0;
-const int WATER_SENSOR_B_PIN = A1;
 const int LED_PIN = D7;
 const int ALARM_PIN = D6;
 const int INDICATOR_PIN = D5;
@@ -86,9 +307,74 @@ const int BUTTON_PIN = D4;
 const int DHTPIN = D2;        	    // Digital pin for communications
 const int TOGGLE_PIN = D1;               // pin for temperature/humidity toggle switch
 const int SERVO_PIN = A5;                // servo pin
-#define DHT_SAMPLE_INTERVAL   4000  // Sample every 4 seconds
-#define PARTICLE_PUBLISH_INTERVAL 60000 // Publish values every 60 seconds
-const float WATER_LEVEL_THRESHOLD = 0.5;    // 0.5 volts or higher on either sensor triggers alarm
+#define DHT_SAMPLE_INTERVAL   4000  // Sample every zone every 4 seconds
+#define PARTICLE_PUBLISH_INTERVAL 60000 // Take a telemetry sample every 60 seconds
+#define TELEMETRY_WINDOW 15     // publish the telemetry samples 15 at a time (every 15 minutes)
+#define WATER_SLOW_INTERVAL 100    // 100 ms between water sensor readings while every probe is dry
+#define WATER_FAST_INTERVAL 10     // 10 ms between readings while a probe is near the threshold or wet
+#define WATER_CLEAR_SAMPLES 50     // 50 quiet fast readings (0.5 seconds) before reading slowly again
+#define WATER_STATS_INTERVAL 10000 // refresh the water sampling statistics every 10 seconds
+#define DHT_POLL_INTERVAL 20    // run the DHT sensor bus (end a start pulse, finish or start a reading) every 20 ms
+#define INPUT_READ_INTERVAL 5   // read the toggle switch and the mute pushbutton every 5 ms
+#define FLASH_INTERVAL 150  // the indicator flashes 150 ms on and off
+#define BEEP_INTERVAL 50    // the buzzer pulses 50 ms on and off
+#define MAX_IDLE_TIME 10    // never wait more than 10 ms for the next task, to keep publishing prompt
+#define LOOP_STATS_INTERVAL 1000   // refresh the loop statistics cloud variable every second while profiling
+#define HEAP_CHECK_INTERVAL 1000   // sample the heap every second
+#define HEAP_STEADY_STATE_TIME 60000   // heap growth is counted after the first 60 seconds of uptime
+#define DHT_FAULT_LIMIT 5   // consecutive failed DHT 11 readings that raise the sensor fault alarm
+#define CONFIG_SAVE_INTERVAL 1000   // check for settings to write to EEPROM every second
+#define CONFIG_JOURNAL_START 128    // EEPROM address of the settings journal
+#define CONFIG_JOURNAL_SIZE (29 * WLDConfigJournal::SLOT_SIZE)  // 29 records, to address 1983
+#define LEGACY_ALARM_LIMITS_ADDRESS 100     // EEPROM address of the alarm limits before version 2.19
+#define PREDICTION_HORIZON 1200000  // warn when a temperature limit is predicted to be reached within 20 minutes
+#define PREDICTION_DEADBAND 5       // a predicted alarm clears when the limit is 5 minutes beyond the horizon
+#define SENSING_THREAD_PRIORITY 1   // the sensing thread runs one priority above loop() and the system thread
+#define SENSING_THREAD_STACK 2048   // bytes of stack for the sensing thread
+#define WATER_EVENT_QUEUE_SIZE 16   // changes of the water alarms that can wait for loop(); a power of two
+#define INFO_INTERVAL 1000  // check every second for the time to be set, to write the Info cloud variable
+#define LOOP_STALL_BUDGET 100       // a loop() phase, or time between loop() calls, over 100 ms is a stall
+#define SENSING_STALL_BUDGET 20     // a sensing thread task, or a water sensor reading late, by over 20 ms is a stall
+#define WATCHDOG_TIMEOUT 60000      // reset when loop() has not come around for 60 seconds
+#define SENSING_WATCHDOG_TIMEOUT 5000   // reset when the sensing thread has not come around for 5 seconds
+#define FORENSICS_INTERVAL 1000     // check the sensing thread and refresh the forensics cloud variable every second
+#define HISTORY_SAMPLE_INTERVAL 5000    // add the readings to the history every 5 seconds
+#define HISTORY_RECENT_INTERVAL 10      // a recent history record every 10 seconds
+#define HISTORY_RECENT_BLOCKS 14        // about an hour of recent history with two probes (1808 bytes of retained memory)
+#define HISTORY_DAILY_INTERVAL 60       // a daily history record every minute
+#define HISTORY_DAILY_BLOCKS 56         // about a day of daily history with two probes
+const uint16_t WATER_LEVEL_THRESHOLD = voltsToAdcCounts(0.5);   // 0.5 volts or higher on any sensor triggers alarm
+                                                                //  (computed at compile time in ADC counts)
+const uint16_t WATER_NEAR_THRESHOLD = voltsToAdcCounts(0.25);  // 0.25 volts or higher on any sensor reads fast
+const byte ALARM_LIMIT = 3;     // 3 thresholds are required to trigger an alarm, then 3 under thresholds
+                                //  are required to reset the alarm condition.
+const byte FAST_ALARM_LIMIT = 2;    // while reading fast, 2 thresholds trigger an alarm and 2 under reset it
+const uint8_t WATER_OVERSAMPLING = 5;   // each water sensor reading is the median of 5 ADC samples
+
+// water sensor probe wiring.  Probes on an analog multiplexer list the analog pin the multiplexer
+//  output is read on and the multiplexer address of the probe, and the multiplexer address select
+//  pins are listed in WATER_MUX_SELECT_PINS (least significant bit first).
+const WLDWaterChannel WATER_CHANNELS[] = {
+    { A0, WLDWaterSensors::NO_MUX },    // sensor A
+    { A1, WLDWaterSensors::NO_MUX },    // sensor B
+};
+const int NUM_WATER_CHANNELS = sizeof(WATER_CHANNELS) / sizeof(WATER_CHANNELS[0]);
+const uint8_t * const WATER_MUX_SELECT_PINS = NULL;     // no multiplexer
+const int NUM_WATER_MUX_SELECT_PINS = 0;
+
+// temperature/humidity sensor wiring, one sensor per zone (room), each on its own interrupt capable pin.
+//  Zone 0 is the one shown on the servo meter and in the Temperature and Humidity cloud variables.
+const WLDDhtZone DHT_ZONES[] = {
+    { DHTPIN, DHTTYPE },    // zone 0
+};
+const int NUM_DHT_ZONES = sizeof(DHT_ZONES) / sizeof(DHT_ZONES[0]);
+
+// zone alarm flags, as shown in the Zones cloud variable
+const uint8_t ZONE_LOW_TEMP = 1;
+const uint8_t ZONE_HIGH_TEMP = 2;
+const uint8_t ZONE_SENSOR_FAULT = 4;
+const uint8_t ZONE_LOW_TEMP_PREDICTED = 8;
+const uint8_t ZONE_HIGH_TEMP_PREDICTED = 16;
 
 // servo calibration values
 const int MIN_POS = 5;  // the minimum position value allowed
@@ -104,111 +390,442 @@ const int LO_HUM = 0;  // based upon meter dial face for humidity (%RH)
 #define TEMP_RANGE (HI_TEMP - LO_TEMP)
 #define HUM_RANGE (HI_HUM - LO_HUM)
 
-// sensor return status codes
-const unsigned int ACQUIRING  = 0;
-const unsigned int COMPLETE_OK  = 1;
-const unsigned int COMPLETE_ERROR  = 2;
-
-// global to hold the result code from DHT sensor reading
-int dhtResultCode;
+// global to hold the smoothed values of humidity and temperature that we display and report, in fixed point
+fixed_t mg_smoothedTemp = 0, mg_smoothedHumidity = 0; // smoothed for the display
 
-// global to hold the smoothed values of humidity and temperature that we display and report
-float mg_smoothedTemp = 0.0, mg_smoothedHumidity = 0.0; // smoothed for the display
+// globals to hold the temperature alarm limits and deadbands in fixed point, recomputed only when they change
+fixed_t mg_lowTempLimit = 0, mg_highTempLimit = 0;
+fixed_t mg_lowTempDeadband = 0, mg_highTempDeadband = 0;
 
 // Lib instantiate
-PietteTech_DHT DHT(DHTPIN, DHTTYPE);    // create DHT object to read temp and humidity
-Servo myservo;  // create servo object to control a servo
+WLDSensorBus sensorBus;     // reads the temperature and humidity of every zone
+WLDStats temperatureStats[NUM_DHT_ZONES];   // rolling statistics of each zone's readings
+WLDStats humidityStats[NUM_DHT_ZONES];
+WLDTrend temperatureTrend[NUM_DHT_ZONES];   // trend of each zone's temperature, to predict temperature alarms
+WLDThreshold lowTempThresholds[NUM_DHT_ZONES];  // low temperature alarm condition of each zone
+WLDThreshold highTempThresholds[NUM_DHT_ZONES]; // high temperature alarm condition of each zone
+WLDThreshold lowPredictedThresholds[NUM_DHT_ZONES];     // predicted low temperature alarm condition of each zone
+WLDThreshold highPredictedThresholds[NUM_DHT_ZONES];    // predicted high temperature alarm condition of each zone
 WLDAlarmProcessor alarmer;  // create alarmer object to manage alarms
+#ifdef PLATFORM_ID
+WLDHalPhoton deviceHal;     // hardware abstraction layer that forwards to Device OS
+WLDHal *hal = &deviceHal;   // all hardware access goes through this pointer; a simulation can replace it
+#else
+WLDHal *hal = NULL;         // the host build (test/), which points it at its simulated device
+#endif
+WLDLoopProfiler profiler;   // per-phase loop timing, enabled from the cloud
+WLDWaterSensors waterSensors;   // all water sensor probes
+WLDHeapMonitor heapMonitor;     // heap usage tracking
+WLDEventQueue eventQueue;       // outbound cloud events
+retained WLDEventQueueStore eventQueueStore;    // the events waiting in eventQueue
+WLDScheduler scheduler;         // runs the periodic tasks of loop()
+WLDScheduler sensingScheduler;  // runs the periodic tasks of the sensing thread
+WLDLoopProfiler sensingProfiler;    // task timing of the sensing thread, enabled and reset with profiler
+WLDSpscQueue<uint16_t, WATER_EVENT_QUEUE_SIZE> waterEvents;    // new water alarm bits, from the sensing thread to loop()
+WLDConfigJournal configJournal; // settings in EEPROM
+WLDForensics forensics;         // stalls and resets
+retained WLDForensicsStore forensicsStore;  // the record of forensics
+WLDTelemetry telemetry;         // history of the readings, published in batches
+WLDHistory history;             // history of the readings, kept on the device
+retained WLDHistoryStore<HISTORY_RECENT_BLOCKS> recentHistoryStore;   // tier 0 of history, which survives a reset
+WLDHistoryStore<HISTORY_DAILY_BLOCKS> dailyHistoryStore;    // tier 1 of history
 
 // Globals
 
     // This global structure holds the temperature alarm limits.  The limits are cloud accessible for reading 
     //  via the cloud variable "currentAlarmLimits" by the app.  The alarm limites are set by the app via 
-    //  Particle.function() calls.  The latest values are stored in non-volitile EEPROM.
+    //  Particle.function() calls.  The latest values are stored in non-volitile EEPROM, in configJournal.
+    //  New settings may only be added at the end of the struct (see WLDConfigJournal.h), with their defaults.
 struct {
-  uint8_t version = 0;
-  int16_t tempAlarmLowLimit = -1;
-  int16_t tempAlarmHighLimit = -1;
+  int16_t tempAlarmLowLimit = -460;    // below absolute zero!
+  int16_t tempAlarmHighLimit = 1000;   // melts lead!
+  int16_t lowTempDeadband = 10;   // tenths of a degree F above the low limit that clear the low temperature alarm
+  int16_t highTempDeadband = 10;  // tenths of a degree F below the high limit that clear the high temperature alarm
+  uint16_t lowTempDwell = 60;     // seconds a low temperature must last to set, or be gone to clear, its alarm
+  uint16_t highTempDwell = 60;    // seconds a high temperature must last to set, or be gone to clear, its alarm
 } AlarmLimits;
 
 boolean ledState = false;   // D7 LED is used for indicating water level measurements
 
-    // These globals are for Particle.variable() data for cloud access by the app.
-String info = "";   // this string will hold the firmware version number and the last reset time.
-String temperature = "";   // this string will hold the currently averaged temperature
-String humidity = "";   // this string will hold the currently averaged humidity
-String currentAlarms = "0,0,0"; // this string holds the high temp alarm, low temp alarm, leak alarm
-                                //  in a comma separated format. 0 is no alarm, any other number is an
-                                //  alarm.
-String lowTempAlarmLimit = "";    // this string holds the low temp alarm limit
-String highTempAlarmLimit = "";   // this string holds the high temp alarm limit
+    // These globals are for Particle.variable() data for cloud access by the app.  They are fixed-size
+    //  buffers that are rewritten only when the value they show changes, so that keeping them up to date
+    //  never allocates from the heap.
+char info[96] = "";   // this string will hold the firmware version number and the last reset time.
+char temperature[16] = "";   // this string will hold the currently averaged temperature
+char humidity[16] = "";   // this string will hold the currently averaged humidity
+char dewPointString[16] = "";    // this string will hold the dew point of the averaged readings
+char heatIndexString[16] = "";   // this string will hold the heat index of the averaged readings
+char currentAlarms[8 + 2 * WLDWaterSensors::MAX_CHANNELS] = "0,0,0"; // this string holds the high temp alarm,
+                                //  low temp alarm, leak alarm in a comma separated format. 0 is no alarm, any
+                                //  other number is an alarm.  The leak alarm is followed by one field per water
+                                //  sensor probe.
+char lowTempAlarmLimit[8] = "";    // this string holds the low temp alarm limit
+char highTempAlarmLimit[8] = "";   // this string holds the high temp alarm limit
+char alarmHysteresis[32] = "";  // this string holds the low and high temp alarm deadbands (tenths of a degree F)
+                                //  and dwells (seconds), comma separated
+char loopStats[600] = "";   // this string holds the loop phase timing summary: phase:min/p50/p99/max (microseconds)
+char heapStats[96] = "";    // this string holds the heap usage summary
+char zoneStatus[24 * WLDSensorBus::MAX_ZONES] = "";  // this string holds temperature/humidity/alarm flags for each
+                                //  zone, comma separated.  The flags are 1 for low temp, 2 for high temp, 4 for
+                                //  sensor fault, 8 for predicted low temp and 16 for predicted high temp.
+char statsString[600] = "";    // this string holds the rolling statistics of each zone; see writeStatsString()
+char waterStats[96] = "";  // this string holds the water sensor sampling statistics; see waterStatsTask()
+char stateString[128] = "";   // this string holds the state snapshot; see writeStateString()
+char forensicsString[600] = "";    // this string holds the stall and reset record; see WLDForensics::format()
+char historyString[600] = "";   // this string holds a page of history; see historyCommand()
+char dhtStats[600] = "";    // this string holds the DHT timing statistics of each zone; see WLDSensorBus::format()
+
+    // These globals hold the state that the sensing thread tasks share; loop() only reads waterFast
+boolean mute = false;  // set to true to mute the audible alarm
+boolean indicator = false;  // set to true to flash the indicator
+boolean soundAlarm = false;   // set to true to sound the alarm
+int waterTaskNumber = -1;   // sensing thread task that reads the water sensors
+std::atomic<bool> waterFast(false);     // the water sensors are read every WATER_FAST_INTERVAL; loop() reads it
+uint16_t sentWaterAlarmBits = 0;    // water alarm bits last queued for loop()
+volatile unsigned long sensingHeartbeat = 0;    // time the sensing thread last came around, for its watchdog
+
+    // These globals pass the requests of the LoopProfiler cloud function to the sensing thread, which alone enables
+    //  and resets sensingProfiler
+std::atomic<int> sensingProfilerEnable(-1);     // 1 to enable, 0 to disable, -1 for no request
+std::atomic<bool> sensingProfilerReset(false);  // true to reset
+
+    // These globals hold the state that the loop() tasks share
+boolean toggle = false;  // hold the reading of the toggle switch; false for humidity, true for temperature
+boolean lastToggle = false;  // hold the previous reading of the toggle switch
+int32_t lastTemperatureTenths = 0;   // displayed value of the temperature string
+int32_t lastHumidityTenths = 0;      // displayed value of the humidity string
+int32_t lastDewPointTenths = 0;      // displayed value of the dew point string
+int32_t lastHeatIndexTenths = 0;     // displayed value of the heat index string
+bool newAlarmData = false;  // set when a new reading has updated an alarm condition
 
 struct {
     bool lowTempAlarm;
     bool highTempAlarm;
     bool waterLeakAlarm;
+    uint16_t waterLeakChannels;     // bit n is set when water sensor probe n is in alarm
 } Alarms;
 
 
 // Utility functions
 
-// create a string of the current date-time in UTC
-String dateTimeString(){
-    time_t timeNow = Time.now();
-    String dateTime = Time.format(timeNow,TIME_FORMAT_DEFAULT) + " UTC";
+// create a string of a date-time in UTC
+String dateTimeString(time_t time){
+    String dateTime = Time.format(time,TIME_FORMAT_DEFAULT) + " UTC";
     return dateTime;
 }   // end of dateTimeString()
 
+// write a fixed-point reading into a cloud variable buffer if its displayed value has changed
+void writeReadingString(char *buffer, size_t size, fixed_t value, int32_t *lastTenths) {
+    int32_t tenths = fixedToTenths(value);
+
+    if(tenths != *lastTenths || buffer[0] == '\0') {
+        formatFixed(buffer, size, value);
+        *lastTenths = tenths;
+    }
+}   // end of writeReadingString()
+
 // cloud function to write alarm limits to the struct
 int writeValue(String data) {
-  for(int i = 0; i < data.length(); i++) {
+  for(unsigned int i = 0; i < data.length(); i++) {
     if(data.charAt(i) == ',') {
       AlarmLimits.tempAlarmLowLimit = (int16_t)(data.substring(0, i).toInt());
       AlarmLimits.tempAlarmHighLimit = (int16_t)(data.substring(i+1).toInt());
     }
   }
-  EEPROMwrite();  // call function to write struct to the EEPROM
+  configJournal.save(&AlarmLimits, sizeof(AlarmLimits), hal->millis());  // written to EEPROM by configTask()
   displayData();  // copy the struct data into the cloud variable string
+  writeStateString();
   return 0;
-}   // end of EEPROMwrite
-
-// function to store struct to EEPROM
-void EEPROMwrite() {
-  EEPROM.put(100, AlarmLimits);
-  return;
-}
+}   // end of writeValue
+
+// cloud function to write the temperature alarm deadbands and dwells to the struct:
+//  "<low deadband>,<high deadband>,<low dwell>,<high dwell>", in tenths of a degree F and seconds
+int writeHysteresis(String data) {
+  long values[4];
+  int start = 0;
+
+  for(int i = 0; i < 4; i++) {
+    int comma = data.indexOf(',', start);
+    if((comma < 0) != (i == 3)) {
+      return -1;  // not four values
+    }
+    values[i] = (comma < 0) ? data.substring(start).toInt() : data.substring(start, comma).toInt();
+    start = comma + 1;
+  }
+  if(values[0] < 0 || values[0] > 200 || values[1] < 0 || values[1] > 200 ||
+     values[2] < 0 || values[2] > 3600 || values[3] < 0 || values[3] > 3600) {
+    return -1;  // deadbands of up to 20 degrees and dwells of up to an hour
+  }
+  AlarmLimits.lowTempDeadband = (int16_t)values[0];
+  AlarmLimits.highTempDeadband = (int16_t)values[1];
+  AlarmLimits.lowTempDwell = (uint16_t)values[2];
+  AlarmLimits.highTempDwell = (uint16_t)values[3];
+  configJournal.save(&AlarmLimits, sizeof(AlarmLimits), hal->millis());  // written to EEPROM by configTask()
+  displayData();  // copy the struct data into the cloud variable string
+  return 0;
+}   // end of writeHysteresis
+
+// read the settings from the journal in EEPROM; the first time, take them from where versions before 2.19
+//  kept them, if they were ever written there, and journal them
+void loadSettings() {
+    struct {
+        uint8_t version;    // 0 once written; erased EEPROM reads 0xff
+        int16_t tempAlarmLowLimit;
+        int16_t tempAlarmHighLimit;
+    } legacy;
+
+    configJournal.begin(hal, CONFIG_JOURNAL_START, CONFIG_JOURNAL_SIZE);
+    if(configJournal.load(&AlarmLimits, sizeof(AlarmLimits)) == true) {
+        return;
+    }
+    hal->eepromRead(LEGACY_ALARM_LIMITS_ADDRESS, &legacy, sizeof(legacy));
+    if(legacy.version == 0) {
+        AlarmLimits.tempAlarmLowLimit = legacy.tempAlarmLowLimit;
+        AlarmLimits.tempAlarmHighLimit = legacy.tempAlarmHighLimit;
+        configJournal.save(&AlarmLimits, sizeof(AlarmLimits), hal->millis());
+        configJournal.flush();
+    }
+}   // end of loadSettings()
 
 // Cloud function to read object data into a string
 void displayData() {
-  lowTempAlarmLimit = String(AlarmLimits.tempAlarmLowLimit);
-  highTempAlarmLimit = String(AlarmLimits.tempAlarmHighLimit);
+  snprintf(lowTempAlarmLimit, sizeof(lowTempAlarmLimit), "%d", AlarmLimits.tempAlarmLowLimit);
+  snprintf(highTempAlarmLimit, sizeof(highTempAlarmLimit), "%d", AlarmLimits.tempAlarmHighLimit);
+  mg_lowTempLimit = intToFixed(AlarmLimits.tempAlarmLowLimit);
+  mg_highTempLimit = intToFixed(AlarmLimits.tempAlarmHighLimit);
+  snprintf(alarmHysteresis, sizeof(alarmHysteresis), "%d,%d,%u,%u", AlarmLimits.lowTempDeadband,
+           AlarmLimits.highTempDeadband, AlarmLimits.lowTempDwell, AlarmLimits.highTempDwell);
+  mg_lowTempDeadband = tenthsToFixed(AlarmLimits.lowTempDeadband);
+  mg_highTempDeadband = tenthsToFixed(AlarmLimits.highTempDeadband);
   return;
 }   // end of displayData()
 
-// write the cloud accessible variable string that contains the current alarms
+// write the cloud accessible variable string that contains the current alarms, if any alarm has changed
 void writeAlarmStatusString() {
-    currentAlarms = "";
-    if(Alarms.lowTempAlarm == false) {
-        currentAlarms += "0";
-    } else {
-        currentAlarms += "1";
+    static uint32_t lastStatus = 0xffffffff;    // alarm state that the string was last written for
+    uint32_t status;
+    int length;
+
+    // pack all of the alarm flags into one word so that a change can be detected with one compare
+    status = (Alarms.lowTempAlarm ? 1 : 0) | (Alarms.highTempAlarm ? 2 : 0) | (Alarms.waterLeakAlarm ? 4 : 0);
+    status |= (uint32_t)Alarms.waterLeakChannels << 3;
+    if(status == lastStatus) {
+        return;     // nothing has changed
+    }
+    lastStatus = status;
+
+    currentAlarms[0] = Alarms.lowTempAlarm ? '1' : '0';
+    currentAlarms[1] = ',';
+    currentAlarms[2] = Alarms.highTempAlarm ? '1' : '0';
+    currentAlarms[3] = ',';
+    currentAlarms[4] = Alarms.waterLeakAlarm ? '1' : '0';
+    length = 5;
+
+    for(int channel = 0; channel < NUM_WATER_CHANNELS; channel++) {
+        currentAlarms[length++] = ',';
+        currentAlarms[length++] = (Alarms.waterLeakChannels & (1 << channel)) ? '1' : '0';
     }
-    currentAlarms += ",";
+    currentAlarms[length] = '\0';
 
-    if(Alarms.highTempAlarm == false) {
-        currentAlarms += "0";
-    } else {
-        currentAlarms += "1";
+}   // end of writeAlarmStatusString
+
+// update the temperature alarm conditions of one zone from its readings, with the deadband and dwell of each alarm
+void updateZoneAlarms(int zone) {
+    unsigned long now = hal->millis();
+    fixed_t temperature = sensorBus.temperature(zone);
+    fixed_t horizon = intToFixed(PREDICTION_HORIZON / 60000);   // minutes
+
+    // the first reading after a reset is not trusted, so no alarm until the second good reading
+    if(sensorBus.readings(zone) < 2) {
+        return;
+    }
+    lowTempThresholds[zone].update(temperature, mg_lowTempLimit, mg_lowTempDeadband,
+                                   AlarmLimits.lowTempDwell * 1000UL, now);
+    highTempThresholds[zone].update(temperature, mg_highTempLimit, mg_highTempDeadband,
+                                    AlarmLimits.highTempDwell * 1000UL, now);
+
+    // a limit is predicted when the temperature trend will reach it within the horizon (in minutes)
+    lowPredictedThresholds[zone].update(intToFixed(temperatureTrend[zone].timeToFall(mg_lowTempLimit, now) / 60000),
+                                        horizon, intToFixed(PREDICTION_DEADBAND),
+                                        AlarmLimits.lowTempDwell * 1000UL, now);
+    highPredictedThresholds[zone].update(intToFixed(temperatureTrend[zone].timeToRise(mg_highTempLimit, now) / 60000),
+                                         horizon, intToFixed(PREDICTION_DEADBAND),
+                                         AlarmLimits.highTempDwell * 1000UL, now);
+}   // end of updateZoneAlarms()
+
+// minutes to a predicted limit, as its alarm reports them.  A zone keeps its predicted alarm through the dwell and
+//  deadband after its trend stops reaching the limit (NEVER), so the minutes are held at the far edge of the deadband
+unsigned long predictedMinutes(unsigned long time) {
+    const unsigned long longest = PREDICTION_HORIZON / 60000 + PREDICTION_DEADBAND;
+
+    return (time / 60000 < longest) ? time / 60000 : longest;
+}   // end of predictedMinutes()
+
+// find the alarms of one temperature/humidity zone
+uint8_t zoneAlarmFlags(int zone) {
+    uint8_t flags = 0;
+
+    if(lowTempThresholds[zone].present() == true) {
+        flags |= ZONE_LOW_TEMP;
+    }
+    if(highTempThresholds[zone].present() == true) {
+        flags |= ZONE_HIGH_TEMP;
     }
-    currentAlarms += ",";  
 
-    if(Alarms.waterLeakAlarm == false) {
-        currentAlarms += "0";
+    // a predicted limit is an alarm until the limit alarm is present
+    if((flags & ZONE_LOW_TEMP) == 0 && lowPredictedThresholds[zone].present() == true) {
+        flags |= ZONE_LOW_TEMP_PREDICTED;
+    }
+    if((flags & ZONE_HIGH_TEMP) == 0 && highPredictedThresholds[zone].present() == true) {
+        flags |= ZONE_HIGH_TEMP_PREDICTED;
+    }
+    if(sensorBus.errors(zone) >= DHT_FAULT_LIMIT) {
+        flags |= ZONE_SENSOR_FAULT;
+    }
+    return flags;
+}   // end of zoneAlarmFlags()
+
+// write the cloud accessible variable string that holds the readings and alarms of every zone
+void writeZoneStatusString() {
+    char temp[16], hum[16];
+    const char *t, *h;
+    int length = 0;
+
+    for(int zone = 0; zone < sensorBus.numZones(); zone++) {
+        if(sensorBus.readings(zone) == 0) {     // no good reading yet
+            t = "-";
+            h = "-";
+        } else {
+            formatFixed(temp, sizeof(temp), sensorBus.temperature(zone));
+            formatFixed(hum, sizeof(hum), sensorBus.humidity(zone));
+            for(t = temp; *t == ' '; t++);  // skip the padding
+            for(h = hum; *h == ' '; h++);
+        }
+        length += snprintf(zoneStatus + length, sizeof(zoneStatus) - length, "%s%s/%s/%d",
+                           (zone == 0) ? "" : ",", t, h, zoneAlarmFlags(zone));
+        if(length >= (int)sizeof(zoneStatus)) {
+            break;
+        }
+    }
+}   // end of writeZoneStatusString
+
+// write the cloud accessible variable string that holds a snapshot of all of the current state, if it has
+//  changed since the last snapshot:
+//      "1,<sequence>,<uptime>,<firmware>,<alarms>,<leaks>,<temperature>,<humidity>,<low limit>,<high limit>,
+//       <sensor status>,<sensor errors>"
+//  1 is the format version; fields will only be added at the end.  The sequence number counts the snapshots, and
+//  the uptime (seconds) is that of the snapshot.  <alarms> is hex, with bit n set when the condition of
+//  WLDAlarmType n is present; <leaks> is hex, with bit n set when water sensor probe n is in alarm.  The
+//  temperature (F) and humidity (%RH) are those of zone 0, smoothed, or "-" before its first good reading.  The
+//  sensor status is the DHTLIB status of its last reading, and the errors are its consecutive failed readings.
+void writeStateString() {
+    static uint32_t sequence = 0;
+    static struct {
+        uint32_t alarms;
+        uint16_t leaks;
+        int32_t temperatureTenths;
+        int32_t humidityTenths;
+        int16_t lowLimit;
+        int16_t highLimit;
+        int16_t sensorStatus;
+        int16_t sensorErrors;
+        bool haveReading;
+    } last, current;
+    char temp[16], hum[16];
+    const char *t = "-", *h = "-";
+
+    memset(&current, 0, sizeof(current));   // so that the padding compares equal too
+    current.alarms = alarmer.conditions();
+    current.leaks = Alarms.waterLeakChannels;
+    current.haveReading = sensorBus.readings(0) > 0;
+    if(current.haveReading == true) {
+        current.temperatureTenths = fixedToTenths(mg_smoothedTemp);
+        current.humidityTenths = fixedToTenths(mg_smoothedHumidity);
+    }
+    current.lowLimit = AlarmLimits.tempAlarmLowLimit;
+    current.highLimit = AlarmLimits.tempAlarmHighLimit;
+    current.sensorStatus = sensorBus.status(0);
+    current.sensorErrors = sensorBus.errors(0);
+    if(stateString[0] != '\0' && memcmp(&current, &last, sizeof(current)) == 0) {
+        return;     // nothing has changed
+    }
+    last = current;
+    sequence++;
+
+    if(current.haveReading == true) {
+        formatFixed(temp, sizeof(temp), mg_smoothedTemp);
+        formatFixed(hum, sizeof(hum), mg_smoothedHumidity);
+        for(t = temp; *t == ' '; t++);  // skip the padding
+        for(h = hum; *h == ' '; h++);
+    }
+    snprintf(stateString, sizeof(stateString), "1,%lu,%lu,%s,%lx,%x,%s,%s,%d,%d,%d,%d",
+             (unsigned long)sequence, hal->millis() / 1000, FIRMWARE_VERSION,
+             (unsigned long)current.alarms, current.leaks, t, h, current.lowLimit, current.highLimit,
+             current.sensorStatus, current.sensorErrors);
+}   // end of writeStateString
+
+// write the cloud accessible variable string that holds the rolling statistics of every zone:
+//  "T:<temperature stats> H:<humidity stats>" for each zone, separated by ";", where the stats
+//  are "window:lowest/highest/average/deviation/rate per hour" for the 1m, 1h and 1d windows
+void writeStatsString() {
+    int length = 0;
+
+    statsString[0] = '\0';
+    for(int zone = 0; zone < NUM_DHT_ZONES && length < (int)sizeof(statsString); zone++) {
+        length += snprintf(statsString + length, sizeof(statsString) - length, "%sT:",
+                           (zone == 0) ? "" : ";");
+        if(length < (int)sizeof(statsString)) {
+            length += temperatureStats[zone].format(statsString + length, sizeof(statsString) - length);
+        }
+        if(length < (int)sizeof(statsString)) {
+            length += snprintf(statsString + length, sizeof(statsString) - length, " H:");
+        }
+        if(length < (int)sizeof(statsString)) {
+            length += humidityStats[zone].format(statsString + length, sizeof(statsString) - length);
+        }
+    }
+}   // end of writeStatsString
+
+// Cloud function to control loop profiling: "on", "off" or "reset".  The sensing thread profiler takes the
+//  request at the start of its next pass (see sensingPass())
+int loopProfiler(String command) {
+    if(command == "on") {
+        profiler.enable(true);
+        sensingProfilerEnable.store(1);
+    } else if(command == "off") {
+        profiler.enable(false);
+        sensingProfilerEnable.store(0);
+    } else if(command == "reset") {
+        profiler.reset();
+        sensingProfilerReset.store(true);
+        loopStats[0] = '\0';
     } else {
-        currentAlarms += "1";
+        return -1;  // unknown command
+    }
+    return 0;
+}   // end of loopProfiler
+
+// Cloud function to clear the stall and reset record: "clear"
+int forensicsCommand(String command) {
+    if(command == "clear") {
+        forensics.clear();
+        forensics.format(forensicsString, sizeof(forensicsString));
+        return 0;
     }
+    return -1;  // unknown command
+}   // end of forensicsCommand
 
-}   // end of writeAlarmStatusString
+// Cloud function to write a page of history into the History cloud variable: "<tier>,<from Unix time>".
+//  Returns the number of records in the page; the page ends with the time to ask for the next page from.
+int historyCommand(String command) {
+    int comma = command.indexOf(',');
+
+    if(comma < 0) {
+        return -1;
+    }
+    return history.format(historyString, sizeof(historyString), command.substring(0, comma).toInt(),
+                          (uint32_t)command.substring(comma + 1).toInt());
+}   // end of historyCommand
 
 // Cloud function to send out a test alarm
 int testAlarm(String nothing) {
@@ -220,62 +837,216 @@ int testAlarm(String nothing) {
 
 // setup()
 void setup() {
-    pinMode(LED_PIN, OUTPUT);
-    pinMode(ALARM_PIN, OUTPUT);
-    pinMode(INDICATOR_PIN, OUTPUT);
-    pinMode(BUTTON_PIN, INPUT_PULLUP);
-    pinMode(TOGGLE_PIN, INPUT_PULLUP);  // toggle switch uses an internal pullup
-    myservo.attach(SERVO_PIN);  // attaches to the servo object
-
-    DHT.begin();
-    alarmer.begin();
+    // count this boot and keep the reason for the reset, before anything can stall
+    forensics.begin(hal, &forensicsStore);
+    forensics.format(forensicsString, sizeof(forensicsString));
+
+    hal->pinMode(LED_PIN, OUTPUT);
+    hal->pinMode(ALARM_PIN, OUTPUT);
+    hal->pinMode(INDICATOR_PIN, OUTPUT);
+    hal->pinMode(BUTTON_PIN, INPUT_PULLUP);
+    hal->pinMode(TOGGLE_PIN, INPUT_PULLUP);  // toggle switch uses an internal pullup
+    hal->servoAttach(SERVO_PIN);  // attaches to the servo object
+
+    sensorBus.begin(hal, DHT_ZONES, NUM_DHT_ZONES, DHT_SAMPLE_INTERVAL);
+    for(int zone = 0; zone < NUM_DHT_ZONES; zone++) {
+        temperatureStats[zone].begin(hal->millis());
+        humidityStats[zone].begin(hal->millis());
+        temperatureTrend[zone].begin();
+        lowTempThresholds[zone].begin(THRESHOLD_BELOW);
+        highTempThresholds[zone].begin(THRESHOLD_ABOVE);
+        lowPredictedThresholds[zone].begin(THRESHOLD_BELOW);
+        highPredictedThresholds[zone].begin(THRESHOLD_BELOW);   // below the horizon, in minutes to the limit
+    }
+    eventQueue.begin(hal, hal, &eventQueueStore);  // the HAL publishes the queued events
+    alarmer.begin(hal, &eventQueue);
+    telemetry.begin(hal, hal, &eventQueue, "WLDTelemetry", NUM_WATER_CHANNELS, TELEMETRY_WINDOW);
+    history.begin(hal, NUM_WATER_CHANNELS);
+    history.addTier(&recentHistoryStore, HISTORY_RECENT_INTERVAL);
+    history.addTier(&dailyHistoryStore, HISTORY_DAILY_INTERVAL);
+    heapMonitor.begin(hal);
+    waterSensors.begin(hal, WATER_CHANNELS, NUM_WATER_CHANNELS, WATER_MUX_SELECT_PINS,
+                       NUM_WATER_MUX_SELECT_PINS, WATER_LEVEL_THRESHOLD, ALARM_LIMIT);
+    waterSensors.setOversampling(WATER_OVERSAMPLING);
+    waterSensors.setAdaptive(WATER_NEAR_THRESHOLD, FAST_ALARM_LIMIT, WATER_CLEAR_SAMPLES);
+    profiler.begin(hal, WATER_SLOW_INTERVAL);
+    sensingProfiler.begin(hal, WATER_SLOW_INTERVAL);
+    profiler.setStallMonitor(&forensics, THREAD_LOOP, LOOP_STALL_BUDGET * 1000UL);
+    sensingProfiler.setStallMonitor(&forensics, THREAD_SENSING, SENSING_STALL_BUDGET * 1000UL);
+    waterEvents.begin();
+
+    // the periodic tasks of the sensing thread, in the order they run when due at the same time
+    sensingScheduler.begin(hal);
+    waterTaskNumber = sensingScheduler.addTask(waterTask, WATER_SLOW_INTERVAL);
+    sensingScheduler.addTask(muteButtonTask, INPUT_READ_INTERVAL);
+    sensingScheduler.addTask(indicatorTask, FLASH_INTERVAL);
+    sensingScheduler.addTask(buzzerTask, BEEP_INTERVAL);
+
+    // the periodic tasks of loop(), in the order they run when due at the same time
+    scheduler.begin(hal);
+    scheduler.addTask(readInputsTask, INPUT_READ_INTERVAL);
+    scheduler.addTask(dhtTask, DHT_POLL_INTERVAL);
+    scheduler.addTask(loopStatsTask, LOOP_STATS_INTERVAL);
+    scheduler.addTask(heapTask, HEAP_CHECK_INTERVAL);
+    scheduler.addTask(waterStatsTask, WATER_STATS_INTERVAL);
+    scheduler.addTask(configTask, CONFIG_SAVE_INTERVAL);
+    scheduler.addTask(infoTask, INFO_INTERVAL);
+    scheduler.addTask(forensicsTask, FORENSICS_INTERVAL);
+    scheduler.addTask(telemetryTask, PARTICLE_PUBLISH_INTERVAL);
+    scheduler.addTask(historyTask, HISTORY_SAMPLE_INTERVAL);
 
     // declare Cloud variables and functions
     Particle.variable("Info", info);
+    Particle.variable("State", stateString);
     Particle.variable("Temperature", temperature);
     Particle.variable("Humidity", humidity);
+    Particle.variable("DewPoint", dewPointString);
+    Particle.variable("HeatIndex", heatIndexString);
     Particle.variable("Alarms", currentAlarms);
     Particle.variable("LowTempAlarmLimit", lowTempAlarmLimit);  
     Particle.variable("HighTempAlarmLimit", highTempAlarmLimit);
+    Particle.variable("AlarmHysteresis", alarmHysteresis);
+    Particle.variable("LoopStats", loopStats);
+    Particle.variable("Heap", heapStats);
+    Particle.variable("Zones", zoneStatus);
+    Particle.variable("DhtStats", dhtStats);
+    Particle.variable("WaterStats", waterStats);
+    Particle.variable("Stats", statsString);
+    Particle.variable("Forensics", forensicsString);
+    Particle.variable("History", historyString);
 
     Particle.function("SetTempAlarmLimits", writeValue);
+    Particle.function("SetAlarmHysteresis", writeHysteresis);
     Particle.function("Send a test alarm", testAlarm);
+    Particle.function("LoopProfiler", loopProfiler);
+    Particle.function("Forensics", forensicsCommand);
+    Particle.function("History", historyCommand);
 
-    // set the information global
-    info = "Firmware Verison 2.01. Last reset at: ";
-    info += dateTimeString();
+    // set the information global; infoTask() adds the reset time once the time is set
+    snprintf(info, sizeof(info), "Firmware Verison " FIRMWARE_VERSION ".");
 
     // clear out alarm structure
     Alarms.lowTempAlarm = false;
     Alarms.highTempAlarm = false;
     Alarms.waterLeakAlarm = false;
+    Alarms.waterLeakChannels = 0;
+    writeAlarmStatusString();
 
-    // read the temp alarm limits from EEPROM into the struct and set the global variables
-    EEPROM.get(100, AlarmLimits);
-    if(AlarmLimits.version != 0) {  // EEPROM never written
-        // set some defaults
-        AlarmLimits.tempAlarmLowLimit = -460; // below absolute zero!
-        AlarmLimits.tempAlarmHighLimit = 1000;  // melts lead!
-    }
+    // read the temp alarm limits from EEPROM into the struct (which holds the defaults) and set the global variables
+    loadSettings();
     displayData();
 
+    // everything that the sensing thread uses is set up; start it, and the watchdog of loop()
+    sensingHeartbeat = hal->millis();
+    hal->startThread("sensing", sensingThread, NULL, SENSING_THREAD_PRIORITY, SENSING_THREAD_STACK);
+    hal->startWatchdog(WATCHDOG_TIMEOUT, watchdogExpired);
+
 }  // end of setup()
 
 
 // loop()
 void loop() {
-    static boolean mute = false;  // set to true to mute the audible alarm
-    static boolean indicator = false;  // set to true to flash the indicator
-    static boolean alarm = false;   // set to true to sound the alarm
-    static unsigned long lastReadTime = 0UL;    // DHT 11 reading time
-    static boolean newData = false; // flag to indicate DHT11 has new data
-    static boolean toggle = false;  // hold the reading of the toggle switch; false for humidity, true for temperature
-    static boolean lastToggle = false;  // hold the previous reading of the toggle switch
-    static bool firstTimeRead = true;  // special handing for first time reading
-    float currentTemp, currentHumidity;
+    profiler.beginLoop();
+
+    // run every task that is due
+    scheduler.run();
+
+    // take in the water alarm changes from the sensing thread
+    profiler.start(PHASE_WATER);
+    receiveWaterEvents();
+    profiler.stop(PHASE_WATER);
+
+    // send or re-arm every alarm, and update the alarm status string, once per pass with new readings
+    if(newAlarmData == true) {
+        profiler.start(PHASE_ALARMS);
+        alarmer.service();
+        profiler.stop(PHASE_ALARMS);
+        profiler.start(PHASE_STATUS);
+        writeAlarmStatusString();   // update the alarm status global string
+        writeStateString();         // and the state snapshot
+        profiler.stop(PHASE_STATUS);
+        newAlarmData = false;
+    }
+
+    // publish a queued event, if any, or else a window of telemetry, once the time critical work is done
+    profiler.start(PHASE_PUBLISH);
+    eventQueue.process();
+    telemetry.process();
+    profiler.stop(PHASE_PUBLISH);
+    profiler.endLoop();
+
+    // wait for the next task to be due instead of spinning
+    profiler.beginIdle();
+    scheduler.idle(MAX_IDLE_TIME);
+    profiler.endIdle();
+
+} // end of loop()
+
+/* sensingThread():  the sensing thread; runs the tasks of sensingScheduler, waiting between them
+    parameters:
+        arg:  not used
+*/
+void sensingThread(void *arg) {
+    for(;;) {
+        sensingPass();
+        sensingScheduler.idle(WATER_SLOW_INTERVAL);
+    }
+}   // end of sensingThread()
+
+/* sensingPass():  one pass of the sensing thread:  take the profiler requests of loopProfiler(), so that only this
+                   thread touches sensingProfiler, and run the tasks of sensingScheduler that are due
+    parameters: none
+*/
+void sensingPass() {
+    sensingHeartbeat = hal->millis();
+
+    int enable = sensingProfilerEnable.exchange(-1);
+    if(enable >= 0) {
+        sensingProfiler.enable(enable == 1);
+    }
+    if(sensingProfilerReset.exchange(false) == true) {
+        sensingProfiler.reset();
+    }
+
+    sensingScheduler.run();
+}   // end of sensingPass()
+
+/* watchdogExpired():  called by the application watchdog, in a thread of its own, when loop() has not come
+                       around for WATCHDOG_TIMEOUT; records the phase that never ended and resets the device
+    parameters: none
+*/
+void watchdogExpired() {
+    forensics.resetForStall(THREAD_LOOP, profiler.currentPhase(), WATCHDOG_TIMEOUT);
+}   // end of watchdogExpired()
+
+/* receiveWaterEvents():  take the water alarm changes queued by the sensing thread, and set the water
+                          leak alarm condition from the newest one
+    parameters: none
+*/
+void receiveWaterEvents() {
+    uint16_t alarmBits;
+    bool received = false;
+
+    while(waterEvents.pop(&alarmBits) == true) {
+        Alarms.waterLeakChannels = alarmBits;
+        received = true;
+    }
+    if(received == true) {
+        Alarms.waterLeakAlarm = (Alarms.waterLeakChannels != 0);
+        alarmer.setCondition(ALARM_WATER_LEAK, Alarms.waterLeakAlarm);
+        newAlarmData = true;
+    }
+    return;
+}   // end of receiveWaterEvents()
+
+/* readInputsTask():  task to read the temperature/humidity toggle switch
+    parameters: none
+*/
+void readInputsTask() {
+    profiler.start(PHASE_OUTPUTS);
 
     //  read the toggle switch position and set the boolean for type of display accordingly
-    if(digitalRead(TOGGLE_PIN) == LOW)  {   // indicates a temperature reading
+    if(hal->digitalRead(TOGGLE_PIN) == LOW)  {   // indicates a temperature reading
         toggle = true;
     } else {
         toggle = false;
@@ -291,299 +1062,373 @@ void loop() {
         }
     }
 
-    // Non-blocking read of DHT11 data and publish and display it
-    int sensorStatus = readDHT(false);  // refresh the sensor status but don't start a new reading
-
-	if(sensorStatus != ACQUIRING) {
-        if(newData == true) { // we have new data
-            currentTemp = DHT.getFahrenheit();
-            currentHumidity = DHT.getHumidity();
-
-            // Smooth the readings for display
-            if (mg_smoothedTemp < 10) {   // first time init
-                mg_smoothedTemp = currentTemp;
-            }
-            if (mg_smoothedHumidity < 10){  // first time init
-                mg_smoothedHumidity = currentHumidity;
-            }
-            
-            // 10 point moving average
-            mg_smoothedTemp =  (0.9 * mg_smoothedTemp) +  (0.1 * currentTemp);
-            mg_smoothedHumidity =  (0.9 * mg_smoothedHumidity) +  (0.1 * currentHumidity);
-
-	        // set temperature or humidiy on the servo meter
-	        if(toggle == true)  {   // temperature reading called for
-	            meterTemp(mg_smoothedTemp);
-	        }  else  {  // humidity reading called for
-	         meterHumidity(mg_smoothedHumidity);
-	        }
-  
-            // set the cloud temperature and humidity globals
-            temperature = String::format("%4.1f", mg_smoothedTemp);
-            humidity = String::format("%4.1f", mg_smoothedHumidity);
-
-
-
-            // test for low and high temperature alarms and set the flags
-            if(mg_smoothedTemp < lowTempAlarmLimit.toFloat()) { // we have a low temperature alarm
-                Alarms.lowTempAlarm = true; // set the low temperature alarm flag
-            } else {    // no low temperature alarm now
-                Alarms.lowTempAlarm = false; // set the low temperature alarm flag
-            }
-        
-            if(mg_smoothedTemp > highTempAlarmLimit.toFloat()) { // we have a high temperature alarm
-                Alarms.highTempAlarm = true; // set the high temperature alarm flag
-                alarmer.sendHighTemperatureAlarm(mg_smoothedTemp); // send out the alarm for processing
-            } else {    // no high temperature alarm now
-                Alarms.highTempAlarm = false; // set the low temperature alarm flag
-            }
+    profiler.stop(PHASE_OUTPUTS);
+    return;
+}   // end of readInputsTask()
 
-            if(firstTimeRead == false) {    // process alarms only after the first time through
-
-                // process the alarm flags to send or reset the alarms, as appropriate
-                if(Alarms.lowTempAlarm == true) {   // low temp alarm needs processing
-                    alarmer.sendLowTemperatureAlarm(mg_smoothedTemp); // send out the alarm for processing
-                    alarmer.armHighTempAlarm();  // reset the alarm processing for a new alarm in the future
-                } else if(Alarms.highTempAlarm == true) {     // high temp alarm needs processing
-                    alarmer.sendHighTemperatureAlarm(mg_smoothedTemp); // send out the alarm for processing
-                    alarmer.armLowTempAlarm();  // reset the alarm processing for a new alarm in the future            
-                } else {    // not temp alarms, therefore both alarms need rearming
-                    alarmer.armHighTempAlarm();  // reset the alarm processing for a new alarm in the future
-                    alarmer.armLowTempAlarm();  // reset the alarm processing for a new alarm in the future 
-                }
+/* muteButtonTask():  sensing thread task to read the mute pushbutton
+    parameters: none
+*/
+void muteButtonTask() {
+    sensingProfiler.start(PHASE_OUTPUTS);
 
-            }
-            firstTimeRead = false;  // skipped the first reading, now allow alarms
-            writeAlarmStatusString();   // write out the current status of all alarms
+    // process the mute pushbutton
+    if(readPushButton() == true) {
+        mute = true; // set the alarm mute flag
+        soundAlarm = false; // mute the alarm right now
+    }
 
-	        newData = false; // don't publish/process results again until a new reading
-        }
+    sensingProfiler.stop(PHASE_OUTPUTS);
+    return;
+}   // end of muteButtonTask()
 
-        if((diff(millis(), lastReadTime)) >= DHT_SAMPLE_INTERVAL) { // we are ready for a new reading
-          readDHT(true);  // start a new reading
-          newData = true; // set flag to indicate that a new reading will result
-          lastReadTime = millis();
+/* dhtTask():  task to run the DHT sensor bus, and process and display the readings it completes
+    parameters: none
+*/
+void dhtTask() {
+    uint8_t completed;
+    uint8_t lowZones = 0, highZones = 0, faultZones = 0;
+    uint8_t lowPredictedZones = 0, highPredictedZones = 0;
+    fixed_t lowestTemp = 0, highestTemp = 0;
+    unsigned long lowTime = WLDTrend::NEVER, highTime = WLDTrend::NEVER;    // soonest predicted limits
+    int faultStatus = DHTLIB_OK;
+
+    profiler.start(PHASE_DHT);
+
+    // Non-blocking: finish a completed reading and start the next one that is due
+    completed = sensorBus.poll();
+    if(completed == 0) {
+        profiler.stop(PHASE_DHT);
+        return;
+    }
 
+    // zone 0 is shown on the servo meter and in the Temperature and Humidity cloud variables
+    if((completed & 1) != 0 && sensorBus.status(0) == DHTLIB_OK) {
+        mg_smoothedTemp = sensorBus.temperature(0);
+        mg_smoothedHumidity = sensorBus.humidity(0);
 
-            // toggle the D7 LED to indicate loop timing for DHT11 reading
-            ledState = !ledState;
-            if (ledState) {
-                digitalWrite(LED_PIN, HIGH);
-            } else {
-                digitalWrite(LED_PIN, LOW);
-            }
+        // set temperature or humidiy on the servo meter
+        if(toggle == true)  {   // temperature reading called for
+            meterTemp(mg_smoothedTemp);
+        }  else  {  // humidity reading called for
+            meterHumidity(mg_smoothedHumidity);
         }
 
+        // set the cloud temperature and humidity globals
+        writeReadingString(temperature, sizeof(temperature), mg_smoothedTemp, &lastTemperatureTenths);
+        writeReadingString(humidity, sizeof(humidity), mg_smoothedHumidity, &lastHumidityTenths);
+        writeReadingString(dewPointString, sizeof(dewPointString), sensorBus.dewPoint(0), &lastDewPointTenths);
+        writeReadingString(heatIndexString, sizeof(heatIndexString), sensorBus.heatIndex(0), &lastHeatIndexTenths);
     }
 
+    // add the good readings to the rolling statistics; the windows of the other zones move on
+    for(int zone = 0; zone < NUM_DHT_ZONES; zone++) {
+        if((completed & (1 << zone)) != 0 && sensorBus.status(zone) == DHTLIB_OK) {
+            temperatureStats[zone].add(sensorBus.lastTemperature(zone), hal->millis());
+            humidityStats[zone].add(sensorBus.lastHumidity(zone), hal->millis());
+            temperatureTrend[zone].add(sensorBus.lastTemperature(zone), hal->millis());
+        } else {
+            temperatureStats[zone].advance(hal->millis());
+            humidityStats[zone].advance(hal->millis());
+        }
+    }
 
-    // measure and test water level at pre-determined interval
-    if(nbWaterMeasureInterval(20) == false) {  // 20 ms between sensor readings
-
-        // read the water level from the sensor; convert to a voltage value
-        int waterLevelA, waterLevelB;
-        float waterSensorVoltageA, waterSensorVoltageB;
-
-        waterLevelA = analogRead(WATER_SENSOR_A_PIN);
-        waterLevelB = analogRead(WATER_SENSOR_B_PIN);
-        waterSensorVoltageA = ((float)waterLevelA * 3.3) / 4095;
-        waterSensorVoltageB = ((float)waterLevelB * 3.3) / 4095;
-
-        // integrate and threshold measurement for alarm
-        if(alarmIntegrator(waterSensorVoltageA, waterSensorVoltageB) == true) {
-            indicator = true;
-            // process a water leak detection
-            Alarms.waterLeakAlarm = true;   // set the alarm flag
-            alarmer.sendWaterLeakAlarm();   // send the alarm for processing
-            writeAlarmStatusString();   // update the alarm status global string
+    // test every zone for alarms; an alarm is present when any zone has it, and is reported with
+    //  the most extreme temperature of the zones that have it
+    for(int zone = 0; zone < sensorBus.numZones(); zone++) {
+        updateZoneAlarms(zone);
+        uint8_t flags = zoneAlarmFlags(zone);
+        fixed_t zoneTemp = sensorBus.temperature(zone);
 
-            if(mute == false) {
-                alarm = true;
-            } else {
-                alarm = false;
+        if((flags & ZONE_LOW_TEMP) != 0) {
+            if(lowZones == 0 || zoneTemp < lowestTemp) {
+                lowestTemp = zoneTemp;
+            }
+            lowZones |= 1 << zone;
+        }
+        if((flags & ZONE_HIGH_TEMP) != 0) {
+            if(highZones == 0 || zoneTemp > highestTemp) {
+                highestTemp = zoneTemp;
+            }
+            highZones |= 1 << zone;
+        }
+        if((flags & ZONE_LOW_TEMP_PREDICTED) != 0) {
+            lowPredictedZones |= 1 << zone;
+            unsigned long time = temperatureTrend[zone].timeToFall(mg_lowTempLimit, hal->millis());
+            if(time < lowTime) {
+                lowTime = time;
+            }
+        }
+        if((flags & ZONE_HIGH_TEMP_PREDICTED) != 0) {
+            highPredictedZones |= 1 << zone;
+            unsigned long time = temperatureTrend[zone].timeToRise(mg_highTempLimit, hal->millis());
+            if(time < highTime) {
+                highTime = time;
             }
-        } else {
-            indicator = false;
-            // no water leak alarm so process and rearm
-            Alarms.waterLeakAlarm = false;   // set the alarm flag
-            alarmer.armLeakAlarm();   // send the alarm for processing
-            writeAlarmStatusString();   // update the alarm status global string
-
-            alarm = false;
-            mute = false;   // reset alarm muting
+        }
+        if((flags & ZONE_SENSOR_FAULT) != 0) {
+            faultZones |= 1 << zone;
+            faultStatus = sensorBus.status(zone);
         }
     }
-
-    // process the mute pushbutton
-    if(readPushButton() == true) {
-        mute = true; // set the alarm mute flag
-        alarm = false; // mute the alarm right now
+    Alarms.lowTempAlarm = (lowZones != 0);
+    Alarms.highTempAlarm = (highZones != 0);
+    alarmer.setCondition(ALARM_LOW_TEMP, Alarms.lowTempAlarm, lowestTemp);
+    alarmer.setCondition(ALARM_HIGH_TEMP, Alarms.highTempAlarm, highestTemp);
+    alarmer.setCondition(ALARM_LOW_TEMP_PREDICTED, lowPredictedZones != 0, intToFixed(predictedMinutes(lowTime)));
+    alarmer.setCondition(ALARM_HIGH_TEMP_PREDICTED, highPredictedZones != 0, intToFixed(predictedMinutes(highTime)));
+    alarmer.setCondition(ALARM_SENSOR_FAULT, faultZones != 0, intToFixed(faultStatus));
+    newAlarmData = true;
+
+    writeZoneStatusString();
+    writeStatsString();
+    sensorBus.format(dhtStats, sizeof(dhtStats));
+
+    // toggle the D7 LED to indicate loop timing for DHT11 reading
+    ledState = !ledState;
+    if (ledState) {
+        hal->digitalWrite(LED_PIN, HIGH);
+    } else {
+        hal->digitalWrite(LED_PIN, LOW);
     }
 
-    // refresh non-blocking alarm & indicator status
-    nbFlashIndicator(indicator);
-    nbSoundAlarm(alarm);
-    
-} // end of loop()
+    profiler.stop(PHASE_DHT);
+    return;
+}   // end of dhtTask()
 
-/* alarmIntegrator():  function that thresholds sensor voltage readings and integrates the values.
-    parameters:
-        sensorReading - the sensor voltage reading to be thresholded and integrated
-    return:
-        the alarm value as a boolean.  The alarm value is set after 5 thresholds are accumulated
-            for either sensor and stays set until 5 under-thresholds are accumulated for both sensors
+/* waterTask():  sensing thread task to read, threshold and integrate every water sensor probe, every
+                 WATER_SLOW_INTERVAL while the probes are dry and every WATER_FAST_INTERVAL
+                 while one is near the threshold or wet, and to pass a change of the alarms to loop()
+    parameters: none
 */
-bool alarmIntegrator(float sensorAReading, float sensorBReading) {
-    const byte ALARM_LIMIT = 5;     // 5 thresholds are required to trigger an alarm, then 5 under thresholds
-                                    //  are required to reset the alarm condition.
-
-    static byte integratedValueA = 0; // threshold exceeded accumulator for sensor A
-    static byte integratedValueB = 0; // threshold exceeded accumulator for sensor B
-    static boolean lastAlarmState = false;
-    boolean thresholdedReadingA;
-    boolean thresholdedReadingB;
-
-   // test to see if threshold was exceeded on each sensor
-    if(sensorAReading > WATER_LEVEL_THRESHOLD) {
-        thresholdedReadingA = true;
-    } else {
-        thresholdedReadingA = false;
-    }
-
-    if(sensorBReading > WATER_LEVEL_THRESHOLD) {
-        thresholdedReadingB = true;
-    } else {
-        thresholdedReadingB = false;
+void waterTask() {
+    sensingProfiler.markSample();
+    sensingProfiler.start(PHASE_WATER);
+
+    // read, threshold and integrate every water sensor probe
+    bool leak = waterSensors.sample();
+
+    // change the sampling rate when the sensors ask for it; the next reading is one new interval away
+    if(waterSensors.fast() != waterFast.load(std::memory_order_relaxed)) {
+        waterFast.store(waterSensors.fast(), std::memory_order_relaxed);
+        unsigned long interval = waterSensors.fast() ? WATER_FAST_INTERVAL : WATER_SLOW_INTERVAL;
+        sensingScheduler.setPeriod(waterTaskNumber, interval);
+        sensingProfiler.setSampleInterval(interval);
     }
 
-    // integrate thresholds or under thresholds; clamp them at ALARM_LIMIT and 0
-    if(thresholdedReadingA == true)  {       // increment integrator
-        if(integratedValueA < ALARM_LIMIT)  {
-            integratedValueA++;
-        } else {
-            integratedValueA = ALARM_LIMIT;  // clamp at max value
-        }
-    } else {    // thresholdedReading was false
-        if(integratedValueA > 0) {           // decrement integrator
-            integratedValueA--;
-        }  else  {
-            integratedValueA = 0;    // clamp at zero
-        }
+    // queue a change of the alarms for loop(); if the queue is full, the change is queued at a later reading
+    if(waterSensors.alarmBits() != sentWaterAlarmBits && waterEvents.push(waterSensors.alarmBits()) == true) {
+        sentWaterAlarmBits = waterSensors.alarmBits();
     }
 
-    if(thresholdedReadingB == true)  {       // increment integrator
-        if(integratedValueB < ALARM_LIMIT)  {
-            integratedValueB++;
+    if(leak == true) {
+        indicator = true;
+        if(mute == false) {
+            soundAlarm = true;
         } else {
-            integratedValueB = ALARM_LIMIT;  // clamp at max value
-        }
-    } else {    // thresholdedReading was false
-        if(integratedValueB > 0) {           // decrement integrator
-            integratedValueB--;
-        }  else  {
-            integratedValueB = 0;    // clamp at zero
+            soundAlarm = false;
         }
-    }
-
-
-    // Determine the return value
-    if((integratedValueA >= ALARM_LIMIT) || (integratedValueB >= ALARM_LIMIT)) {    // either integrator at the limit
-        lastAlarmState = true;
-        return true;
     } else {
-        if((integratedValueA <= 0) && (integratedValueB <= 0)) {    // both integrators at zero
-            lastAlarmState = false;
-            return false;
-        } else {
-            return lastAlarmState;  // in between condition, no change in alarm return value
-        }
+        indicator = false;
+        soundAlarm = false;
+        mute = false;   // reset alarm muting
     }
-}  // end of alarmIntegrator()
 
-/* nbFlashIndicator():  non-blocking function to flash the indicator LED when alarming
-                        or light it constantly when not alarming
-    parameters:
-        flash - true to flash the LED, false to light it constantly
+    sensingProfiler.stop(PHASE_WATER);
+    return;
+}   // end of waterTask()
+
+/* indicatorTask():  sensing thread task to flash the indicator LED when alarming or light it constantly when
+                     not alarming; runs every FLASH_INTERVAL
+    parameters: none
 */
-void nbFlashIndicator(boolean flash) {
-    const unsigned long FLASH_INTERVAL = 150; // 150 ms on and off
+void indicatorTask() {
     static boolean lastOn = true;   // start with LED on
-    static unsigned long lastTime = millis();
 
-    if(flash == true) {     // flashes the LED
-        if(diff(millis(), lastTime) >= FLASH_INTERVAL) { // flip the LED state
-            lastOn = !lastOn;
-            lastTime = millis();
-        }
+    sensingProfiler.start(PHASE_OUTPUTS);
 
+    if(indicator == true) {     // flashes the LED
+        lastOn = !lastOn;
     } else {  // not flashing the LED
         lastOn = true;
     }
 
     if(lastOn == true)  {
-        digitalWrite(INDICATOR_PIN, HIGH);
+        hal->digitalWrite(INDICATOR_PIN, HIGH);
     } else {
-        digitalWrite(INDICATOR_PIN, LOW);
+        hal->digitalWrite(INDICATOR_PIN, LOW);
     }
+
+    sensingProfiler.stop(PHASE_OUTPUTS);
     return;
-}   // end of nbFlashIndicator()
+}   // end of indicatorTask()
 
-/* nbSoundAlarm():  non-blocking function to sound the alarm
-    parameters:
-        sound - sound the audible alarm
+/* buzzerTask():  sensing thread task to pulse the alarm buzzer when sounding the alarm; runs every BEEP_INTERVAL
+    parameters: none
 */
-void nbSoundAlarm(boolean sound) {
-    const unsigned long BEEP_INTERVAL = 50; // 50 ms on and off
+void buzzerTask() {
     static boolean lastOn = false;   // start with alarm off
-    static unsigned long lastTime = millis();
 
-    if(sound == true) {     // sound the buzzer
-        if(diff(millis(), lastTime) >= BEEP_INTERVAL) { // flip the buzzer state
-            lastOn = !lastOn;
-            lastTime = millis();
-        }
+    sensingProfiler.start(PHASE_OUTPUTS);
 
+    if(soundAlarm == true) {     // sound the buzzer
+        lastOn = !lastOn;
     } else {  // not alarming
         lastOn = false;
     }
 
     if(lastOn == true)  {
-        digitalWrite(ALARM_PIN, HIGH);
+        hal->digitalWrite(ALARM_PIN, HIGH);
     } else {
-        digitalWrite(ALARM_PIN, LOW);
+        hal->digitalWrite(ALARM_PIN, LOW);
     }
+
+    sensingProfiler.stop(PHASE_OUTPUTS);
     return;
-}   // end of nbSoundAlarm()
+}   // end of buzzerTask()
 
-/* nbWaterMeasureInterval(): non-blocking interval delay for water level measurements
-    parameters:
-        delayTime - number of milliseconds in the delay
-    retrun:
-        delay in progress - true if delay is in progress, otherwise false
+/* loopStatsTask():  task to refresh the loop statistics cloud variable while profiling
+    parameters: none
 */
-boolean nbWaterMeasureInterval(unsigned long delayTime) {
-    static boolean lastState = false;
-    static unsigned long lastTime;
-    static unsigned long currentTime;
-
-    // if not currently in timing, start timing
-    if(lastState == false) {
-        lastTime = millis();
-        lastState = true;   // in measurement
-        return true;
-    }
-
-    // currently timing, so test for completion and process accordingly
-    currentTime = millis();
-    if(diff(currentTime, lastTime) < delayTime) { // time not yet expired
-        lastState = true;  // timing in process
-        return true;
-    } else {  // time has expired
-        lastTime = currentTime;
-        lastState = false;  // timing has expired
-        return false;
+void loopStatsTask() {
+    if(profiler.enabled()) {
+        size_t length = profiler.format(loopStats, sizeof(loopStats));
+        length += snprintf(loopStats + length, sizeof(loopStats) - length, ";sensing:");
+        if(length < sizeof(loopStats)) {
+            sensingProfiler.format(loopStats + length, sizeof(loopStats) - length);
+        }
+    }
+    return;
+}   // end of loopStatsTask()
+
+/* waterStatsTask():  task to write the water sensor sampling statistics into the WaterStats cloud
+                      variable:  "mode:slow|fast,reads/s:<ADC reads per second>,detections:<n>,
+                      last:<detection time of the last alarm, ms>,worst:<worst case latency, ms>".
+                      The worst case latency is one slow interval before a wet probe is first read,
+                      plus the fast readings that it takes to count to the alarm limit.  The counts
+                      are written by the sensing thread; each is read whole, and they need not agree.
+    parameters: none
+*/
+void waterStatsTask() {
+    static uint32_t lastReads = 0;
+    static unsigned long lastTime = 0;
+    unsigned long now = hal->millis();
+    uint32_t reads = waterSensors.reads();
+    char rate[16];
+    const char *r;
+
+    // ADC reads per second since the last refresh, in fixed point
+    fixed_t readsPerSecond = (fixed_t)(((int64_t)(reads - lastReads) * 1000 * FIXED_ONE) /
+                                       (int64_t)(timeSince(now, lastTime) + 1));
+    lastReads = reads;
+    lastTime = now;
+    formatFixed(rate, sizeof(rate), readsPerSecond);
+    for(r = rate; *r == ' '; r++);  // skip the padding
+
+    snprintf(waterStats, sizeof(waterStats), "mode:%s,reads/s:%s,detections:%lu,last:%lu,worst:%lu",
+             waterFast.load(std::memory_order_relaxed) ? "fast" : "slow", r, (unsigned long)waterSensors.detections(),
+             waterSensors.lastDetectionTime(),
+             (unsigned long)(WATER_SLOW_INTERVAL + (FAST_ALARM_LIMIT - 1) * WATER_FAST_INTERVAL));
+    return;
+}   // end of waterStatsTask()
+
+/* infoTask():  task to write the firmware version and the reset time into the Info cloud variable, once
+                the time has been set from the cloud
+    parameters: none
+*/
+void infoTask() {
+    static boolean written = false;
+
+    if(written == false && Time.isValid()) {
+        time_t resetTime = Time.now() - hal->millis() / 1000;
+        snprintf(info, sizeof(info), "Firmware Verison " FIRMWARE_VERSION ". Last reset at: %s",
+                 dateTimeString(resetTime).c_str());
+        written = true;
+    }
+    return;
+}   // end of infoTask()
+
+/* forensicsTask():  task to reset the device when the sensing thread has stopped coming around, and to
+                     refresh the Forensics cloud variable when a stall has been recorded
+    parameters: none
+*/
+void forensicsTask() {
+    static uint32_t lastStalls = 0;
+    unsigned long stalled = timeSince(hal->millis(), sensingHeartbeat);
+
+    if(stalled > SENSING_WATCHDOG_TIMEOUT) {
+        forensics.resetForStall(THREAD_SENSING, sensingProfiler.currentPhase(), stalled);
+    }
+    if(forensics.stalls() != lastStalls) {
+        lastStalls = forensics.stalls();
+        forensics.format(forensicsString, sizeof(forensicsString));
+    }
+    return;
+}   // end of forensicsTask()
+
+/* telemetryTask():  task to add a sample of the readings to the telemetry, every PARTICLE_PUBLISH_INTERVAL;
+                     loop() publishes them a window at a time
+    parameters: none
+*/
+void telemetryTask() {
+    WLDTelemetrySample sample;
+
+    memset(&sample, 0, sizeof(sample));
+    sample.alarms = alarmer.conditions();
+    sample.leaks = Alarms.waterLeakChannels;
+    if(sensorBus.readings(0) > 0) {
+        sample.temperature = fixedToTenths(mg_smoothedTemp);
+        sample.humidity = fixedToTenths(mg_smoothedHumidity);
+    } else {
+        sample.temperature = TELEMETRY_NO_READING;
+        sample.humidity = TELEMETRY_NO_READING;
+    }
+    for(int channel = 0; channel < NUM_WATER_CHANNELS && channel < TELEMETRY_PROBES; channel++) {
+        sample.levels[channel] = waterSensors.reading(channel);
+    }
+    telemetry.add(&sample);
+    return;
+}   // end of telemetryTask()
+
+/* historyTask():  task to add the readings to the history, every HISTORY_SAMPLE_INTERVAL
+    parameters: none
+*/
+void historyTask() {
+    uint16_t millivolts[HISTORY_MAX_PROBES];
+    int16_t temperature = HISTORY_NO_READING, humidity = HISTORY_NO_READING;
+
+    if(sensorBus.readings(0) > 0) {
+        temperature = fixedToTenths(mg_smoothedTemp);
+        humidity = fixedToTenths(mg_smoothedHumidity);
+    }
+    for(int channel = 0; channel < NUM_WATER_CHANNELS && channel < HISTORY_MAX_PROBES; channel++) {
+        millivolts[channel] = waterSensors.millivolts(channel);
     }
-}  // end of nbWaterMeasureInterval
+    history.add(temperature, humidity, millivolts);
+    return;
+}   // end of historyTask()
+
+/* configTask():  task to write changed settings to the EEPROM journal, once they have stopped changing
+    parameters: none
+*/
+void configTask() {
+    profiler.start(PHASE_CONFIG);
+    configJournal.service(hal->millis());
+    profiler.stop(PHASE_CONFIG);
+    return;
+}   // end of configTask()
+
+/* heapTask():  task to sample the heap; once startup is over, any growth is counted
+    parameters: none
+*/
+void heapTask() {
+    if(heapMonitor.steady() == false && hal->millis() >= HEAP_STEADY_STATE_TIME) {
+        heapMonitor.steadyState();
+    }
+    heapMonitor.update();
+    heapMonitor.format(heapStats, sizeof(heapStats));
+    return;
+}   // end of heapTask()
 
 /* readPushButton: read the mute pushbutton with debouncing
     parameters: none
@@ -601,15 +1446,15 @@ boolean readPushButton() {
     static byte lastState = OFF;
     static unsigned long beginTime;
 
-    if(digitalRead(BUTTON_PIN) == LOW) {  // button has been pressed
+    if(hal->digitalRead(BUTTON_PIN) == LOW) {  // button has been pressed
         switch (lastState) {
             case OFF:       // new button press
-                beginTime = millis();
+                beginTime = hal->millis();
                 lastState = DEBOUNCING;
                 return false;
                 break;
             case DEBOUNCING:    // wait until debouncing time is over
-                if(diff(millis(), beginTime) < DEBOUNCE_TIME) {
+                if(timeSince(hal->millis(), beginTime) < DEBOUNCE_TIME) {
                     return false;
                 } else {
                     lastState = DEBOUNCED;
@@ -630,64 +1475,15 @@ boolean readPushButton() {
 }  // end of readPushButton
 
 
-/* diff(): function to measure time differences using millis() that corrects for millis() overflow.
-    paramters:
-        current - the current time value from millis(), as unsigned long
-        last - the previous time value from millis(), as unsigned long
-    return:
-        the difference between current and last, as unsigned long
-*/
-unsigned long diff(unsigned long current, unsigned long last)  {
-    const unsigned long MAX = 0xffffffff;  // an unsigned long is 4 bytes
-    unsigned long difference;
-
-    if (current < last) {       // overflow condition
-        difference = (MAX - last) + current;
-    } else {
-        difference = current - last;
-    }
-    return difference;
-}  // end of diff()
-
-
-/*
-readDHT():  read temperature and humidity from the DHT11 sensor
-    arguments:
-        startRead:  true to start a reading, false otherwise
-    return: status code, per global definitions
-*/
-int readDHT(boolean startRead) {
-    static int _state = COMPLETE_OK;
-
-    if(_state == ACQUIRING) {  // test to see if we are done
-        if(DHT.acquiring() == false) { // done acquriring
-            dhtResultCode = DHT.getStatus();  // store the result code fromt he library
-           if(dhtResultCode == DHTLIB_OK) {
-               _state = COMPLETE_OK;
-           } else {
-               _state = COMPLETE_ERROR;
-           }
-        }
-    }
-    else { // we were not in the process of acquiring
-        if(startRead == true) {  // we must start a new reading of sensor data
-           _state = ACQUIRING;  // set the state to acquiring
-            DHT.acquire(); // start the acquisition
-        }
-    }
-
-    return _state;
-
-}  // end of readDHT()
 
 /* meterTemp():  display temperature reading on the servo meter
     arguments:
         temperature: the temperature to display on the meter
 */
-void meterTemp(float temperature)  {
+void meterTemp(fixed_t temperature)  {
     int _temp, _mve, _cmd;
 
-    _temp = (int)(temperature + 0.5);  // round and truncate to an integer
+    _temp = fixedToInt(temperature);  // round to an integer
 
     // clamp temperature to within dial limits
     if(_temp < LO_TEMP) {
@@ -698,7 +1494,7 @@ void meterTemp(float temperature)  {
 
     _mve = (_temp - LO_TEMP) * (MAX_POS - MIN_POS) / TEMP_RANGE;
     _cmd = MAX_POS - _mve;
-    myservo.write(_cmd);
+    hal->servoWrite(_cmd);
 
     return;
 }  // end of meterTemp()
@@ -707,10 +1503,10 @@ void meterTemp(float temperature)  {
     arguments:
         humidity: the humidity to display on the meter
 */
-void meterHumidity(float humidity)  {
+void meterHumidity(fixed_t humidity)  {
     int _hum, _mve, _cmd;
 
-    _hum = (int)(humidity + 0.5);  // round and truncate to an integer
+    _hum = fixedToInt(humidity);  // round to an integer
 
     // clamp temperature to within dial limits
     if(_hum < LO_HUM) {
@@ -721,7 +1517,7 @@ void meterHumidity(float humidity)  {
 
     _mve = (_hum - LO_HUM) * (MAX_POS - MIN_POS) / HUM_RANGE;
     _cmd = MAX_POS - _mve;
-    myservo.write(_cmd);
+    hal->servoWrite(_cmd);
 
     return;
 }  // end of meterHumidity()
@@ -0,0 +1,183 @@
+/*******************************************************************************
+ * ConfigJournalTest:  WLDConfigJournal survives torn writes, coalesces saves and grows its settings
+ *
+ * Runs a WLDConfigJournal on the simulated device's in-memory EEPROM (see WLDHalMock.h):
+ *
+ * - Torn writes:  with every slot written and the journal wrapped several times, a save is
+ * stopped after each possible number of bytes (tearEepromWrites()), at each slot of the journal.
+ * After each torn write a new journal (as after the reset) must load either the settings from
+ * before the save or those from after it, and a save after that must load back.
+ *
+ * - Coalescing:  a burst of saves is written as one record SAVE_DELAY after the last of them, and
+ * settings the same as the newest record are not written.
+ *
+ * - Growing the settings:  a record written with fewer settings loads them, and leaves the
+ * settings added since at the defaults set before load().
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDConfigJournal.h>
+#include <WLDHalMock.h>
+#include <WLDTest.h>
+
+const int JOURNAL_START = 0;
+const int JOURNAL_SIZE = 8 * WLDConfigJournal::SLOT_SIZE;
+const int WRAPS = 3;                // times the journal is filled before the torn writes
+
+// settings; version 2 appended "extra" to version 1
+struct SettingsV1 {
+    int16_t lowLimit;
+    int16_t highLimit;
+    uint32_t counter;
+    char name[12];
+};
+
+struct SettingsV2 {
+    int16_t lowLimit;
+    int16_t highLimit;
+    uint32_t counter;
+    char name[12];
+    uint32_t extra;
+};
+
+SettingsV2 makeSettings(uint32_t counter) {
+    SettingsV2 settings;
+
+    memset(&settings, 0, sizeof(settings));
+    settings.lowLimit = 40 + counter % 7;
+    settings.highLimit = 90 - counter % 5;
+    settings.counter = counter;
+    snprintf(settings.name, sizeof(settings.name), "zone %lu", (unsigned long)(counter % 1000000));   // fits name[]
+    settings.extra = counter * 2654435761UL;
+    return settings;
+}
+
+// a new journal, as after a reset, loaded into "settings"; false if there is no good record
+bool reload(WLDHalMock &mock, WLDConfigJournal &journal, SettingsV2 *settings) {
+    journal.begin(&mock, JOURNAL_START, JOURNAL_SIZE);
+    return journal.load(settings, sizeof(*settings));
+}
+
+void tornWrites(WLDHalMock &mock) {
+    static uint8_t image[WLDHalMock::EEPROM_SIZE];
+    WLDConfigJournal journal;
+    SettingsV2 settings;
+    uint32_t counter = 0;
+    int tears = 0, failures = 0;
+
+    reload(mock, journal, &settings);
+    for(int i = 0; i < WRAPS * journal.slots(); i++) {
+        settings = makeSettings(++counter);
+        journal.save(&settings, sizeof(settings), mock.millis());
+        journal.flush();
+    }
+
+    // a torn write at each slot of the journal
+    for(int slot = 0; slot < journal.slots(); slot++) {
+        SettingsV2 before = makeSettings(counter);
+        SettingsV2 after = makeSettings(counter + 1);
+
+        memcpy(image, mock.eeprom(), sizeof(image));
+        uint32_t start = mock.eepromBytesWritten();
+        journal.save(&after, sizeof(after), mock.millis());
+        journal.flush();
+        long recordBytes = mock.eepromBytesWritten() - start;
+
+        for(long bytes = 0; bytes <= recordBytes; bytes++) {
+            memcpy(mock.eeprom(), image, sizeof(image));
+            reload(mock, journal, &settings);
+            mock.tearEepromWrites(bytes);
+            journal.save(&after, sizeof(after), mock.millis());
+            journal.flush();
+            mock.tearEepromWrites(-1);
+            tears++;
+
+            // the reset:  either the old or the new settings, the new ones once the write is whole
+            bool loaded = reload(mock, journal, &settings);
+            bool isBefore = loaded && memcmp(&settings, &before, sizeof(settings)) == 0;
+            bool isAfter = loaded && memcmp(&settings, &after, sizeof(settings)) == 0;
+            if(!(isBefore || isAfter) || (bytes == recordBytes && !isAfter)) {
+                failures++;
+                CHECK(false, "slot %d, write torn after %ld of %ld bytes:  loaded %s", slot, bytes, recordBytes,
+                      !loaded ? "nothing" : isBefore ? "the old settings" : "other settings");
+                continue;
+            }
+
+            // and the journal goes on from there
+            SettingsV2 next = makeSettings(counter + 2);
+            journal.save(&next, sizeof(next), mock.millis());
+            journal.flush();
+            loaded = reload(mock, journal, &settings);
+            CHECK(loaded && memcmp(&settings, &next, sizeof(settings)) == 0,
+                  "slot %d, write torn after %ld bytes:  the next save did not load back", slot, bytes);
+        }
+
+        // move on to the next slot with a whole write
+        memcpy(mock.eeprom(), image, sizeof(image));
+        reload(mock, journal, &settings);
+        settings = makeSettings(++counter);
+        journal.save(&settings, sizeof(settings), mock.millis());
+        journal.flush();
+    }
+    printf("torn writes:  %d, at every byte of a record at each of %d slots; %d loaded other settings\n",
+           tears, journal.slots(), failures);
+}
+
+void coalescing(WLDHalMock &mock) {
+    WLDConfigJournal journal;
+    SettingsV2 settings;
+
+    memset(mock.eeprom(), 0xff, WLDHalMock::EEPROM_SIZE);
+    reload(mock, journal, &settings);
+    for(uint32_t counter = 1; counter <= 5; counter++) {
+        settings = makeSettings(counter);
+        journal.save(&settings, sizeof(settings), mock.millis());
+        mock.advance(1000);
+        CHECK(journal.service(mock.millis()) == false, "written %lu ms after a save", 1000UL);
+    }
+    mock.advance(WLDConfigJournal::SAVE_DELAY);
+    CHECK(journal.service(mock.millis()) == true, "not written SAVE_DELAY after the last save");
+    CHECK(journal.writes() == 1, "%lu records written for a burst of 5 saves", (unsigned long)journal.writes());
+
+    journal.save(&settings, sizeof(settings), mock.millis());
+    mock.advance(WLDConfigJournal::SAVE_DELAY);
+    CHECK(journal.service(mock.millis()) == false && journal.writes() == 1, "unchanged settings written");
+
+    SettingsV2 loaded;
+    CHECK(reload(mock, journal, &loaded) && memcmp(&loaded, &settings, sizeof(loaded)) == 0,
+          "the last of the burst did not load back");
+    printf("coalescing:  5 saves, 1 record; unchanged settings, no record\n");
+}
+
+void growing(WLDHalMock &mock) {
+    WLDConfigJournal journal;
+    SettingsV2 settings = makeSettings(7);
+    SettingsV1 old;
+
+    memset(mock.eeprom(), 0xff, WLDHalMock::EEPROM_SIZE);
+    memcpy(&old, &settings, sizeof(old));
+    reload(mock, journal, &settings);
+    journal.save(&old, sizeof(old), mock.millis());
+    journal.flush();
+
+    settings.extra = 12345;     // the default of the appended setting
+    bool loaded = reload(mock, journal, &settings);
+    CHECK(loaded && memcmp(&settings, &old, sizeof(old)) == 0, "the version 1 settings did not load");
+    CHECK(settings.extra == 12345, "the appended setting is %lu, not its default", (unsigned long)settings.extra);
+    printf("growing:  version 1 record loaded into version 2 settings, appended setting kept its default\n");
+}
+
+int main() {
+    WLDHalMock mock;
+
+    mock.begin(WLDHalMock::CLOCK_SIMULATED);
+    tornWrites(mock);
+    coalescing(mock);
+    growing(mock);
+    return testResult();
+}
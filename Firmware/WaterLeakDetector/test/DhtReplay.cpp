@@ -0,0 +1,167 @@
+/*******************************************************************************
+ * DhtReplay:  decode success rate and cost per edge of the PietteTech_DHT decoder
+ *
+ * The host version of the library's DHT_replay example.  Builds edge->edge timing traces of a
+ * DHT 11 reading and feeds them through replay(), which runs the decoder that the ISR uses:
+ *
+ *   clean       nominal timing
+ *   jitter N    every edge moved by up to +/- N us (N = 5..40)
+ *   truncated   the trace ends after a random number of edges
+ *   glitch      a spurious short edge is inserted at a random point
+ *   flipped     one data bit is flipped (must fail the checksum)
+ *
+ * Each kind of trace is replayed through two decoders:  "general" is PietteTech_DHT, which learns
+ * its timing and chooses the sensor type at run time, and "DHT11" is PietteTech_DHT_T specialized
+ * at compile time for a DHT 11 with the fixed timing windows.  For each kind and decoder it
+ * reports the decode success rate (the reading must decode to the values that were encoded), the
+ * readings that passed the checksum with other values (several misread bits can cancel out in
+ * the 8 bit checksum) and the cost per edge in ns of host time.
+ *
+ * Checks that clean traces always decode, that traces jittered by up to 15 us always decode with
+ * the general decoder, and that truncated and flipped traces never decode.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <PietteTech_DHT.h>
+#include <WLDHalMock.h>
+#include <WLDTest.h>
+#include <chrono>
+#include <random>
+
+const int TRIALS = 2000;            // traces of each kind
+
+// nominal timing, in microseconds
+const uint16_t T_RELEASE = 30;      // start pulse released to first falling edge
+const uint16_t T_RESPONSE = 160;    // 80us low + 80us high response
+const uint16_t T_ZERO = 78;         // 50us low + 28us high
+const uint16_t T_ONE = 120;         // 50us low + 70us high
+
+const uint8_t HUMIDITY = 45;        // encoded values; DHT11 has no fraction
+const uint8_t TEMPERATURE = 22;
+
+PietteTech_DHT DHT(D3, DHT11);
+PietteTech_DHT_T<DHT11Type, DHTFixedTiming<> > DHT11only(D3);
+
+std::mt19937 generator(2026);
+uint16_t trace[48];
+int traceLength;
+
+// random integer from low to high - 1, as Wiring's random()
+long random(long low, long high) {
+    return low + (long)(generator() % (unsigned long)(high - low));
+}
+
+// build a clean trace of the encoded reading; returns the number of edges
+int buildTrace(uint16_t *t, int flipBit) {
+    uint8_t bytes[5] = { HUMIDITY, 0, TEMPERATURE, 0, 0 };
+    int n = 0;
+
+    bytes[4] = bytes[0] + bytes[1] + bytes[2] + bytes[3];
+    t[n++] = T_RELEASE;
+    t[n++] = T_RESPONSE;
+    for(int bit = 0; bit < 40; bit++) {
+        bool one = (bytes[bit / 8] >> (7 - bit % 8)) & 1;
+        if(bit == flipBit) {
+            one = !one;
+        }
+        t[n++] = one ? T_ONE : T_ZERO;
+    }
+    return n;
+}
+
+void makeClean(int unused) {
+    traceLength = buildTrace(trace, -1);
+}
+
+void makeJitter(int amount) {
+    traceLength = buildTrace(trace, -1);
+    for(int i = 0; i < traceLength; i++) {
+        trace[i] = (uint16_t)std::max(1L, trace[i] + random(-amount, amount + 1));
+    }
+}
+
+void makeTruncated(int unused) {
+    traceLength = random(1, buildTrace(trace, -1));
+}
+
+void makeGlitch(int unused) {
+    traceLength = buildTrace(trace, -1);
+    int at = random(2, traceLength);
+    int split = random(1, 10);      // a short pulse within a bit
+    memmove(&trace[at + 1], &trace[at], (traceLength - at) * sizeof(trace[0]));
+    trace[at] -= split;
+    trace[at + 1] = split;
+    traceLength++;
+}
+
+void makeFlipped(int unused) {
+    traceLength = buildTrace(trace, random(0, 40));
+}
+
+// replay the trace through "dht", adding the time it took to "elapsed"; counts a good reading
+//  in "ok" and a reading of other values than those encoded in "wrong"
+template <class Decoder>
+void replay(Decoder &dht, std::chrono::steady_clock::duration *elapsed, int *ok, int *wrong) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int result = dht.replay(trace, traceLength);
+    *elapsed += std::chrono::steady_clock::now() - start;
+
+    if(result == DHTLIB_OK) {
+        if((int)dht.getHumidity() == HUMIDITY && (int)dht.getCelsius() == TEMPERATURE) {
+            (*ok)++;
+        } else {
+            (*wrong)++;
+        }
+    }
+}
+
+// replay TRIALS traces made by "make" through both decoders, print the results and check them
+//  (mustDecode:  the general decoder, or both with "both", decodes every trace; mustFail:  neither decodes any)
+void runTrials(const char *name, int param, void (*make)(int), bool mustDecode, bool both, bool mustFail) {
+    int ok[2] = { 0, 0 };
+    int wrong[2] = { 0, 0 };
+    std::chrono::steady_clock::duration elapsed[2] = { {}, {} };
+    long edges = 0;
+
+    for(int i = 0; i < TRIALS; i++) {
+        make(param);
+        edges += traceLength;
+        replay(DHT, &elapsed[0], &ok[0], &wrong[0]);
+        replay(DHT11only, &elapsed[1], &ok[1], &wrong[1]);
+    }
+
+    for(int d = 0; d < 2; d++) {
+        double ns = std::chrono::duration<double, std::nano>(elapsed[d]).count() / edges;
+        printf("%-10s %3d  %-8s %5.1f%% ok  %4d wrong  %5.1f ns/edge\n", name, param, d == 0 ? "general" : "DHT11",
+               100.0 * ok[d] / TRIALS, wrong[d], ns);
+        if(mustDecode && (d == 0 || both)) {
+            CHECK(ok[d] == TRIALS, "%s %d: %d of %d decoded", name, param, ok[d], TRIALS);
+        }
+        if(mustFail) {
+            CHECK(ok[d] + wrong[d] == 0, "%s %d: %d of %d decoded", name, param, ok[d] + wrong[d], TRIALS);
+        }
+    }
+}
+
+int main() {
+    WLDHalMock::device();       // the DHT library's pins and clock
+    printf("RAM: general %u bytes, DHT11 %u bytes\n", (unsigned)sizeof(DHT), (unsigned)sizeof(DHT11only));
+    DHT.begin();
+    DHT11only.begin();
+
+    runTrials("clean", 0, makeClean, true, true, false);
+    for(int amount = 5; amount <= 40; amount += 5) {
+        runTrials("jitter", amount, makeJitter, amount <= 15, false, false);
+    }
+    runTrials("truncated", 0, makeTruncated, false, false, true);
+    runTrials("glitch", 0, makeGlitch, false, false, false);
+    runTrials("flipped", 0, makeFlipped, false, false, true);
+    printf("learned: 1 > %dus, data %d-%dus, response %d-%dus\n", DHT.getOneThreshold(), DHT.getDataMin(),
+           DHT.getDataMax(), DHT.getResponseMin(), DHT.getResponseMax());
+    return testResult();
+}
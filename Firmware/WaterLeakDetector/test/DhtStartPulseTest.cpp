@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * DhtStartPulseTest:  DHT start pulses stay within the sensors' limits when polled
+ *
+ * A DHT 11 needs a start pulse of at least 18 ms; a DHT 22 or 21 needs 0.8 to 20 ms.  The
+ * PietteTech_DHT library ends a DHT 11 start pulse when it is next polled, and holds a DHT 22
+ * start pulse (1.5 ms) with a busy wait, so that a late poll cannot stretch it past 20 ms.
+ *
+ * A WLDSensorBus with a simulated DHT 11 and a simulated DHT 22 (see WLDHalMock.h) is polled
+ * every 20 ms, as the firmware's DHT poll task does, except that every 5th poll comes 50 ms late,
+ * as after a stall of loop(), for 2 simulated minutes.  Checks every start pulse against its
+ * sensor's limits, and that every reading is good and decodes to the simulated values.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDHalMock.h>
+#include <WLDSensorBus.h>
+#include <WLDTest.h>
+
+const unsigned long RUN_TIME = 120000;      // 2 simulated minutes
+const unsigned long POLL_INTERVAL = 20;     // the firmware's DHT_POLL_INTERVAL
+const unsigned long LATE_POLL = 50;         // every 5th poll is this much later
+const WLDDhtZone ZONES[] = {
+    { D2, DHT11 },
+    { D3, DHT22 },
+};
+
+int main() {
+    WLDHalMock mock;
+    WLDSensorBus sensorBus;
+    uint32_t completed[2] = { 0, 0 };
+
+    mock.begin(WLDHalMock::CLOCK_SIMULATED);
+    mock.addDhtSensor(D2, DHT11);
+    mock.setDhtReading(D2, 21, 45);
+    mock.addDhtSensor(D3, DHT22);
+    mock.setDhtReading(D3, -3.7, 81.2);
+
+    sensorBus.begin(&mock, ZONES, 2, 4000);
+    for(int poll = 1; mock.millis() < RUN_TIME; poll++) {
+        uint8_t done = sensorBus.poll();
+        for(int zone = 0; zone < 2; zone++) {
+            completed[zone] += (done >> zone) & 1;
+        }
+        mock.advance((poll % 5 == 0) ? POLL_INTERVAL + LATE_POLL : POLL_INTERVAL);
+    }
+
+    printf("DHT 11: %lu start pulses, %lu to %lu us\n", (unsigned long)mock.startPulses(D2),
+           mock.shortestStartPulse(D2), mock.longestStartPulse(D2));
+    printf("DHT 22: %lu start pulses, %lu to %lu us\n", (unsigned long)mock.startPulses(D3),
+           mock.shortestStartPulse(D3), mock.longestStartPulse(D3));
+
+    CHECK(mock.startPulses(D2) >= 20, "%lu DHT 11 start pulses", (unsigned long)mock.startPulses(D2));
+    CHECK(mock.shortestStartPulse(D2) >= 18000, "DHT 11 start pulse of %lu us", mock.shortestStartPulse(D2));
+    CHECK(mock.startPulses(D3) >= 20, "%lu DHT 22 start pulses", (unsigned long)mock.startPulses(D3));
+    CHECK(mock.shortestStartPulse(D3) >= 800, "DHT 22 start pulse of %lu us", mock.shortestStartPulse(D3));
+    CHECK(mock.longestStartPulse(D3) <= 20000, "DHT 22 start pulse of %lu us", mock.longestStartPulse(D3));
+
+    for(int zone = 0; zone < 2; zone++) {
+        CHECK(sensorBus.readings(zone) == completed[zone] && completed[zone] >= 20,
+              "zone %d: %lu good readings of %lu", zone, (unsigned long)sensorBus.readings(zone),
+              (unsigned long)completed[zone]);
+        CHECK(sensorBus.errors(zone) == 0, "zone %d: %d errors", zone, sensorBus.errors(zone));
+    }
+    // 21 C is 69.8 F; -3.7 C is 25.34 F
+    CHECK(abs(sensorBus.lastTemperature(0) - floatToFixed(69.8)) <= 1, "DHT 11 read %.2f F",
+          fixedToFloat(sensorBus.lastTemperature(0)));
+    CHECK(abs(sensorBus.lastTemperature(1) - floatToFixed(25.34)) <= 1, "DHT 22 read %.2f F",
+          fixedToFloat(sensorBus.lastTemperature(1)));
+    CHECK(abs(sensorBus.lastHumidity(1) - floatToFixed(81.2)) <= 1, "DHT 22 read %.2f %%RH",
+          fixedToFloat(sensorBus.lastHumidity(1)));
+    return testResult();
+}
@@ -0,0 +1,247 @@
+/*******************************************************************************
+ * EventQueueTest:  WLDEventQueue rate limits, coalesces, orders, retries and keeps its events
+ *
+ * Runs a WLDEventQueue against the simulated device's mock cloud (see WLDHalMock.h), which is
+ * the queue's WLDPublisher, in CLOCK_SIMULATED mode:
+ *
+ * - Token bucket:  a full bucket publishes a burst of MAX_TOKENS (4) events at once, then one
+ * event per PUBLISH_INTERVAL (1 second), and the bucket never holds more than 4 tokens.
+ *
+ * - Coalescing:  an event with the name of a waiting event replaces its data in place, and keeps
+ * its place in the queue.
+ *
+ * - Urgent events:  an urgent (critical) event goes to the head of the queue; a full queue drops
+ * its oldest event for a new event, and its newest for an urgent one.
+ *
+ * - Retry:  a failed publish is retried RETRY_INTERVAL (5 seconds) later, and not before.
+ *
+ * - Retained store:  the waiting events survive a second begin() with the same store, and a
+ * store with a bad marker, layout version or CRC is emptied.
+ *
+ * - claimToken():  refused while an event is waiting or no token is left.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDEventQueue.h>
+#include <WLDHalMock.h>
+#include <WLDTest.h>
+#include <string>
+
+const unsigned long PUBLISH_INTERVAL = 1000;    // WLDEventQueue's, ms
+const int MAX_TOKENS = 4;
+const unsigned long RETRY_INTERVAL = 5000;      // ms
+
+// the names of the published events, in order, as "A,B,C"
+std::string published(WLDHalMock &mock) {
+    std::string names;
+
+    for(const WLDMockEvent &event : mock.events()) {
+        names += (names.empty() ? "" : ",") + event.name;
+    }
+    return names;
+}
+
+// process() until nothing more is published at this time; returns the number published
+int drain(WLDHalMock &mock, WLDEventQueue &queue) {
+    uint32_t before = queue.published();
+
+    for(int i = 0; i < 2 * EVENT_QUEUE_LENGTH; i++) {
+        queue.process();
+    }
+    return queue.published() - before;
+}
+
+// a fresh queue, with an empty store, and no events published
+void start(WLDHalMock &mock, WLDEventQueue &queue, WLDEventQueueStore &store) {
+    memset(&store, 0, sizeof(store));
+    queue.begin(&mock, &mock, &store);
+    mock.setCloudConnected(true);
+    mock.setPublishFails(false);
+    mock.clearEvents();
+}
+
+void tokenBucket(WLDHalMock &mock) {
+    WLDEventQueueStore store;
+    WLDEventQueue queue;
+    char name[8];
+
+    start(mock, queue, store);
+    for(int i = 0; i < EVENT_QUEUE_LENGTH; i++) {
+        snprintf(name, sizeof(name), "E%d", i);
+        queue.enqueue(name, "data");
+    }
+    CHECK(drain(mock, queue) == MAX_TOKENS, "a full bucket published %d events, not %d", (int)queue.published(),
+          MAX_TOKENS);
+    mock.advance(PUBLISH_INTERVAL - 1);
+    CHECK(drain(mock, queue) == 0, "published before a token was earned");
+    mock.advance(1);
+    CHECK(drain(mock, queue) == 1, "one token did not publish one event");
+    mock.advance(2 * PUBLISH_INTERVAL);
+    CHECK(drain(mock, queue) == 2, "two tokens did not publish two events");
+
+    // a long wait does not fill the bucket past MAX_TOKENS
+    mock.advance(60 * PUBLISH_INTERVAL);
+    for(int i = 0; i < EVENT_QUEUE_LENGTH; i++) {
+        snprintf(name, sizeof(name), "F%d", i);
+        queue.enqueue(name, "data");
+    }
+    int burst = drain(mock, queue);
+    CHECK(burst == MAX_TOKENS, "a burst of %d events after a minute", burst);
+    CHECK(published(mock) == "E0,E1,E2,E3,E4,E5,E6,F0,F1,F2,F3", "published in the order %s", published(mock).c_str());
+    printf("token bucket:  a burst of %d, then one event per %lu ms\n", MAX_TOKENS, PUBLISH_INTERVAL);
+}
+
+void coalescing(WLDHalMock &mock) {
+    WLDEventQueueStore store;
+    WLDEventQueue queue;
+
+    start(mock, queue, store);
+    mock.setCloudConnected(false);
+    queue.enqueue("A", "1");
+    queue.enqueue("B", "1");
+    queue.enqueue("A", "2");
+    CHECK(queue.pending() == 2 && queue.coalesced() == 1, "%d events waiting, %lu coalesced", queue.pending(),
+          (unsigned long)queue.coalesced());
+
+    mock.setCloudConnected(true);
+    drain(mock, queue);
+    std::vector<WLDMockEvent> events = mock.events();
+    CHECK(events.size() == 2 && events[0].name == "A" && events[0].data == "2" && events[1].name == "B",
+          "published %s", published(mock).c_str());
+    printf("coalescing:  3 events, 2 published, the newer data in the older place\n");
+}
+
+void urgent(WLDHalMock &mock) {
+    WLDEventQueueStore store;
+    WLDEventQueue queue;
+    char name[8];
+
+    start(mock, queue, store);
+    mock.setCloudConnected(false);
+    queue.enqueue("A", "data");
+    queue.enqueue("B", "data");
+    queue.enqueue("LEAK", "data", true);
+    mock.setCloudConnected(true);
+    drain(mock, queue);
+    CHECK(published(mock) == "LEAK,A,B", "published in the order %s", published(mock).c_str());
+
+    // full:  a new event drops the oldest, an urgent one the newest
+    start(mock, queue, store);
+    mock.setCloudConnected(false);
+    for(int i = 0; i < EVENT_QUEUE_LENGTH; i++) {
+        snprintf(name, sizeof(name), "E%d", i);
+        queue.enqueue(name, "data");
+    }
+    CHECK(queue.enqueue("E8", "data") == false, "a new event did not drop one from a full queue");
+    CHECK(queue.enqueue("LEAK", "data", true) == false, "an urgent event did not drop one from a full queue");
+    CHECK(queue.dropped() == 2 && queue.pending() == EVENT_QUEUE_LENGTH, "%lu dropped, %d waiting",
+          (unsigned long)queue.dropped(), queue.pending());
+    mock.setCloudConnected(true);
+    for(int i = 0; i < EVENT_QUEUE_LENGTH; i++) {
+        mock.advance(PUBLISH_INTERVAL);
+        drain(mock, queue);
+    }
+    CHECK(published(mock) == "LEAK,E1,E2,E3,E4,E5,E6,E7", "published in the order %s", published(mock).c_str());
+    printf("urgent:  to the head of the queue; a full queue drops the oldest event, or the newest for an urgent one\n");
+}
+
+void retry(WLDHalMock &mock) {
+    WLDEventQueueStore store;
+    WLDEventQueue queue;
+
+    start(mock, queue, store);
+    mock.setPublishFails(true);
+    queue.enqueue("A", "data");
+    queue.process();
+    CHECK(queue.failures() == 1 && queue.pending() == 1, "%lu failures, %d waiting", (unsigned long)queue.failures(),
+          queue.pending());
+
+    mock.setPublishFails(false);
+    mock.advance(RETRY_INTERVAL - 1);
+    CHECK(drain(mock, queue) == 0, "retried before RETRY_INTERVAL");
+    mock.advance(1);
+    CHECK(drain(mock, queue) == 1 && queue.pending() == 0, "not retried after RETRY_INTERVAL");
+    CHECK(published(mock) == "A", "published %s", published(mock).c_str());
+    printf("retry:  a failed publish retried after %lu ms\n", RETRY_INTERVAL);
+}
+
+void retainedStore(WLDHalMock &mock) {
+    WLDEventQueueStore store, image;
+    WLDEventQueue queue;
+
+    // the events left waiting before a reset are published after it
+    start(mock, queue, store);
+    mock.setCloudConnected(false);
+    queue.enqueue("A", "1");
+    queue.enqueue("B", "2");
+    memcpy(&image, &store, sizeof(store));
+
+    WLDEventQueue after;
+    after.begin(&mock, &mock, &store);
+    CHECK(after.pending() == 2, "%d events kept by a second begin()", after.pending());
+    mock.setCloudConnected(true);
+    drain(mock, after);
+    CHECK(published(mock) == "A,B", "published %s after a second begin()", published(mock).c_str());
+
+    // a bad marker, layout version or CRC empties the store
+    for(int damage = 0; damage < 3; damage++) {
+        const char *what[] = { "marker", "version", "CRC" };
+        WLDEventQueue damaged;
+
+        memcpy(&store, &image, sizeof(store));
+        if(damage == 0) {
+            store.marker ^= 1;
+        } else if(damage == 1) {
+            store.version++;
+        } else {
+            store.events[store.head].data[0] ^= 1;   // the stored CRC no longer matches
+        }
+        damaged.begin(&mock, &mock, &store);
+        CHECK(damaged.pending() == 0, "%d events kept with a bad %s", damaged.pending(), what[damage]);
+    }
+
+    // and the emptied store works
+    WLDEventQueue reinitialized;
+    reinitialized.begin(&mock, &mock, &store);
+    CHECK(reinitialized.pending() == 0, "the reinitialized store is not intact");
+    printf("retained store:  kept by a second begin(), emptied with a bad marker, version or CRC\n");
+}
+
+void claiming(WLDHalMock &mock) {
+    WLDEventQueueStore store;
+    WLDEventQueue queue;
+
+    start(mock, queue, store);
+    mock.setCloudConnected(false);
+    queue.enqueue("A", "data");
+    CHECK(queue.claimToken() == false, "a token claimed while an alarm event is waiting");
+
+    mock.setCloudConnected(true);
+    drain(mock, queue);
+    int claimed = 0;
+    while(claimed <= MAX_TOKENS && queue.claimToken() == true) {
+        claimed++;
+    }
+    CHECK(claimed == MAX_TOKENS - 1, "%d tokens claimed after one publish from a full bucket", claimed);
+    mock.advance(PUBLISH_INTERVAL);
+    CHECK(queue.claimToken() == true, "no token claimed a PUBLISH_INTERVAL later");
+    printf("claimToken():  refused while an event waits, and when the bucket is empty\n");
+}
+
+int main() {
+    WLDHalMock mock;
+
+    mock.begin(WLDHalMock::CLOCK_SIMULATED);
+    tokenBucket(mock);
+    coalescing(mock);
+    urgent(mock);
+    retry(mock);
+    retainedStore(mock);
+    claiming(mock);
+    return testResult();
+}
@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * FixedPointBenchmark:  the fixed-point sensor pipeline against the float one it replaced
+ *
+ * Version 2.05 of the firmware moved the sensor pipeline from float to integer and fixed-point
+ * math (see WLDFixedPoint.h).  This test checks that the fixed-point pipeline gives the same
+ * results as the float code of version 2.04, which is reproduced here, and times both:
+ *
+ * - Water threshold:  every ADC count from 0 to 4095 is over 0.5 V (and 0.25 V) in raw counts
+ * exactly when it is over in float volts.
+ *
+ * - Smoothing:  over a random walk of DHT 11 readings, the fixed-point moving average stays
+ * within 0.05 F of the float one.
+ *
+ * - Meter:  the firmware's meterTemp() puts the servo at the same position as the float version
+ * did, for every fixed-point temperature from 30 to 130 F.
+ *
+ * - Formatting:  formatFixed() writes the same text as printf("%4.1f") except for values exactly
+ * half way between two tenths, which it rounds up where printf rounds to even, and for small
+ * negative values, which it writes as " 0.0" where printf writes "-0.0".
+ *
+ * The times are ns per sample on the host, which has a floating point unit; on the Photon, which
+ * has none, every float operation of the float pipeline is a library call.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDHalMock.h>
+#include <WLDFixedPoint.h>
+#include <WLDTest.h>
+#include <chrono>
+#include <random>
+
+// the firmware
+void meterTemp(fixed_t temperature);
+extern WLDHal *hal;
+
+const int SAMPLES = 4096;
+const int REPEATS = 2000;
+
+// the version 2.04 float pipeline
+static bool floatOverThreshold(uint16_t counts, float thresholdVolts) {
+    float volts = ((float)counts * 3.3) / 4095;
+    return volts > thresholdVolts;
+}
+
+static int floatMeterPosition(float temperature) {
+    int _temp = (int)(temperature + 0.5);
+    _temp = constrain(_temp, 40, 120);
+    return 175 - (_temp - 40) * (175 - 5) / 80;
+}
+
+// the fixed-point meter mapping of meterTemp(), for timing beside the float one
+static int fixedMeterPosition(fixed_t temperature) {
+    int _temp = fixedToInt(temperature);
+    _temp = constrain(_temp, 40, 120);
+    return 175 - (_temp - 40) * (175 - 5) / 80;
+}
+
+// ns per sample of "pass", which handles all SAMPLES once
+template <class Pass>
+static double timePerSample(Pass pass) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for(int repeat = 0; repeat < REPEATS; repeat++) {
+        pass();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ((double)REPEATS * SAMPLES);
+}
+
+int main() {
+    WLDHalMock mock;
+    std::mt19937 random(2026);
+
+    mock.begin(WLDHalMock::CLOCK_SIMULATED);
+    hal = &mock;
+
+    // water threshold, for every ADC count
+    int thresholdMismatches = 0;
+    for(int counts = 0; counts <= ADC_FULL_SCALE_COUNTS; counts++) {
+        thresholdMismatches += floatOverThreshold(counts, 0.5) != (counts > voltsToAdcCounts(0.5));
+        thresholdMismatches += floatOverThreshold(counts, 0.25) != (counts > voltsToAdcCounts(0.25));
+    }
+    CHECK(thresholdMismatches == 0, "%d ADC counts thresholded differently", thresholdMismatches);
+
+    // smoothing, over a random walk of whole degree C DHT 11 readings
+    static float readings[SAMPLES];
+    int celsius = 20;
+    for(int i = 0; i < SAMPLES; i++) {
+        celsius = constrain(celsius + (int)(random() % 3) - 1, 0, 50);
+        readings[i] = celsius * 1.8f + 32;
+    }
+    float floatSmoothed = readings[0];
+    fixed_t fixedSmoothed = floatToFixed(readings[0]);
+    float worstSmoothing = 0;
+    for(int i = 0; i < SAMPLES; i++) {
+        floatSmoothed = (0.9 * floatSmoothed) + (0.1 * readings[i]);
+        fixedSmoothed += (floatToFixed(readings[i]) - fixedSmoothed) / 10;
+        worstSmoothing = fmaxf(worstSmoothing, fabsf(fixedToFloat(fixedSmoothed) - floatSmoothed));
+    }
+    CHECK(worstSmoothing < 0.05, "smoothing differs by %.3f F", worstSmoothing);
+
+    // meter, with the firmware's meterTemp()
+    int meterMismatches = 0;
+    for(fixed_t temperature = intToFixed(30); temperature <= intToFixed(130); temperature++) {
+        meterTemp(temperature);
+        meterMismatches += mock.servoPosition() != floatMeterPosition(fixedToFloat(temperature));
+    }
+    CHECK(meterMismatches == 0, "%d meter positions differ", meterMismatches);
+
+    // formatting; only exact halves may differ
+    int formatMismatches = 0;
+    for(fixed_t value = intToFixed(-50); value <= intToFixed(150); value++) {
+        char fixedText[16], floatText[16];
+        formatFixed(fixedText, sizeof(fixedText), value);
+        snprintf(floatText, sizeof(floatText), "%4.1f", fixedToFloat(value));
+        bool half = ((value * 10) & (FIXED_ONE - 1)) == FIXED_ONE / 2;
+        bool negativeZero = strcmp(floatText, "-0.0") == 0;
+        formatMismatches += strcmp(fixedText, floatText) != 0 && !half && !negativeZero;
+    }
+    CHECK(formatMismatches == 0, "%d values formatted differently", formatMismatches);
+
+    // cost per sample:  threshold a water reading; smooth, limit test and meter a temperature
+    static uint16_t counts[SAMPLES];
+    static fixed_t fixedReadings[SAMPLES];
+    for(int i = 0; i < SAMPLES; i++) {
+        counts[i] = random() % (ADC_FULL_SCALE_COUNTS + 1);
+        fixedReadings[i] = floatToFixed(readings[i]);
+    }
+    volatile int sink = 0;
+    volatile float thresholdVolts = 0.5;    // not known at compile time, as in 2.04
+    volatile float highLimit = 90;
+    double floatWater = timePerSample([&]() {
+        int over = 0;
+        for(int i = 0; i < SAMPLES; i++) {
+            over += floatOverThreshold(counts[i], thresholdVolts);
+        }
+        sink = over;
+    });
+    double fixedWater = timePerSample([&]() {
+        int over = 0;
+        for(int i = 0; i < SAMPLES; i++) {
+            over += counts[i] > voltsToAdcCounts(0.5);
+        }
+        sink = over;
+    });
+    double floatTemp = timePerSample([&]() {
+        float smoothed = readings[0];
+        int result = 0;
+        for(int i = 0; i < SAMPLES; i++) {
+            smoothed = (0.9 * smoothed) + (0.1 * readings[i]);
+            result += (smoothed > highLimit) + floatMeterPosition(smoothed);
+        }
+        sink = result;
+    });
+    double fixedTemp = timePerSample([&]() {
+        fixed_t smoothed = fixedReadings[0];
+        fixed_t limit = intToFixed(90);
+        int result = 0;
+        for(int i = 0; i < SAMPLES; i++) {
+            smoothed += (fixedReadings[i] - smoothed) / 10;
+            result += (smoothed > limit) + fixedMeterPosition(smoothed);
+        }
+        sink = result;
+    });
+
+    printf("water threshold: float %.2f ns/sample, fixed point %.2f ns/sample\n", floatWater, fixedWater);
+    printf("temperature smooth/limit/meter: float %.2f ns/sample, fixed point %.2f ns/sample\n", floatTemp, fixedTemp);
+    printf("worst smoothing difference %.3f F\n", worstSmoothing);
+    return testResult();
+}
@@ -0,0 +1,288 @@
+/*******************************************************************************
+ * HistoryTest:  the WLDHistory pages hold the records that were kept, from the oldest on
+ *
+ * Adds one reading per slot to a tier of WLDHistory, on the simulated device (see WLDHalMock.h)
+ * in CLOCK_SIMULATED mode, so that each record holds the reading of its slot, and parses the
+ * pages that format() writes:
+ *
+ * - Round trip:  a page from the start holds every record, in order, with "-" for the slots
+ * without a good reading, and a new run after a gap in the time.
+ *
+ * - Paging:  small pages, each asked for from the <next> of the one before, hold every record
+ * once, and a page from a later time starts at that time.
+ *
+ * - Rollover:  after the blocks have filled and been reused many times, a page holds the newest
+ * records, in one run that ends with the newest record.
+ *
+ * - A bad block CRC:  a second begin() on the same store, as after a reset, empties the block
+ * whose CRC is wrong and keeps the records of the others, and the records after the reset start
+ * the next block, in the emptied one.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDHalMock.h>
+#include <WLDHistory.h>
+#include <WLDTest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+const uint32_t START_TIME = 1792195200;     // Unix time, a multiple of INTERVAL
+const uint16_t INTERVAL = 10;               // seconds per record
+const int BLOCKS = 4;
+const int PROBES = 2;
+const int FIELDS = 2 + PROBES;
+
+std::mt19937 generator(2026);
+
+// one record:  the temperature and humidity in tenths, or HISTORY_NO_READING, and the probe millivolts
+struct Record {
+    uint32_t time;
+    int32_t fields[FIELDS];
+
+    bool operator==(const Record &other) const {
+        return time == other.time && memcmp(fields, other.fields, sizeof(fields)) == 0;
+    }
+};
+
+// a history of one tier, and the records it should hold
+struct Rig {
+    WLDHistoryStore<BLOCKS> store;
+    WLDHistory history;
+    std::vector<Record> kept;       // the records of the slots that have ended
+    Record current;                 // the reading of the slot in progress
+    bool started;
+
+    Rig(WLDHalMock &mock) {
+        memset(&store, 0, sizeof(store));
+        history.begin(&mock, PROBES);
+        history.addTier(&store, INTERVAL);
+        started = false;
+    }
+};
+
+// add one reading for the current slot, then move to the next slot; "step" is the largest change of a field
+void addReading(WLDHalMock &mock, Rig &rig, int step, bool noReading = false) {
+    Record reading = rig.current;
+    uint16_t millivolts[PROBES];
+
+    if(rig.started == false) {
+        reading = { 0, { 700, 450, 100, 100 } };
+    }
+    for(int field = 0; field < FIELDS; field++) {
+        if(field < 2 && reading.fields[field] == HISTORY_NO_READING) {
+            reading.fields[field] = 700 - 250 * field;
+        }
+        reading.fields[field] = constrain(reading.fields[field] + (int32_t)(generator() % (2 * step + 1)) - step,
+                                          field < 2 ? -400 : 0, field < 2 ? 1200 : 3300);
+    }
+    if(noReading == true) {
+        reading.fields[0] = reading.fields[1] = HISTORY_NO_READING;
+    }
+    for(int probe = 0; probe < PROBES; probe++) {
+        millivolts[probe] = reading.fields[2 + probe];
+    }
+    reading.time = mock.unixTime();
+    rig.history.add(reading.fields[0], reading.fields[1], millivolts);
+
+    if(rig.started == true && reading.time / INTERVAL != rig.current.time / INTERVAL) {
+        rig.kept.push_back(rig.current);
+    }
+    rig.current = reading;
+    rig.started = true;
+    mock.advance(INTERVAL * 1000);
+}
+
+// parse a page of tier 0 into its records and <next>; false if it is not well formed
+bool parse(const char *page, std::vector<Record> *records, uint32_t *next) {
+    char *at;
+    int tier = strtol(page, &at, 10);
+
+    if(tier != 0 || *at != ',' || strtoul(at + 1, &at, 10) != INTERVAL || *at != ',') {
+        return false;
+    }
+    *next = strtoul(at + 1, &at, 10);
+    while(*at == ';') {
+        uint32_t time = strtoul(at + 1, &at, 10);
+        char separator = ':';
+
+        if(*at != ':') {
+            return false;
+        }
+        while(*at == separator) {
+            Record record = { time, { 0 } };
+            for(int field = 0; field < FIELDS; field++) {
+                at++;       // past the ":", "," or "/"
+                if(field < 2 && at[0] == '-' && isdigit(at[1]) == false) {
+                    record.fields[field] = HISTORY_NO_READING;
+                    at++;
+                } else {
+                    record.fields[field] = strtol(at, &at, 10);
+                }
+                if(field < FIELDS - 1 && *at != '/') {
+                    return false;
+                }
+            }
+            records->push_back(record);
+            time += INTERVAL;
+            separator = ',';
+        }
+    }
+    return *at == '\0';
+}
+
+// the records of the whole tier, from "from" on, as one page
+std::vector<Record> wholePage(Rig &rig, uint32_t from = 0) {
+    static char page[20000];
+    std::vector<Record> records;
+    uint32_t next;
+
+    int written = rig.history.format(page, sizeof(page), 0, from);
+    CHECK(parse(page, &records, &next) == true, "a page not well formed:  %.80s", page);
+    CHECK(next == 0 && written == (int)records.size(), "a whole page of %d records, %zu parsed, next %lu", written,
+          records.size(), (unsigned long)next);
+    return records;
+}
+
+// the number of runs (";") on a page
+int runs(Rig &rig) {
+    static char page[20000];
+
+    rig.history.format(page, sizeof(page), 0, 0);
+    return std::count(page, page + strlen(page), ';');
+}
+
+void roundTrip(WLDHalMock &mock) {
+    Rig rig(mock);
+
+    for(int i = 0; i < 20; i++) {
+        addReading(mock, rig, 5, i == 7);
+    }
+    mock.advance(30 * INTERVAL * 1000);     // a gap of 30 slots
+    for(int i = 0; i < 5; i++) {
+        addReading(mock, rig, 5);
+    }
+
+    std::vector<Record> records = wholePage(rig);
+    CHECK(records == rig.kept, "%zu records kept, %zu on the page, or they differ", rig.kept.size(), records.size());
+    CHECK(runs(rig) == 2, "%d runs either side of a gap", runs(rig));
+    CHECK(rig.history.format(NULL, 0, 1, 0) == -1, "a page of a tier that was not added");
+    printf("round trip:  %zu records in 2 runs, one slot without a reading\n", records.size());
+}
+
+void paging(WLDHalMock &mock) {
+    const int PAGE_SIZE = 100;
+    Rig rig(mock);
+    char page[PAGE_SIZE];
+    std::vector<Record> records;
+    uint32_t from = 0, next;
+    int pages = 0;
+
+    for(int i = 0; i < 60; i++) {
+        addReading(mock, rig, 20);
+    }
+    do {
+        int written = rig.history.format(page, sizeof(page), 0, from);
+        size_t before = records.size();
+        CHECK(strlen(page) < sizeof(page) && parse(page, &records, &next) == true, "a page not well formed:  %s", page);
+        CHECK(written == (int)(records.size() - before) && written > 0, "%d records written, %zu parsed", written,
+              records.size() - before);
+        CHECK(next == 0 || next > from, "the next page starts at %lu, from %lu", (unsigned long)next,
+              (unsigned long)from);
+        from = next;
+        pages++;
+    } while(next != 0 && pages < 100);
+
+    CHECK(pages > 1, "%zu records fit on one page of %d characters", records.size(), PAGE_SIZE);
+    CHECK(records == rig.kept, "%zu records kept, %zu on the pages, or they differ", rig.kept.size(), records.size());
+
+    std::vector<Record> later(rig.kept.begin() + 25, rig.kept.end());
+    CHECK(wholePage(rig, rig.kept[25].time) == later, "a page from record 25 on does not start there");
+    printf("paging:  %zu records on %d pages of %d characters\n", records.size(), pages, PAGE_SIZE);
+}
+
+// "records" are the kept records from some record on, to the newest
+bool newestRecords(const std::vector<Record> &records, const std::vector<Record> &kept) {
+    return records.size() <= kept.size() && std::equal(records.begin(), records.end(), kept.end() - records.size());
+}
+
+void rollover(WLDHalMock &mock) {
+    Rig rig(mock);
+    int newest = rig.store.header.newest, moves = 0;
+
+    for(int i = 0; i < 2000; i++) {
+        addReading(mock, rig, 200);
+        moves += (rig.store.header.newest != newest);
+        newest = rig.store.header.newest;
+    }
+
+    std::vector<Record> records = wholePage(rig);
+    int stored = 0;
+    for(int i = 0; i < BLOCKS; i++) {
+        stored += rig.store.blocks[i].count;
+    }
+    CHECK(moves > 4 * BLOCKS, "the blocks were only reused %d times", moves);
+    CHECK(records.size() == (size_t)stored && stored < (int)rig.kept.size(), "%zu records on the page, %d stored",
+          records.size(), stored);
+    CHECK(newestRecords(records, rig.kept), "the page does not hold the newest records");
+    CHECK(runs(rig) == 1, "%d runs after a rollover", runs(rig));
+    printf("rollover:  the newest %zu of %zu records, after %d moves to the next of %d blocks\n", records.size(),
+           rig.kept.size(), moves, BLOCKS);
+}
+
+void badCrc(WLDHalMock &mock) {
+    Rig rig(mock);
+
+    for(int i = 0; i < 500; i++) {
+        addReading(mock, rig, 200);
+    }
+    std::vector<Record> before = wholePage(rig);
+
+    // damage the oldest block, as a reset while it was being written would; the next block is started in it
+    WLDHistoryBlock *damaged = &rig.store.blocks[(rig.store.header.newest + 1) % BLOCKS];
+    uint32_t from = damaged->time, to = damaged->time + damaged->count * INTERVAL;
+    damaged->data[0] ^= 1;
+
+    WLDHistory after;
+    after.begin(&mock, PROBES);
+    after.addTier(&rig.store, INTERVAL);
+    rig.history = after;
+    rig.started = false;    // the slot in progress is lost with the reset
+    std::vector<Record> records = wholePage(rig), expected;
+    for(const Record &record : before) {
+        if(record.time < from || record.time >= to) {
+            expected.push_back(record);
+        }
+    }
+    CHECK(damaged->count == 0 && damaged->length == 0, "the damaged block kept %d records", damaged->count);
+    CHECK(expected.size() < before.size() && records == expected, "%zu records before, %zu after, %zu expected",
+          before.size(), records.size(), expected.size());
+
+    // and the records go on after the newest one
+    for(int i = 0; i < 3; i++) {
+        addReading(mock, rig, 200);
+    }
+    records = wholePage(rig);
+    expected.insert(expected.end(), rig.kept.end() - 2, rig.kept.end());
+    CHECK(records == expected,
+          "the records after the second begin() do not follow on");
+    printf("bad block CRC:  the block of %lu records emptied by a second begin(), %zu records kept\n",
+           (unsigned long)((to - from) / INTERVAL), expected.size());
+}
+
+int main() {
+    WLDHalMock mock;
+
+    mock.begin(WLDHalMock::CLOCK_SIMULATED);
+    mock.setUnixTime(START_TIME);
+    roundTrip(mock);
+    paging(mock);
+    rollover(mock);
+    badCrc(mock);
+    return testResult();
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * LoopBenchmark:  loop() passes per second and the cost of each phase, on a host
+ *
+ * Runs the whole firmware on a simulated device (see WLDHalMock.h) in CLOCK_FAST_FORWARD mode,
+ * so that the code takes the time it takes on the host while the waits between tasks are
+ * skipped.  A pass of the sensing thread (sensingPass()) runs in the same host thread after each
+ * loop() pass, as if the sensing thread ran whenever loop() waits.
+ *
+ * The scenario is 10 simulated minutes with a DHT 11 at 21 C and 45 %RH and two dry water probes
+ * reading a little noise, except that probe A is wet from minute 5 for 30 seconds.  The loop
+ * profiler is turned on with the LoopProfiler cloud function, as from the app.
+ *
+ * Reports the loop() passes per second of host time spent in loop() and in the sensing tasks,
+ * and the min/p50/p99/max of each phase of loop() and of the sensing thread (in microseconds of
+ * host time; see WLDLoopProfiler.h).  Host numbers are only comparable with each other:  the
+ * Photon runs the same code some tens of times slower.  Checks that the water alarm was sent.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Run the sensing thread's passes with sensingPass()
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDHalMock.h>
+#include <WLDLoopProfiler.h>
+#include <WLDTest.h>
+#include <PietteTech_DHT.h>
+#include <chrono>
+
+// the firmware
+void setup();
+void loop();
+void sensingPass();
+extern WLDHal *hal;
+extern WLDLoopProfiler profiler;
+extern WLDLoopProfiler sensingProfiler;
+
+const unsigned long RUN_TIME = 600000;      // 10 simulated minutes
+const unsigned long WET_START = 300000;     // probe A is wet from minute 5
+const unsigned long WET_TIME = 30000;       //  for 30 seconds
+const int DRY_COUNTS = 120;                 // about 0.1 V
+const int WET_COUNTS = 2500;                // about 2 V
+
+// print a profiler summary, "phase:min/p50/p99/max,...", a phase per line
+void printPhases(const char *title, WLDLoopProfiler *phases) {
+    char summary[600];
+    char *phase;
+
+    phases->format(summary, sizeof(summary));
+    printf("%s (us of host time, min/p50/p99/max):\n", title);
+    for(phase = strtok(summary, ","); phase != NULL; phase = strtok(NULL, ",")) {
+        printf("    %s\n", phase);
+    }
+}   // end of printPhases()
+
+int main() {
+    WLDHalMock mock;
+    unsigned long passes = 0;
+    std::chrono::steady_clock::duration busy(0);
+
+    mock.begin(WLDHalMock::CLOCK_FAST_FORWARD);
+    mock.addDhtSensor(D2, DHT11);
+    mock.setDhtReading(D2, 21, 45);
+    mock.setUnixTime(1792195200);
+    mock.analogSource(A0, [](unsigned long now) {
+        bool wet = now >= WET_START && now < WET_START + WET_TIME;
+        return (wet ? WET_COUNTS : DRY_COUNTS) + (int)(now * 7919 % 31) - 15;
+    });
+    mock.analogSource(A1, [](unsigned long now) { return DRY_COUNTS + (int)(now * 104729 % 31) - 15; });
+
+    hal = &mock;
+    setup();
+    CHECK(Particle.callFunction("LoopProfiler", "on") == 0, "LoopProfiler on");
+
+    while(mock.millis() < RUN_TIME) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        loop();
+        sensingPass();
+        busy += std::chrono::steady_clock::now() - start;
+        passes++;
+    }
+
+    double seconds = std::chrono::duration<double>(busy).count();
+    printf("%lu loop() passes in %lu simulated seconds, %.1f ms of host time:  %.0f passes/s\n",
+           passes, RUN_TIME / 1000, seconds * 1000, passes / seconds);
+    printf("%lu ADC samples, %lu DHT readings, %d events published\n", (unsigned long)mock.analogReads(),
+           (unsigned long)mock.dhtReadings(D2), (int)mock.events().size());
+    printPhases("loop()", &profiler);
+    printPhases("sensing thread", &sensingProfiler);
+
+    CHECK(passes >= RUN_TIME / 10, "%lu passes", passes);  // loop() waits at most 10 ms
+    CHECK(mock.dhtReadings(D2) > 0, "no DHT readings");
+    CHECK(mock.countEvents("WLDAlarmWaterLeak") == 1, "%d water alarms sent", mock.countEvents("WLDAlarmWaterLeak"));
+    CHECK(mock.resets() == 0, "%lu resets", (unsigned long)mock.resets());
+    return testResult();
+}
@@ -0,0 +1,153 @@
+/*******************************************************************************
+ * OversamplingTest:  false alarms and detection time of WLDWaterSensors, with and without oversampling
+ *
+ * Simulates a water sensor probe read every 10 ms:  about 0.1 V with 60 counts of noise while
+ * dry, about 2 V with 60 counts of noise while wet, and in a given fraction of the samples (1% and
+ * 5%) a spike, to 0.5..3.3 V while dry and to below the 0.5 V threshold while wet.  For each
+ * setting of oversampling (samples per reading, of which the median is taken) and alarm limit:
+ *
+ * - false alarms:  the probe stays dry for DRY_HOURS; reports the alarms per hour
+ * - detection:  the probe gets wet WET_TRIALS times; reports the median and the longest time from
+ *   getting wet to the alarm, in ms (each reading counts 10 ms)
+ *
+ * Checks that the median of 5 samples gives no more false alarms than a single sample with a
+ * higher alarm limit and detects sooner:  limit 2 against limit 3, and limit 3 against limit 5.
+ * And that the median of 5 with limit 3 gives no false alarms at all.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDHalMock.h>
+#include <WLDWaterSensors.h>
+#include <WLDTest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+const unsigned long SAMPLE_INTERVAL = 10;       // ms
+const int DRY_HOURS = 4;
+const int WET_TRIALS = 2000;
+const unsigned long WET_TIME = 1000;            // ms wet in each detection trial
+const int DRY_COUNTS = 120;                     // about 0.1 V
+const int WET_COUNTS = 2500;                    // about 2 V
+const int NOISE_COUNTS = 60;
+
+const WLDWaterChannel CHANNELS[] = {
+    { A0, WLDWaterSensors::NO_MUX },
+};
+
+struct Setting {
+    uint8_t oversampling;
+    uint8_t alarmLimit;
+};
+const Setting SETTINGS[] = { { 1, 3 }, { 5, 2 }, { 1, 5 }, { 5, 3 } };
+const int NUM_SETTINGS = sizeof(SETTINGS) / sizeof(SETTINGS[0]);
+const float SPIKE_RATES[] = { 0.01, 0.05 };
+const int NUM_SPIKE_RATES = 2;
+
+struct Result {
+    float falseAlarmsPerHour;
+    unsigned long medianDetection;  // ms
+    unsigned long longestDetection;
+};
+
+std::mt19937 generator(2026);
+bool wet = false;
+float spikeRate = 0;
+uint16_t threshold = voltsToAdcCounts(0.5);
+
+// one ADC sample of the simulated probe
+int probe(unsigned long now) {
+    std::uniform_real_distribution<float> chance(0, 1);
+    std::uniform_int_distribution<int> noise(-NOISE_COUNTS, NOISE_COUNTS);
+
+    if(chance(generator) < spikeRate) {
+        return wet ? std::uniform_int_distribution<int>(0, threshold)(generator)
+                   : std::uniform_int_distribution<int>(threshold + 1, ADC_FULL_SCALE_COUNTS)(generator);
+    }
+    return (wet ? WET_COUNTS : DRY_COUNTS) + noise(generator);
+}
+
+Result run(WLDHalMock &mock, const Setting &setting) {
+    WLDWaterSensors sensors;
+    Result result;
+    std::vector<unsigned long> detections;
+
+    sensors.begin(&mock, CHANNELS, 1, NULL, 0, threshold, setting.alarmLimit);
+    sensors.setOversampling(setting.oversampling);
+
+    // false alarms, dry
+    wet = false;
+    unsigned long end = mock.millis() + DRY_HOURS * 3600000UL;
+    while(mock.millis() < end) {
+        sensors.sample();
+        mock.advance(SAMPLE_INTERVAL);
+    }
+    result.falseAlarmsPerHour = (float)sensors.detections() / DRY_HOURS;
+
+    // detection; each trial starts dry and out of alarm
+    for(int trial = 0; trial < WET_TRIALS; trial++) {
+        wet = false;
+        while(sensors.anyAlarm() || sensors.sample()) {
+            mock.advance(SAMPLE_INTERVAL);
+        }
+        wet = true;
+        unsigned long readings = 0;
+        do {
+            readings++;
+            mock.advance(SAMPLE_INTERVAL);
+        } while(sensors.sample() == false && readings * SAMPLE_INTERVAL < WET_TIME);
+        detections.push_back(readings * SAMPLE_INTERVAL);
+        wet = false;
+        while(sensors.sample()) {
+            mock.advance(SAMPLE_INTERVAL);
+        }
+    }
+    std::sort(detections.begin(), detections.end());
+    result.medianDetection = detections[WET_TRIALS / 2];
+    result.longestDetection = detections.back();
+    return result;
+}
+
+int main() {
+    WLDHalMock mock;
+    Result results[NUM_SPIKE_RATES][NUM_SETTINGS];
+
+    mock.begin(WLDHalMock::CLOCK_SIMULATED);
+    mock.analogSource(A0, probe);
+
+    for(int rate = 0; rate < NUM_SPIKE_RATES; rate++) {
+        spikeRate = SPIKE_RATES[rate];
+        for(int s = 0; s < NUM_SETTINGS; s++) {
+            Result &r = results[rate][s];
+            r = run(mock, SETTINGS[s]);
+            printf("spikes in %2.0f%% of samples, %s%d, limit %d:  %6.2f false alarms per hour, "
+                   "detection in %lu ms (longest %lu ms)\n", SPIKE_RATES[rate] * 100,
+                   SETTINGS[s].oversampling == 1 ? "sample " : "median of ", SETTINGS[s].oversampling,
+                   SETTINGS[s].alarmLimit, r.falseAlarmsPerHour, r.medianDetection, r.longestDetection);
+        }
+    }
+
+    // settings 1 and 3 (median of 5) against settings 0 and 2 (one sample, a higher limit)
+    for(int rate = 0; rate < NUM_SPIKE_RATES; rate++) {
+        for(int s = 0; s < NUM_SETTINGS; s += 2) {
+            Result &single = results[rate][s];
+            Result &median = results[rate][s + 1];
+            CHECK(median.falseAlarmsPerHour <= single.falseAlarmsPerHour,
+                  "%.0f%% spikes, median of 5, limit %d:  %.2f false alarms per hour, one sample, limit %d:  %.2f",
+                  SPIKE_RATES[rate] * 100, SETTINGS[s + 1].alarmLimit, median.falseAlarmsPerHour,
+                  SETTINGS[s].alarmLimit, single.falseAlarmsPerHour);
+            CHECK(median.medianDetection < single.medianDetection,
+                  "%.0f%% spikes, median of 5, limit %d:  detection in %lu ms, one sample, limit %d:  %lu ms",
+                  SPIKE_RATES[rate] * 100, SETTINGS[s + 1].alarmLimit, median.medianDetection,
+                  SETTINGS[s].alarmLimit, single.medianDetection);
+        }
+        CHECK(results[rate][3].falseAlarmsPerHour == 0, "%.0f%% spikes, median of 5, limit 3:  %.2f false alarms per hour",
+              SPIKE_RATES[rate] * 100, results[rate][3].falseAlarmsPerHour);
+    }
+    return testResult();
+}
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * PsychrometricsTest:  the integer dew point and heat index against the DHT library's
+ *
+ * WLDPsychrometrics.h computes the dew point and heat index in integer arithmetic and documents
+ * its maximum error against PietteTech_DHT's double precision getDewPoint(), getDewPointSlow()
+ * and getHeatIndex().  This test measures those errors and checks them against the table there.
+ *
+ * Every reading a DHT 22 can send from -40 to 80 C and from 1 to 100 %RH, in its 0.1 C and
+ * 0.1 %RH steps, is encoded as an edge timing trace and replayed through a DHT 22 decoder (see
+ * DhtReplay.cpp), so that the library functions work from the decoded reading as they do on the
+ * device.  The WLD functions are given the reading as WLDSensorBus gives it to them:  degrees F
+ * and %RH in fixed point.  The errors are reported, in degrees F, over the DHT 11 range (0 to
+ * 50 C) and over the whole DHT 22 range.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <PietteTech_DHT_T.h>
+#include <WLDHalMock.h>
+#include <WLDPsychrometrics.h>
+#include <WLDTest.h>
+
+// nominal timing, in microseconds
+const uint16_t T_RELEASE = 30;      // start pulse released to first falling edge
+const uint16_t T_RESPONSE = 160;    // 80us low + 80us high response
+const uint16_t T_ZERO = 78;         // 50us low + 28us high
+const uint16_t T_ONE = 120;         // 50us low + 70us high
+
+// the maximum errors documented in WLDPsychrometrics.h, degrees F:  DHT 11 range, DHT 22 range
+const double DEW_POINT_ERROR[2] = { 0.04, 0.05 };
+const double DEW_POINT_SLOW_ERROR[2] = { 0.42, 0.64 };
+const double HEAT_INDEX_ERROR[2] = { 0.07, 0.13 };
+
+enum { DEW_POINT, DEW_POINT_SLOW, HEAT_INDEX, NUM_FUNCTIONS };
+const char *FUNCTION_NAMES[NUM_FUNCTIONS] = { "dewPoint() - getDewPoint()", "dewPoint() - getDewPointSlow()",
+                                              "heatIndex() - getHeatIndex()" };
+
+PietteTech_DHT_T<DHT22Type, DHTFixedTiming<> > DHT22only(D3);
+
+// build the trace of a DHT 22 reading of "tenthsC" and "tenthsRH"; returns the number of edges
+int buildTrace(uint16_t *t, int tenthsC, int tenthsRH) {
+    uint16_t temperature = (tenthsC < 0) ? (0x8000 | -tenthsC) : tenthsC;
+    uint8_t bytes[5] = { (uint8_t)(tenthsRH >> 8), (uint8_t)tenthsRH, (uint8_t)(temperature >> 8),
+                         (uint8_t)temperature, 0 };
+    int n = 0;
+
+    bytes[4] = bytes[0] + bytes[1] + bytes[2] + bytes[3];
+    t[n++] = T_RELEASE;
+    t[n++] = T_RESPONSE;
+    for(int bit = 0; bit < 40; bit++) {
+        t[n++] = ((bytes[bit / 8] >> (7 - bit % 8)) & 1) ? T_ONE : T_ZERO;
+    }
+    return n;
+}
+
+double celsiusToFahrenheit(double celsius) {
+    return celsius * 1.8 + 32;
+}
+
+int main() {
+    uint16_t trace[42];
+    double worst[NUM_FUNCTIONS][2] = { { 0 } };
+    int decodeFailures = 0;
+
+    WLDHalMock::device();       // the DHT library's pins and clock
+    DHT22only.begin();
+
+    for(int tenthsC = -400; tenthsC <= 800; tenthsC++) {
+        bool dht11Range = tenthsC >= 0 && tenthsC <= 500;
+        for(int tenthsRH = 10; tenthsRH <= 1000; tenthsRH++) {
+            if(DHT22only.replay(trace, buildTrace(trace, tenthsC, tenthsRH)) != DHTLIB_OK) {
+                decodeFailures++;
+                continue;
+            }
+            fixed_t temperature = floatToFixed(DHT22only.getFahrenheit());
+            fixed_t humidity = floatToFixed(DHT22only.getHumidity());
+            double error[NUM_FUNCTIONS];
+
+            error[DEW_POINT] = fixedToFloat(dewPoint(temperature, humidity)) -
+                               celsiusToFahrenheit(DHT22only.getDewPoint());
+            error[DEW_POINT_SLOW] = fixedToFloat(dewPoint(temperature, humidity)) -
+                                    celsiusToFahrenheit(DHT22only.getDewPointSlow());
+            error[HEAT_INDEX] = fixedToFloat(heatIndex(temperature, humidity)) -
+                                celsiusToFahrenheit(DHT22only.getHeatIndex());
+            for(int f = 0; f < NUM_FUNCTIONS; f++) {
+                if(dht11Range) {
+                    worst[f][0] = fmax(worst[f][0], fabs(error[f]));
+                }
+                worst[f][1] = fmax(worst[f][1], fabs(error[f]));
+            }
+        }
+    }
+
+    CHECK(decodeFailures == 0, "%d readings did not decode", decodeFailures);
+    printf("maximum error, degrees F:           DHT 11 range   DHT 22 range\n");
+    for(int f = 0; f < NUM_FUNCTIONS; f++) {
+        printf("%-34s %8.3f       %8.3f\n", FUNCTION_NAMES[f], worst[f][0], worst[f][1]);
+    }
+
+    const double *documented[NUM_FUNCTIONS] = { DEW_POINT_ERROR, DEW_POINT_SLOW_ERROR, HEAT_INDEX_ERROR };
+    for(int f = 0; f < NUM_FUNCTIONS; f++) {
+        for(int range = 0; range < 2; range++) {
+            CHECK(worst[f][range] <= documented[f][range], "%s, %s range:  %.3f F, documented %.3f F",
+                  FUNCTION_NAMES[f], range == 0 ? "DHT 11" : "DHT 22", worst[f][range], documented[f][range]);
+        }
+    }
+    return testResult();
+}
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * SensingThreadTest:  the sensing thread keeps reading the water sensors while loop() is held up
+ *
+ * Runs the whole firmware on a simulated device (see WLDHalMock.h) in CLOCK_REAL mode, so that
+ * the sensing thread runs on a host thread of its own, as on the Photon, and the waits are real.
+ * loop() runs on the main thread, and is held up for STALL_TIME every CYCLE_TIME, as by a slow
+ * publish or EEPROM write.  Probe A gets wet in the middle of a hold up.
+ *
+ * Reports the longest time between two water sensor readings and the time from the probe getting
+ * wet to the buzzer sounding, and checks them:  the readings stay within WATER_SLOW_INTERVAL
+ * (100 ms) plus MAX_LATE of each other, and the buzzer sounds within MAX_BUZZER_TIME, both while
+ * loop() is held up.  Also checks that the LoopProfiler cloud function's requests, made from the
+ * main thread, reach the sensing thread's profiler.
+ *
+ * The sensing thread is never stopped, so the test ends with _Exit().
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDHalMock.h>
+#include <WLDLoopProfiler.h>
+#include <WLDTest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// the firmware
+void setup();
+void loop();
+extern WLDHal *hal;
+extern WLDLoopProfiler sensingProfiler;
+
+const int ALARM_PIN = D6;                   // the firmware's buzzer pin
+const unsigned long RUN_TIME = 5000;        // ms
+const unsigned long CYCLE_TIME = 2500;      // loop() is held up for STALL_TIME of every CYCLE_TIME
+const unsigned long STALL_TIME = 1500;
+const unsigned long WET_START = 3500;       // probe A is wet from here, in the second hold up
+const unsigned long SLOW_INTERVAL = 100;    // the firmware's WATER_SLOW_INTERVAL
+const unsigned long MAX_LATE = 50;          // host scheduling allowance
+const unsigned long MAX_BUZZER_TIME = 250;  // ms from wet to the buzzer
+const int DRY_COUNTS = 120;                 // about 0.1 V
+const int WET_COUNTS = 2500;                // about 2 V
+
+std::atomic<unsigned long> lastRead(0);     // time of the last reading of probe A
+std::atomic<unsigned long> longestGap(0);   // longest time between two readings
+
+// probe A; records the time between readings (the samples of a burst come at the same time)
+int probeA(unsigned long now) {
+    unsigned long last = lastRead.exchange(now);
+    if(last != 0 && now - last > longestGap) {
+        longestGap = now - last;
+    }
+    return (now >= WET_START) ? WET_COUNTS : DRY_COUNTS;
+}
+
+// wait for the sensing thread to take a profiler request
+bool waitForProfiler(bool enabled) {
+    for(int i = 0; i < 100; i++) {
+        if(sensingProfiler.enabled() == enabled) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+int main() {
+    WLDHalMock mock;
+    unsigned long buzzer = 0;       // time the buzzer first sounded
+
+    mock.begin(WLDHalMock::CLOCK_REAL);
+    mock.analogSource(A0, probeA);
+    mock.analogSource(A1, [](unsigned long now) { return DRY_COUNTS; });
+    hal = &mock;
+    setup();
+    CHECK(mock.numThreads() == 1, "%d threads started", mock.numThreads());
+
+    CHECK(Particle.callFunction("LoopProfiler", "on") == 0, "LoopProfiler on");
+    CHECK(waitForProfiler(true), "the sensing thread profiler was not enabled");
+
+    while(mock.millis() < RUN_TIME) {
+        if(mock.millis() % CYCLE_TIME < CYCLE_TIME - STALL_TIME) {
+            loop();
+            continue;
+        }
+        // loop() is held up; watch the buzzer meanwhile
+        if(buzzer == 0 && mock.level(ALARM_PIN) == HIGH) {
+            buzzer = mock.millis();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    printf("longest time between water sensor readings:  %lu ms\n", (unsigned long)longestGap);
+    printf("buzzer sounded %ld ms after the probe got wet\n", buzzer == 0 ? -1L : (long)(buzzer - WET_START));
+    CHECK(longestGap <= SLOW_INTERVAL + MAX_LATE, "%lu ms between readings", (unsigned long)longestGap);
+    CHECK(buzzer != 0 && buzzer - WET_START <= MAX_BUZZER_TIME, "buzzer %ld ms after wet",
+          buzzer == 0 ? -1L : (long)(buzzer - WET_START));
+
+    CHECK(Particle.callFunction("LoopProfiler", "off") == 0, "LoopProfiler off");
+    CHECK(waitForProfiler(false), "the sensing thread profiler was not disabled");
+    CHECK(mock.resets() == 0, "%lu resets", (unsigned long)mock.resets());
+
+    int result = testResult();
+    fflush(stdout);
+    _Exit(result);
+}
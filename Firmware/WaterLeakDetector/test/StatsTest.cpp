@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * StatsTest:  WLDStats agrees with its statistics recomputed from every sample in the window
+ *
+ * Keeps every sample added to a WLDStats, with its time, and after each one recomputes the
+ * statistics of each window by brute force:  the samples of the window are those of the current
+ * slot and the SLOTS - 1 slots before it, the slots counted from the time of begin().  The
+ * lowest, highest, average and rate of change must be equal; the variance and deviation,
+ * recomputed in long double with the mean taken out first, within one fixed point unit.
+ *
+ * - Random walk:  two simulated days of a temperature that drifts up and down, with spikes,
+ * added at random intervals with gaps of several slots, of more than an hour and of more than a
+ * day, so that slots expire one at a time and whole windows at once, and the monotonic queues
+ * of the lowest and highest values grow, shrink and drop slots from the front.
+ *
+ * - Large sums:  60000 samples near 150 F in a day, whose sums of squares (and the count times
+ * them) need the int64 totals, and whose small deviation is lost to cancellation in float.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDStats.h>
+#include <WLDTest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+const unsigned long WINDOW_TIMES[WLDStats::NUM_WINDOWS] = { 60000, 3600000, 86400000 };    // ms
+const char *const WINDOWS[WLDStats::NUM_WINDOWS] = { "minute", "hour", "day" };
+const unsigned long START = 1000;       // millis() of begin()
+
+std::mt19937 generator(2026);
+
+struct Sample {
+    fixed_t value;
+    unsigned long time;
+};
+
+// the statistics of one window, recomputed from the samples
+struct Expected {
+    uint32_t count;
+    fixed_t lowest, highest, average, rate;
+    long double variance, deviation;    // in fixed point units
+};
+
+Expected recompute(const std::vector<Sample> &samples, unsigned long window, unsigned long now) {
+    unsigned long slotTime = window / WLDWindowStats::SLOTS;
+    long current = (now - START) / slotTime;
+    Expected expected = {};
+    int64_t sum = 0;
+    long newestSlot = -1, oldestSlot = -1;
+    int64_t newestSum = 0, oldestSum = 0, newestCount = 0, oldestCount = 0;
+
+    // the samples of the window are at the end of the list
+    size_t first = samples.size();
+    while(first > 0 && (long)((samples[first - 1].time - START) / slotTime) > current - WLDWindowStats::SLOTS) {
+        first--;
+    }
+    for(size_t i = first; i < samples.size(); i++) {
+        fixed_t value = samples[i].value;
+        long slot = (samples[i].time - START) / slotTime;
+
+        if(expected.count == 0 || value < expected.lowest) {
+            expected.lowest = value;
+        }
+        if(expected.count == 0 || value > expected.highest) {
+            expected.highest = value;
+        }
+        expected.count++;
+        sum += value;
+
+        if(oldestSlot < 0 || slot == oldestSlot) {
+            oldestSlot = slot;
+            oldestSum += value;
+            oldestCount++;
+        }
+        if(slot != newestSlot) {
+            newestSlot = slot;
+            newestSum = newestCount = 0;
+        }
+        newestSum += value;
+        newestCount++;
+    }
+    if(expected.count == 0) {
+        return expected;
+    }
+
+    expected.average = (fixed_t)(sum / (int64_t)expected.count);
+    long double mean = (long double)sum / expected.count, squares = 0;
+    for(size_t i = first; i < samples.size(); i++) {
+        squares += (samples[i].value - mean) * (samples[i].value - mean);
+    }
+    expected.variance = squares / expected.count / FIXED_ONE;
+    expected.deviation = sqrtl(squares / expected.count);
+    if(newestSlot != oldestSlot) {
+        int64_t change = (fixed_t)(newestSum / newestCount) - (fixed_t)(oldestSum / oldestCount);
+        expected.rate = (fixed_t)(change * 3600000 / ((newestSlot - oldestSlot) * (int64_t)slotTime));
+    }
+    return expected;
+}
+
+// compare a window with its recomputed statistics; false (once reported) if they differ
+bool compare(WLDStats &stats, int window, const std::vector<Sample> &samples, unsigned long now) {
+    WLDWindowStats *result = stats.window(window);
+    Expected expected = recompute(samples, WINDOW_TIMES[window], now);
+    bool same = result->count() == expected.count;
+
+    if(same == true && expected.count > 0) {
+        same = result->lowest() == expected.lowest && result->highest() == expected.highest &&
+               result->average() == expected.average && result->ratePerHour() == expected.rate &&
+               fabsl(result->variance() - expected.variance) <= 1 && fabsl(result->deviation() - expected.deviation) <= 1;
+    }
+    CHECK(same, "the %s window at %lu ms:  count %lu/%lu, lowest %ld/%ld, highest %ld/%ld, average %ld/%ld, "
+          "rate %ld/%ld, variance %ld/%.1Lf, deviation %ld/%.1Lf", WINDOWS[window], now,
+          (unsigned long)result->count(), (unsigned long)expected.count, (long)result->lowest(), (long)expected.lowest,
+          (long)result->highest(), (long)expected.highest, (long)result->average(), (long)expected.average,
+          (long)result->ratePerHour(), (long)expected.rate, (long)result->variance(), expected.variance,
+          (long)result->deviation(), expected.deviation);
+    return same;
+}
+
+void randomWalk() {
+    const unsigned long DURATION = 2 * 86400000UL;
+    WLDStats stats;
+    std::vector<Sample> samples;
+    unsigned long now = START;
+    fixed_t value = intToFixed(70);
+    int drift = 1, checks = 0, failures = 0;
+    bool dayGap = false;
+
+    stats.begin(now);
+    while(now - START < DURATION && failures == 0) {
+        unsigned long gap = generator() % 10000;       // up to 2 slots of the minute window
+        int kind = generator() % 1000;
+
+        if(kind == 0) {
+            gap = 3600000 + generator() % 3600000;       // more than an hour
+        } else if(dayGap == false && now - START > DURATION / 2) {
+            gap = 86400000 + generator() % 3600000;      // more than a day, once
+            dayGap = true;
+        } else if(kind < 20) {
+            gap = generator() % 600000;                  // several slots of the hour window
+        }
+        now += gap;
+
+        if(generator() % 400 == 0) {
+            drift = -drift;
+        }
+        value += drift * (int)(generator() % 32) + (int)(generator() % 33) - 16;
+        fixed_t sample = value;
+        if(generator() % 50 == 0) {
+            sample += (generator() % 2 == 0 ? 1 : -1) * intToFixed(generator() % 20);   // a spike
+        }
+        value = constrain(value, intToFixed(-40), intToFixed(150));
+
+        if(generator() % 10 == 0) {
+            stats.advance(now);     // no sample, only time passing
+        } else {
+            stats.add(sample, now);
+            samples.push_back({ sample, now });
+        }
+        for(int window = 0; window < WLDStats::NUM_WINDOWS; window++) {
+            if(window < WLDStats::WINDOW_DAY || samples.size() % 16 == 0) {
+                failures += (compare(stats, window, samples, now) == false);
+                checks++;
+            }
+        }
+    }
+    printf("random walk:  %zu samples over %lu hours, %d comparisons of a window\n", samples.size(),
+           (now - START) / 3600000, checks);
+}
+
+void largeSums() {
+    const int SAMPLES = 60000;
+    WLDStats stats;
+    std::vector<Sample> samples;
+    unsigned long now = START;
+    float sum = 0, sumSquares = 0;
+
+    stats.begin(now);
+    for(int i = 0; i < SAMPLES; i++) {
+        fixed_t sample = intToFixed(150) + (int)(generator() % 65) - 32;    // 150 F, give or take 1/8
+
+        now += 1400;
+        stats.add(sample, now);
+        samples.push_back({ sample, now });
+        sum += sample;
+        sumSquares += (float)sample * sample;
+    }
+    compare(stats, WLDStats::WINDOW_DAY, samples, now);
+
+    WLDWindowStats *day = stats.window(WLDStats::WINDOW_DAY);
+    float floatVariance = sumSquares / day->count() - (sum / day->count()) * (sum / day->count());
+    printf("large sums:  %lu samples of the day window, deviation %ld (1/256 F), %.0f from float sums\n",
+           (unsigned long)day->count(), (long)day->deviation(), sqrtf(fabsf(floatVariance)));
+}
+
+int main() {
+    randomWalk();
+    largeSums();
+    return testResult();
+}
@@ -0,0 +1,268 @@
+/*******************************************************************************
+ * TelemetryTest:  the WLDTelemetry events decode back into the samples that were added
+ *
+ * Runs a WLDTelemetry against the simulated device's mock cloud (see WLDHalMock.h) in
+ * CLOCK_SIMULATED mode, and decodes every published event as the format in WLDTelemetry.h says:
+ * base64 (RFC 4648, with padding), then the header and the varint fields of each sample, the
+ * alarm and leak bits exclusive or'ed with, and the others zigzag differences from, the previous
+ * sample.
+ *
+ * - Padding:  events of one sample each, whose records are 0, 1 and 2 bytes over a multiple of
+ * 3, so that the base64 ends without padding, with "==" and with "=".
+ *
+ * - Worst case:  three hours of samples of TELEMETRY_PROBES probes, a minute apart, with random
+ * values in every field, so that every field takes its longest encoding, and a window of
+ * TELEMETRY_SAMPLES.  Checks that every event is at most TELEMETRY_DATA_SIZE - 1 characters, that
+ * a window splits across events, and that the events hold every published sample, in order,
+ * once, with none dropped.
+ *
+ * - A quiet hour:  an hour of unchanging samples of two probes fits in one event.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDEventQueue.h>
+#include <WLDHalMock.h>
+#include <WLDTelemetry.h>
+#include <WLDTest.h>
+#include <WLDVarint.h>
+#include <random>
+#include <string>
+#include <vector>
+
+const char EVENT_NAME[] = "WLDTelemetry";
+const uint32_t START_TIME = 1792195200;     // Unix time
+const unsigned long SAMPLE_INTERVAL = 60000;    // ms
+
+std::mt19937 generator(2026);
+
+// decode RFC 4648 base64 with padding into binary; false if it is not well formed
+bool unbase64(const std::string &text, std::vector<uint8_t> *binary) {
+    static const std::string ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    binary->clear();
+    if(text.size() % 4 != 0) {
+        return false;
+    }
+    for(size_t i = 0; i < text.size(); i += 4) {
+        uint32_t group = 0;
+        int padding = 0;
+        for(int j = 0; j < 4; j++) {
+            char c = text[i + j];
+            if(c == '=' && i + 4 == text.size() && j >= 2) {
+                padding++;
+                group <<= 6;
+                continue;
+            }
+            size_t value = ALPHABET.find(c);
+            if(value == std::string::npos || padding > 0) {
+                return false;
+            }
+            group = (group << 6) | value;
+        }
+        binary->push_back(group >> 16);
+        if(padding < 2) {
+            binary->push_back((group >> 8) & 0xff);
+        }
+        if(padding < 1) {
+            binary->push_back(group & 0xff);
+        }
+    }
+    return true;
+}
+
+// decode the record of one event, appending its samples; false if it is not well formed
+bool decode(const std::vector<uint8_t> &record, std::vector<WLDTelemetrySample> *samples) {
+    WLDTelemetrySample previous = {};
+    size_t at = 3;
+
+    if(record.size() < 3 || record[0] != 1 || record[1] > TELEMETRY_PROBES) {
+        return false;
+    }
+    int probes = record[1];
+    for(int count = 0; count < record[2]; count++) {
+        uint32_t fields[5 + TELEMETRY_PROBES];
+        for(int field = 0; field < 5 + probes; field++) {
+            int length = getVarint(record.data() + at, record.size() - at, &fields[field]);
+            if(length == 0) {
+                return false;
+            }
+            at += length;
+        }
+        WLDTelemetrySample sample = {};
+        sample.time = previous.time + unzigzag(fields[0]);
+        sample.alarms = previous.alarms ^ fields[1];
+        sample.leaks = previous.leaks ^ fields[2];
+        sample.temperature = previous.temperature + unzigzag(fields[3]);
+        sample.humidity = previous.humidity + unzigzag(fields[4]);
+        for(int probe = 0; probe < probes; probe++) {
+            sample.levels[probe] = previous.levels[probe] + unzigzag(fields[5 + probe]);
+        }
+        samples->push_back(sample);
+        previous = sample;
+    }
+    return at == record.size();     // nothing left over
+}
+
+bool sameSample(const WLDTelemetrySample &a, const WLDTelemetrySample &b, int probes) {
+    if(a.time != b.time || a.alarms != b.alarms || a.leaks != b.leaks || a.temperature != b.temperature ||
+       a.humidity != b.humidity) {
+        return false;
+    }
+    for(int probe = 0; probe < probes; probe++) {
+        if(a.levels[probe] != b.levels[probe]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// a telemetry, and the event queue that holds its rate limit, on a fresh mock cloud
+struct Rig {
+    WLDEventQueueStore store;
+    WLDEventQueue queue;
+    WLDTelemetry telemetry;
+
+    Rig(WLDHalMock &mock, int probes, int window) {
+        memset(&store, 0, sizeof(store));
+        mock.clearEvents();
+        queue.begin(&mock, &mock, &store);
+        telemetry.begin(&mock, &mock, &queue, EVENT_NAME, probes, window);
+    }
+};
+
+// publish until nothing is waiting, a token at a time; false if an event is malformed
+bool publishAll(WLDHalMock &mock, Rig &rig, std::vector<WLDTelemetrySample> *decoded, size_t *longest,
+                std::vector<size_t> *recordSizes) {
+    bool wellFormed = true;
+
+    for(int i = 0; i < 100 && rig.telemetry.pending() > 0; i++) {
+        mock.advance(1000);
+        rig.telemetry.process();
+    }
+    for(const WLDMockEvent &event : mock.events()) {
+        std::vector<uint8_t> record;
+        *longest = std::max(*longest, event.data.size());
+        if(unbase64(event.data, &record) == false || decode(record, decoded) == false) {
+            CHECK(false, "event not well formed:  %s", event.data.c_str());
+            wellFormed = false;
+            continue;
+        }
+        if(recordSizes != NULL) {
+            recordSizes->push_back(record.size());
+        }
+    }
+    mock.clearEvents();
+    return wellFormed;
+}
+
+void padding(WLDHalMock &mock) {
+    // records of 12, 13 and 14 bytes:  a 5 byte time, then fields of 1 or 2 bytes
+    const int16_t TEMPERATURES[] = { 20, 700, 700 };
+    const int16_t HUMIDITIES[] = { 45, 45, 450 };
+    bool seen[3] = { false, false, false };
+
+    for(int i = 0; i < 3; i++) {
+        Rig rig(mock, 0, 1);
+        WLDTelemetrySample sample = {};
+        std::vector<WLDTelemetrySample> decoded;
+        std::vector<size_t> sizes;
+        size_t longest = 0;
+
+        sample.temperature = TEMPERATURES[i];
+        sample.humidity = HUMIDITIES[i];
+        rig.telemetry.add(&sample);
+        publishAll(mock, rig, &decoded, &longest, &sizes);
+        CHECK(decoded.size() == 1 && sameSample(decoded[0], sample, 0), "the sample of %d, %d did not decode back",
+              sample.temperature, sample.humidity);
+        for(size_t size : sizes) {
+            seen[size % 3] = true;
+        }
+    }
+    CHECK(seen[0] && seen[1] && seen[2], "records of length 0, 1, 2 mod 3 seen:  %d, %d, %d", seen[0], seen[1],
+          seen[2]);
+    printf("padding:  records of length 0, 1 and 2 mod 3 decode back\n");
+}
+
+void worstCase(WLDHalMock &mock) {
+    const int HOURS = 3;
+    Rig rig(mock, TELEMETRY_PROBES, TELEMETRY_SAMPLES);
+    std::vector<WLDTelemetrySample> added, decoded;
+    std::vector<size_t> sizes;
+    size_t longest = 0;
+
+    // a sample and a process() a minute, as the firmware does; a full window splits across events
+    for(int i = 0; i < HOURS * TELEMETRY_SAMPLES; i++) {
+        WLDTelemetrySample sample;
+        sample.alarms = generator();
+        sample.leaks = generator();
+        sample.temperature = (int16_t)generator();
+        sample.humidity = (int16_t)generator();
+        for(int probe = 0; probe < TELEMETRY_PROBES; probe++) {
+            sample.levels[probe] = generator() % 4096;
+        }
+        mock.advance(SAMPLE_INTERVAL);
+        rig.telemetry.add(&sample);
+        added.push_back(sample);
+        rig.telemetry.process();
+    }
+    publishAll(mock, rig, &decoded, &longest, &sizes);
+
+    CHECK(longest <= (size_t)TELEMETRY_DATA_SIZE - 1, "an event of %zu characters", longest);
+    CHECK(sizes.size() > (size_t)HOURS, "%zu events for %d full windows", sizes.size(), HOURS);
+    CHECK(rig.telemetry.dropped() == 0, "%lu samples dropped", (unsigned long)rig.telemetry.dropped());
+    CHECK(decoded.size() == rig.telemetry.published() &&
+          decoded.size() + rig.telemetry.pending() == added.size(),
+          "%zu samples added, %zu decoded, %lu published, %d waiting", added.size(), decoded.size(),
+          (unsigned long)rig.telemetry.published(), rig.telemetry.pending());
+    bool same = decoded.size() <= added.size();
+    for(size_t i = 0; same && i < decoded.size(); i++) {
+        same = sameSample(decoded[i], added[i], TELEMETRY_PROBES);
+        CHECK(same, "sample %zu did not decode back", i);
+    }
+    printf("worst case:  %zu samples of %d probes in %zu events, the longest %zu characters (limit %d)\n",
+           decoded.size(), TELEMETRY_PROBES, sizes.size(), longest, TELEMETRY_DATA_SIZE - 1);
+}
+
+void quietHour(WLDHalMock &mock) {
+    Rig rig(mock, 2, TELEMETRY_SAMPLES);
+    std::vector<WLDTelemetrySample> added, decoded;
+    std::vector<size_t> sizes;
+    size_t longest = 0;
+
+    for(int i = 0; i < TELEMETRY_SAMPLES; i++) {
+        WLDTelemetrySample sample = {};
+        sample.temperature = 685;
+        sample.humidity = 452;
+        sample.levels[0] = 120;
+        sample.levels[1] = 118;
+        mock.advance(SAMPLE_INTERVAL);
+        rig.telemetry.add(&sample);
+        added.push_back(sample);
+    }
+    publishAll(mock, rig, &decoded, &longest, &sizes);
+
+    CHECK(sizes.size() == 1, "a quiet hour took %zu events", sizes.size());
+    bool same = decoded.size() == added.size();
+    for(size_t i = 0; same && i < added.size(); i++) {
+        same = sameSample(decoded[i], added[i], 2);
+    }
+    CHECK(same, "the quiet hour did not decode back");
+    printf("quiet hour:  %d samples of 2 probes in %zu event of %zu characters\n", TELEMETRY_SAMPLES, sizes.size(),
+           longest);
+}
+
+int main() {
+    WLDHalMock mock;
+
+    mock.begin(WLDHalMock::CLOCK_SIMULATED);
+    mock.setUnixTime(START_TIME);
+    padding(mock);
+    worstCase(mock);
+    quietHour(mock);
+    return testResult();
+}
@@ -0,0 +1,239 @@
+/*******************************************************************************
+ * ThresholdReplay:  temperature alarms sent for a noisy temperature at or near the high limit
+ *
+ * Runs the whole firmware on a simulated device (see WLDHalMock.h) in CLOCK_FAST_FORWARD mode,
+ * with a DHT 11 whose temperature follows a wave, with 1 F of noise on each reading, for RUN_TIME,
+ * against an 80 F high limit:
+ *
+ *   wandering   a triangle wave 1.5 F either side of the limit, once an hour
+ *   hovering    a triangle wave 0.6 F either side of the limit, once an hour
+ *   approaching a sawtooth rising at 6 F per hour to 1 F short of the limit and dropping 6 F, as
+ *               when a heater turns off, once an hour
+ *
+ * Each scenario is run twice:  with the default alarm hysteresis (1 F deadbands, 60 second
+ * dwells) and with none ("SetAlarmHysteresis" "0,0,0,0"), which compares the smoothed temperature
+ * directly with the limit, as before version 2.25.  Each run is a child process, as the
+ * firmware's globals can only be set up once.
+ *
+ * Reports the temperature alarms published (high, predicted high, low and predicted low), and
+ * checks that, with the default hysteresis:
+ *
+ * - a scenario that crosses the limit sends fewer alarms than without hysteresis, and at most one
+ *   high temperature alarm per excursion above the limit
+ * - the predicted high temperature alarm is sent for the approach, and at most once per rise
+ *
+ * and, with and without hysteresis, that after every pass a predicted alarm condition is present
+ * exactly when the zone has the predicted alarm (its WLDThreshold, with deadband and dwell), and
+ * that a predicted alarm condition never holds, or publishes, more minutes than the horizon and
+ * deadband (PREDICTION_HORIZON + PREDICTION_DEADBAND).
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDAlarmProcessor.h>
+#include <WLDHalMock.h>
+#include <WLDTest.h>
+#include <PietteTech_DHT.h>
+#include <random>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// the firmware
+void setup();
+void loop();
+void sensingPass();
+uint8_t zoneAlarmFlags(int zone);
+extern WLDHal *hal;
+extern WLDAlarmProcessor alarmer;
+
+const unsigned long RUN_TIME = 4 * 3600000UL;   // 4 simulated hours
+const unsigned long READING_TIME = 4000;        // the firmware's DHT_SAMPLE_INTERVAL
+const float HIGH_LIMIT = 80;                    // F
+const float NOISE = 1;                          // F, either way
+const int LONGEST_PREDICTION = 25;              // PREDICTION_HORIZON (20) + PREDICTION_DEADBAND (5) minutes
+const uint8_t ZONE_LOW_TEMP_PREDICTED = 8;      // the firmware's zone alarm flags
+const uint8_t ZONE_HIGH_TEMP_PREDICTED = 16;
+
+enum { HIGH_TEMP, HIGH_TEMP_PREDICTED, LOW_TEMP, LOW_TEMP_PREDICTED, NUM_ALARMS };
+const char *EVENTS[NUM_ALARMS] = { "WLDAlarmHighTemp", "WLDAlarmHighTempPredicted", "WLDAlarmLowTemp",
+                                   "WLDAlarmLowTempPredicted" };
+
+struct Result {
+    int alarms[NUM_ALARMS];
+    int longestPrediction;          // most minutes held by a present predicted alarm condition, or published
+    int mismatches;                 // passes with a predicted alarm condition that differs from the zone's flag
+    int resets;
+};
+
+struct Scenario {
+    float center;                   // F
+    float amplitude;                // F either way
+    unsigned long period;           // ms
+    bool sawtooth;                  // rising through the period and dropping back, instead of a triangle wave
+};
+const Scenario SCENARIOS[] = {
+    { HIGH_LIMIT, 1.5, 3600000, false },        // wandering
+    { HIGH_LIMIT, 0.6, 3600000, false },        // hovering
+    { HIGH_LIMIT - 4, 3, 3600000, true },       // approaching
+};
+const int NUM_SCENARIOS = sizeof(SCENARIOS) / sizeof(SCENARIOS[0]);
+
+// the temperature of "scenario" at "now":  a triangle wave rising from the center first, or a sawtooth
+float temperature(const Scenario &scenario, unsigned long now) {
+    float phase = (float)(now % scenario.period) / scenario.period;
+    if(scenario.sawtooth) {
+        return scenario.center + scenario.amplitude * (2 * phase - 1);
+    }
+    float wave = (phase < 0.25) ? 4 * phase : (phase < 0.75) ? 2 - 4 * phase : 4 * phase - 4;
+    return scenario.center + scenario.amplitude * wave;
+}
+
+// run the firmware through "scenario"
+Result run(const Scenario &scenario, bool hysteresis) {
+    WLDHalMock mock;
+    std::mt19937 generator(2026);
+    std::uniform_real_distribution<float> noise(-NOISE, NOISE);
+    unsigned long reading = 0;
+    Result result;
+
+    memset(&result, 0, sizeof(result));
+
+    mock.begin(WLDHalMock::CLOCK_FAST_FORWARD);
+    mock.addDhtSensor(D2, DHT11);
+    mock.setUnixTime(1792195200);
+    hal = &mock;
+    setup();
+    Particle.callFunction("SetTempAlarmLimits", "40,80");
+    if(hysteresis == false) {
+        Particle.callFunction("SetAlarmHysteresis", "0,0,0,0");
+    }
+
+    while(mock.millis() < RUN_TIME) {
+        if(mock.millis() / READING_TIME != reading) {
+            reading = mock.millis() / READING_TIME;
+            float fahrenheit = temperature(scenario, mock.millis()) + noise(generator);
+            mock.setDhtReading(D2, (fahrenheit - 32) / 1.8, 45);
+        }
+        loop();
+        sensingPass();
+
+        // a predicted alarm condition is present exactly when zone 0 has the predicted alarm
+        uint8_t flags = zoneAlarmFlags(0);
+        uint32_t conditions = alarmer.conditions();
+        if(((flags & ZONE_LOW_TEMP_PREDICTED) != 0) != ((conditions & (1UL << ALARM_LOW_TEMP_PREDICTED)) != 0) ||
+           ((flags & ZONE_HIGH_TEMP_PREDICTED) != 0) != ((conditions & (1UL << ALARM_HIGH_TEMP_PREDICTED)) != 0)) {
+            result.mismatches++;
+        }
+        for(WLDAlarmType type : { ALARM_LOW_TEMP_PREDICTED, ALARM_HIGH_TEMP_PREDICTED }) {
+            if((conditions & (1UL << type)) != 0) {
+                result.longestPrediction = std::max(result.longestPrediction, fixedToInt(alarmer.value(type)));
+            }
+        }
+    }
+
+    for(int alarm = 0; alarm < NUM_ALARMS; alarm++) {
+        result.alarms[alarm] = mock.countEvents(EVENTS[alarm]);
+    }
+    for(const WLDMockEvent &event : mock.events()) {
+        size_t equals = event.data.find("= ");
+        if(event.name.find("Predicted") != std::string::npos && equals != std::string::npos) {
+            result.longestPrediction = std::max(result.longestPrediction, atoi(event.data.c_str() + equals + 2));
+        }
+    }
+    result.resets = mock.resets();
+    return result;
+}
+
+// run() in a child process, which writes its result to "*fd"; returns the child's pid
+pid_t startChild(const Scenario &scenario, bool hysteresis, int *fd) {
+    int fds[2];
+
+    if(pipe(fds) != 0) {
+        return -1;
+    }
+    pid_t child = fork();
+    if(child == 0) {
+        close(fds[0]);
+        Result result = run(scenario, hysteresis);
+        ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == sizeof(result) ? 0 : 1);
+    }
+    close(fds[1]);
+    *fd = fds[0];
+    return child;
+}
+
+// the result of a child started by startChild()
+Result finishChild(pid_t child, int fd) {
+    Result result;
+
+    memset(&result, 0, sizeof(result));
+    if(child < 0 || read(fd, &result, sizeof(result)) != sizeof(result)) {
+        result.resets = -1;
+    }
+    close(fd);
+    waitpid(child, NULL, 0);
+    return result;
+}
+
+void report(const char *title, const Result &result, int total) {
+    printf("    %-15s %3d alarms (%d high, %d predicted high, %d low, %d predicted low)\n", title, total,
+           result.alarms[HIGH_TEMP], result.alarms[HIGH_TEMP_PREDICTED], result.alarms[LOW_TEMP],
+           result.alarms[LOW_TEMP_PREDICTED]);
+}
+
+void check(const Scenario &scenario, const Result &with, const Result &without) {
+    int withTotal = 0, withoutTotal = 0;
+
+    for(int alarm = 0; alarm < NUM_ALARMS; alarm++) {
+        withTotal += with.alarms[alarm];
+        withoutTotal += without.alarms[alarm];
+    }
+    printf("%.1f F either side of %.1f F, every %.1f hours, for %d hours:\n", scenario.amplitude, scenario.center,
+           scenario.period / 3600000.0, (int)(RUN_TIME / 3600000));
+    report("hysteresis:", with, withTotal);
+    report("no hysteresis:", without, withoutTotal);
+
+    CHECK(with.resets == 0 && without.resets == 0, "resets:  %d, %d", with.resets, without.resets);
+    int rises = RUN_TIME / scenario.period;
+    int excursions = (scenario.center + scenario.amplitude > HIGH_LIMIT) ? rises : 0;
+    if(excursions > 0) {
+        CHECK(withTotal < withoutTotal, "%.1f F:  %d alarms with hysteresis, %d without", scenario.amplitude, withTotal,
+              withoutTotal);
+        CHECK(with.alarms[HIGH_TEMP] <= excursions, "%.1f F:  %d high temperature alarms for %d excursions",
+              scenario.amplitude, with.alarms[HIGH_TEMP], excursions);
+    } else {
+        CHECK(with.alarms[HIGH_TEMP_PREDICTED] >= 1, "%.1f F:  no predicted high temperature alarm",
+              scenario.amplitude);
+    }
+    CHECK(with.alarms[HIGH_TEMP_PREDICTED] <= rises, "%.1f F:  %d predicted high temperature alarms for %d rises",
+          scenario.amplitude, with.alarms[HIGH_TEMP_PREDICTED], rises);
+    CHECK(with.mismatches == 0 && without.mismatches == 0,
+          "%.1f F:  %d passes with a predicted alarm condition that is not the zone's predicted alarm",
+          scenario.amplitude, with.mismatches + without.mismatches);
+    CHECK(with.longestPrediction <= LONGEST_PREDICTION && without.longestPrediction <= LONGEST_PREDICTION,
+          "%.1f F:  a predicted alarm held %d minutes", scenario.amplitude,
+          std::max(with.longestPrediction, without.longestPrediction));
+}
+
+int main() {
+    pid_t children[NUM_SCENARIOS][2];
+    int fds[NUM_SCENARIOS][2];
+
+    // all of the runs at once
+    for(int i = 0; i < NUM_SCENARIOS; i++) {
+        for(int hysteresis = 0; hysteresis < 2; hysteresis++) {
+            children[i][hysteresis] = startChild(SCENARIOS[i], hysteresis == 1, &fds[i][hysteresis]);
+        }
+    }
+    for(int i = 0; i < NUM_SCENARIOS; i++) {
+        Result without = finishChild(children[i][0], fds[i][0]);
+        Result with = finishChild(children[i][1], fds[i][1]);
+        check(SCENARIOS[i], with, without);
+    }
+    return testResult();
+}
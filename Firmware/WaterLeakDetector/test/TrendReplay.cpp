@@ -0,0 +1,155 @@
+/*******************************************************************************
+ * TrendReplay:  how early WLDTrend warns of a low temperature limit, and how often it warns falsely
+ *
+ * Replays simulated DHT 11 readings (whole degrees C, with 0.3 C of noise, one every 4 seconds,
+ * as the firmware reads each zone) into a WLDTrend, against the firmware's default 40 F low
+ * limit.  A warning is a time to fall to the limit of PREDICTION_HORIZON (20 minutes) or less,
+ * as for the firmware's predicted low temperature alarm; the limit alarm is the 10 point moving
+ * average of the readings (as WLDSensorBus smooths them) at or below the limit.
+ *
+ *   cooling     steady at 52 F for an hour, then cooling at 2, 4, 8 and 16 F per hour, RUNS times
+ *               each:  reports the median and lowest lead of the first warning over the limit
+ *               alarm, in minutes
+ *   steady      42, 46 and 50 F for STEADY_HOURS:  reports the warnings
+ *   cycling     a heating cycle of +-2 F around 46, 48 and 50 F, each cycle 20 to 90 minutes long,
+ *               for CYCLING_HOURS:  reports the warnings
+ *
+ * Checks that the warning comes at least MIN_LEAD minutes before the limit alarm (median) when
+ * cooling at 4 F per hour or faster, that steady temperatures give no warnings, and that a
+ * heating cycle 8 F or more above the limit gives fewer than one warning a day.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "Particle.h"
+#include <WLDTrend.h>
+#include <WLDTest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+const unsigned long READING_INTERVAL = 4000;    // the firmware's DHT_SAMPLE_INTERVAL
+const unsigned long HORIZON = 1200000;          // the firmware's PREDICTION_HORIZON
+const float LIMIT = 40;                         // default low temperature limit, F
+const float NOISE = 0.3;                        // reading noise, C
+const int RUNS = 200;
+const int STEADY_HOURS = 360;
+const int CYCLING_HOURS = 504;
+const int MIN_LEAD = 10;                        // minutes
+
+const unsigned long HOUR = 3600000;
+
+std::mt19937 generator(2026);
+std::normal_distribution<float> noise(0, NOISE);
+
+// a DHT 11 reading of "fahrenheit", in fixed point degrees F
+fixed_t dht11Reading(float fahrenheit) {
+    float celsius = roundf((fahrenheit - 32) / 1.8 + noise(generator));
+    return floatToFixed(celsius * 1.8 + 32);
+}
+
+// replays "temperature" (F, of the time in milliseconds) for "duration"; counts the warnings
+//  (the times the predicted time to the limit comes within the horizon) and returns the time of
+//  the first warning and of the limit alarm (or "duration" when there is none)
+template <class Temperature>
+int replay(Temperature temperature, unsigned long duration, unsigned long *firstWarning,
+           unsigned long *alarm) {
+    WLDTrend trend;
+    fixed_t smoothed = 0;
+    bool warning = false;
+    int warnings = 0;
+
+    trend.begin();
+    *firstWarning = duration;
+    *alarm = duration;
+    for(unsigned long now = 0; now < duration; now += READING_INTERVAL) {
+        fixed_t reading = dht11Reading(temperature(now));
+        smoothed = (now == 0) ? reading : smoothed + (reading - smoothed) / 10;
+        trend.add(reading, now);
+
+        bool predicted = trend.timeToFall(floatToFixed(LIMIT), now) <= HORIZON;
+        if(predicted && !warning) {
+            warnings++;
+            *firstWarning = std::min(*firstWarning, now);
+        }
+        warning = predicted;
+        if(smoothed <= floatToFixed(LIMIT) && *alarm == duration) {
+            *alarm = now;
+        }
+    }
+    return warnings;
+}
+
+// steady at "start" for an hour, then cooling at "rate" F per hour
+void cooling(float rate) {
+    std::vector<float> leads;
+
+    for(int run = 0; run < RUNS; run++) {
+        float start = 52 + std::uniform_real_distribution<float>(-0.9, 0.9)(generator);
+        unsigned long firstWarning, alarm;
+        unsigned long duration = HOUR + (unsigned long)((start - LIMIT + 5) / rate * HOUR);
+
+        replay([=](unsigned long now) {
+            return (now < HOUR) ? start : start - rate * (now - HOUR) / HOUR;
+        }, duration, &firstWarning, &alarm);
+        leads.push_back(firstWarning < alarm ? (alarm - firstWarning) / 60000.0 : 0);
+    }
+    std::sort(leads.begin(), leads.end());
+    float median = leads[RUNS / 2];
+    printf("cooling %4.1f F/hour:  warning %4.1f minutes before the limit alarm (median), lowest %4.1f\n",
+           rate, median, leads[0]);
+    if(rate >= 4) {
+        CHECK(median >= MIN_LEAD, "cooling at %.1f F/hour:  median lead %.1f minutes", rate, median);
+    }
+}
+
+void steady(float fahrenheit) {
+    unsigned long firstWarning, alarm;
+    int warnings = replay([=](unsigned long now) { return fahrenheit; }, STEADY_HOURS * HOUR, &firstWarning, &alarm);
+
+    printf("steady %4.1f F:  %d warnings in %d hours\n", fahrenheit, warnings, STEADY_HOURS);
+    CHECK(warnings == 0, "steady %.1f F:  %d warnings", fahrenheit, warnings);
+}
+
+void cycling(float average) {
+    std::vector<unsigned long> cycleEnds;
+    std::vector<unsigned long> cycleLengths;
+    unsigned long firstWarning, alarm;
+
+    for(unsigned long end = 0; end < CYCLING_HOURS * HOUR; ) {
+        unsigned long length = std::uniform_int_distribution<unsigned long>(20, 90)(generator) * 60000;
+        end += length;
+        cycleEnds.push_back(end);
+        cycleLengths.push_back(length);
+    }
+    size_t cycle = 0;
+    int warnings = replay([&](unsigned long now) {
+        while(now >= cycleEnds[cycle]) {
+            cycle++;
+        }
+        float phase = 1 - (float)(cycleEnds[cycle] - now) / cycleLengths[cycle];
+        return average + 2 * sinf(2 * (float)M_PI * phase);
+    }, CYCLING_HOURS * HOUR, &firstWarning, &alarm);
+
+    printf("cycling +-2 F around %4.1f F:  %d warnings in %d hours\n", average, warnings, CYCLING_HOURS);
+    if(average - LIMIT >= 8) {
+        CHECK(warnings < CYCLING_HOURS / 24, "cycling around %.1f F:  %d warnings", average, warnings);
+    }
+}
+
+int main() {
+    cooling(2);
+    cooling(4);
+    cooling(8);
+    cooling(16);
+    steady(42);
+    steady(46);
+    steady(50);
+    cycling(46);
+    cycling(48);
+    cycling(50);
+    return testResult();
+}
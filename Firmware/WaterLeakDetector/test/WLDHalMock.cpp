@@ -0,0 +1,456 @@
+/*******************************************************************************
+ * WLDHalMock:  simulated device for running the WLD firmware on a host
+ *
+ * See WLDHalMock.h for a description.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Added the start pulse observations
+ *
+ *******************************************************************************/
+#include <WLDHalMock.h>
+#include <PietteTech_DHT_T.h>
+#include <thread>
+
+WLDHalMock *WLDHalMock::_active = NULL;
+
+// Constructor
+WLDHalMock::WLDHalMock() {
+    // follow convention and put all initializations in begin() method
+}   // end of Constructor
+
+// Initialization
+void WLDHalMock::begin(ClockMode mode) {
+    _mode = mode;
+    _origin = std::chrono::steady_clock::now();
+    _skipped = 0;
+    _unixTimeBase = 0;
+
+    for(int pin = 0; pin < HOST_NUM_PINS; pin++) {
+        _pinModes[pin] = INPUT;
+        _levels[pin] = HIGH;        // an unconnected input floats high
+        _writes[pin] = 0;
+        _analogLevels[pin] = 0;
+        _analogSources[pin] = nullptr;
+        _interrupts[pin] = nullptr;
+        _drivenLow[pin] = false;
+        _pulses[pin] = 0;
+        _shortestPulse[pin] = 0;
+        _longestPulse[pin] = 0;
+        memset(&_dht[pin], 0, sizeof(DhtSensor));
+    }
+    _analogReads = 0;
+    _servoPosition = -1;
+
+    memset(_eeprom, 0xff, sizeof(_eeprom));
+    _eepromBudget = -1;
+    _eepromBytesWritten = 0;
+
+    _connected = true;
+    _publishFails = false;
+    _events.clear();
+
+    _numThreads = 0;
+    _resetReason = RESET_REASON_POWER_DOWN;
+    _resetData = 0;
+    _resets = 0;
+    _watchdogTimeout = 0;
+
+    _active = this;
+}   // end of begin()
+
+// the device that the Device OS stubs reach:  the last one begun, or a simulated one of their own
+WLDHalMock &WLDHalMock::device() {
+    static WLDHalMock fallback;
+
+    if(_active == NULL) {
+        fallback.begin(CLOCK_SIMULATED);
+    }
+    return *_active;
+}   // end of device()
+
+// Simulation control
+
+void WLDHalMock::advance(unsigned long milliseconds) {
+    _skipped += (uint64_t)milliseconds * 1000;
+}   // end of advance()
+
+void WLDHalMock::advanceMicros(unsigned long microseconds) {
+    _skipped += microseconds;
+}   // end of advanceMicros()
+
+// set the time of day, as the cloud does
+void WLDHalMock::setUnixTime(uint32_t time) {
+    _unixTimeBase = time - millis() / 1000;
+}   // end of setUnixTime()
+
+void WLDHalMock::setDigital(int pin, int level) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _levels[pin] = level;
+}   // end of setDigital()
+
+void WLDHalMock::setAnalog(int pin, int counts) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _analogSources[pin] = nullptr;
+    _analogLevels[pin] = counts;
+}   // end of setAnalog()
+
+// read an analog pin from "source", given millis(), from now on
+void WLDHalMock::analogSource(int pin, std::function<int(unsigned long)> source) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _analogSources[pin] = source;
+}   // end of analogSource()
+
+void WLDHalMock::addDhtSensor(int pin, int type) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _dht[pin].attached = true;
+    _dht[pin].present = true;
+    _dht[pin].type = type;
+    _dht[pin].temperature = 20;
+    _dht[pin].humidity = 50;
+    _dht[pin].readings = 0;
+}   // end of addDhtSensor()
+
+// the reading that the sensor sends from now on, in degrees C and %RH
+void WLDHalMock::setDhtReading(int pin, float temperature, float humidity) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _dht[pin].temperature = temperature;
+    _dht[pin].humidity = humidity;
+}   // end of setDhtReading()
+
+void WLDHalMock::setDhtPresent(int pin, bool present) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _dht[pin].present = present;
+}   // end of setDhtPresent()
+
+// let only "bytes" more bytes be written to EEPROM; -1 for no limit
+void WLDHalMock::tearEepromWrites(long bytes) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _eepromBudget = bytes;
+}   // end of tearEepromWrites()
+
+void WLDHalMock::setCloudConnected(bool connected) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _connected = connected;
+}   // end of setCloudConnected()
+
+void WLDHalMock::setPublishFails(bool fails) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _publishFails = fails;
+}   // end of setPublishFails()
+
+void WLDHalMock::setResetReason(int reason, uint32_t data) {
+    _resetReason = reason;
+    _resetData = data;
+}   // end of setResetReason()
+
+// Observations
+
+int WLDHalMock::pinModeOf(int pin) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _pinModes[pin];
+}   // end of pinModeOf()
+
+int WLDHalMock::level(int pin) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _levels[pin];
+}   // end of level()
+
+uint32_t WLDHalMock::writes(int pin) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _writes[pin];
+}   // end of writes()
+
+uint32_t WLDHalMock::analogReads() {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _analogReads;
+}   // end of analogReads()
+
+uint32_t WLDHalMock::startPulses(int pin) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _pulses[pin];
+}   // end of startPulses()
+
+unsigned long WLDHalMock::shortestStartPulse(int pin) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _shortestPulse[pin];
+}   // end of shortestStartPulse()
+
+unsigned long WLDHalMock::longestStartPulse(int pin) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _longestPulse[pin];
+}   // end of longestStartPulse()
+
+uint32_t WLDHalMock::dhtReadings(int pin) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _dht[pin].readings;
+}   // end of dhtReadings()
+
+int WLDHalMock::servoPosition() {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _servoPosition;
+}   // end of servoPosition()
+
+uint32_t WLDHalMock::eepromBytesWritten() {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _eepromBytesWritten;
+}   // end of eepromBytesWritten()
+
+std::vector<WLDMockEvent> WLDHalMock::events() {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _events;
+}   // end of events()
+
+// number of events published named "name"
+int WLDHalMock::countEvents(const char *name) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    int count = 0;
+
+    for(size_t i = 0; i < _events.size(); i++) {
+        if(_events[i].name == name) {
+            count++;
+        }
+    }
+    return count;
+}   // end of countEvents()
+
+void WLDHalMock::clearEvents() {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _events.clear();
+}   // end of clearEvents()
+
+// Device OS stubs
+
+// attach an interrupt handler; a DHT sensor on the pin answers the start pulse at once
+void WLDHalMock::attachInterrupt(int pin, std::function<void()> handler) {
+    bool answer;
+
+    {
+        std::lock_guard<std::recursive_mutex> guard(_lock);
+        _interrupts[pin] = handler;
+        answer = _dht[pin].attached && _dht[pin].present && _pinModes[pin] == INPUT;
+    }
+    if(answer == true) {
+        playDhtReading(pin, handler);
+    }
+}   // end of attachInterrupt()
+
+void WLDHalMock::detachInterrupt(int pin) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _interrupts[pin] = nullptr;
+}   // end of detachInterrupt()
+
+// WLDHal:  time base
+
+unsigned long WLDHalMock::millis() {
+    return micros() / 1000;
+}   // end of millis()
+
+unsigned long WLDHalMock::micros() {
+    uint64_t elapsed = 0;
+
+    if(_mode != CLOCK_SIMULATED) {
+        elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - _origin).count();
+    }
+    return (unsigned long)(elapsed + _skipped);
+}   // end of micros()
+
+void WLDHalMock::delay(unsigned long milliseconds) {
+    if(_mode == CLOCK_REAL) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    } else {
+        advance(milliseconds);
+    }
+}   // end of delay()
+
+uint32_t WLDHalMock::unixTime() {
+    return (_unixTimeBase == 0) ? 0 : _unixTimeBase + millis() / 1000;
+}   // end of unixTime()
+
+// WLDHal:  threads
+
+// run the thread on a host thread in CLOCK_REAL mode; otherwise only record it
+void WLDHalMock::startThread(const char *name, void (*function)(void *), void *arg, int priority, size_t stackSize) {
+    if(_numThreads < MAX_THREADS) {
+        _threads[_numThreads++] = { name, function, arg, priority };
+    }
+    if(_mode == CLOCK_REAL) {
+        std::thread(function, arg).detach();    // never stopped; the process ends with it running
+    }
+}   // end of startThread()
+
+// WLDHal:  resets
+
+int WLDHalMock::resetReason(uint32_t *data) {
+    *data = _resetData;
+    return _resetReason;
+}   // end of resetReason()
+
+void WLDHalMock::reset() {
+    _resets++;
+}   // end of reset()
+
+void WLDHalMock::startWatchdog(unsigned long timeout, void (*expired)()) {
+    _watchdogTimeout = timeout;
+}   // end of startWatchdog()
+
+// WLDHal:  pins
+
+// releasing a pin that is driven low to an input ends a start pulse
+void WLDHalMock::pinMode(int pin, int mode) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _pinModes[pin] = mode;
+    if(mode != OUTPUT && _drivenLow[pin] == true) {
+        unsigned long pulse = micros() - _lowSince[pin];
+        if(_pulses[pin] == 0 || pulse < _shortestPulse[pin]) {
+            _shortestPulse[pin] = pulse;
+        }
+        if(pulse > _longestPulse[pin]) {
+            _longestPulse[pin] = pulse;
+        }
+        _pulses[pin]++;
+        _drivenLow[pin] = false;
+    }
+}   // end of pinMode()
+
+int WLDHalMock::analogRead(int pin) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _analogReads++;
+    if(_analogSources[pin] != nullptr) {
+        return constrain(_analogSources[pin](millis()), 0, 4095);
+    }
+    return _analogLevels[pin];
+}   // end of analogRead()
+
+void WLDHalMock::analogReadBurst(int pin, uint16_t *samples, int count) {
+    for(int i = 0; i < count; i++) {
+        samples[i] = analogRead(pin);
+    }
+}   // end of analogReadBurst()
+
+int WLDHalMock::digitalRead(int pin) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _levels[pin];
+}   // end of digitalRead()
+
+void WLDHalMock::digitalWrite(int pin, int value) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _levels[pin] = value;
+    _writes[pin]++;
+    if(_pinModes[pin] == OUTPUT && _drivenLow[pin] != (value == LOW)) {
+        _drivenLow[pin] = (value == LOW);
+        _lowSince[pin] = micros();
+    }
+}   // end of digitalWrite()
+
+// WLDHal:  servo meter
+
+void WLDHalMock::servoAttach(int pin) {
+    // nothing to do; the position written is kept
+}   // end of servoAttach()
+
+void WLDHalMock::servoWrite(int position) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _servoPosition = position;
+}   // end of servoWrite()
+
+// WLDHal:  non-volatile storage
+
+void WLDHalMock::eepromRead(int address, void *data, size_t length) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    uint8_t *bytes = (uint8_t *)data;
+
+    for(size_t i = 0; i < length; i++) {
+        bytes[i] = (address + i < EEPROM_SIZE) ? _eeprom[address + i] : 0xff;
+    }
+}   // end of eepromRead()
+
+// write to EEPROM, up to the bytes that tearEepromWrites() still lets through
+void WLDHalMock::eepromWrite(int address, const void *data, size_t length) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    for(size_t i = 0; i < length && address + i < EEPROM_SIZE; i++) {
+        if(_eepromBudget == 0) {
+            return;     // the rest of the write is lost
+        }
+        if(_eepromBudget > 0) {
+            _eepromBudget--;
+        }
+        _eeprom[address + i] = bytes[i];
+        _eepromBytesWritten++;
+    }
+}   // end of eepromWrite()
+
+// WLDHal:  memory
+
+void WLDHalMock::heapStats(WLDHeapStats *stats) {
+    stats->inUse = 20000;
+    stats->free = System.freeMemory();
+    stats->holes = 0;
+}   // end of heapStats()
+
+// WLDHal:  cloud
+
+bool WLDHalMock::cloudConnected() {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    return _connected;
+}   // end of cloudConnected()
+
+bool WLDHalMock::publish(const char *eventName, const char *eventData) {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+
+    if(_connected == false || _publishFails == true) {
+        return false;
+    }
+    _events.push_back({ eventName, eventData, millis() });
+    return true;
+}   // end of publish()
+
+// private methods
+
+// answer a start pulse:  move the clock on to each falling edge of the response and data bits, and
+//  call the interrupt handler at each.  Bit times are those of the sensor data sheets.
+void WLDHalMock::playDhtReading(int pin, const std::function<void()> &handler) {
+    const unsigned long FIRST_EDGE = 30;    // line released to the sensor pulling it low
+    const unsigned long RESPONSE = 160;     // 80 us low, 80 us high
+    const unsigned long ZERO = 78;          // 50 us low, 28 us high
+    const unsigned long ONE = 120;          // 50 us low, 70 us high
+    uint8_t bytes[5];
+
+    {
+        std::lock_guard<std::recursive_mutex> guard(_lock);
+        DhtSensor *sensor = &_dht[pin];
+
+        if(sensor->type == DHT11) {
+            bytes[0] = (uint8_t)lroundf(sensor->humidity);
+            bytes[1] = 0;
+            bytes[2] = (uint8_t)lroundf(sensor->temperature);
+            bytes[3] = 0;
+        } else {
+            uint16_t humidity = (uint16_t)lroundf(sensor->humidity * 10);
+            uint16_t temperature = (uint16_t)lroundf(fabsf(sensor->temperature) * 10);
+            if(sensor->temperature < 0) {
+                temperature |= 0x8000;
+            }
+            bytes[0] = humidity >> 8;
+            bytes[1] = humidity & 0xff;
+            bytes[2] = temperature >> 8;
+            bytes[3] = temperature & 0xff;
+        }
+        bytes[4] = bytes[0] + bytes[1] + bytes[2] + bytes[3];
+        sensor->readings++;
+    }
+
+    advanceMicros(FIRST_EDGE);
+    handler();
+    advanceMicros(RESPONSE);
+    handler();
+    for(int bit = 0; bit < 40; bit++) {
+        advanceMicros((bytes[bit / 8] & (0x80 >> (bit % 8))) ? ONE : ZERO);
+        handler();
+    }
+}   // end of playDhtReading()
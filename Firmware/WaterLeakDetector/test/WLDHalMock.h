@@ -0,0 +1,220 @@
+/*******************************************************************************
+ * WLDHalMock:  simulated device for running the WLD firmware on a host
+ *
+ * A WLDHalMock is a WLDHal (see WLDHal.h) that simulates a Photon with its sensors, for the host
+ * tests and benchmarks.  A test installs it by pointing the firmware's global "hal" pointer at
+ * it before calling setup(); the Device OS stubs (stubs/application.h) forward to the active
+ * WLDHalMock too, so the PietteTech_DHT library sees the same clock and pins as the firmware.
+ *
+ * - Clock.  In CLOCK_SIMULATED mode time only moves when delay() or advance() is called, so a
+ * run is repeatable and hours of simulated time take seconds.  In CLOCK_FAST_FORWARD mode time
+ * moves with the host clock but delay() skips ahead instead of waiting, so the time that code
+ * takes is measured while the waits between tasks cost nothing; the benchmarks use this.  In
+ * CLOCK_REAL mode delay() waits, and startThread() starts a host thread.  In the other modes
+ * startThread() only records the thread (its function never returns), and the test runs the
+ * work of the thread itself.  setUnixTime() sets the time of day, as the cloud does.
+ *
+ * - Pins.  The test sets the level of a digital input with setDigital(), and the voltage of an
+ * analog input, in ADC counts, with setAnalog() or as a function of the time with
+ * analogSource().  The level last written to an output, and the number of writes, are kept.
+ * analogReads() counts the ADC samples taken.  A pin driven low and then released to an input
+ * has sent a start pulse (as to a DHT sensor); the number of them and the shortest and longest,
+ * in microseconds, are kept.
+ *
+ * - DHT sensors.  addDhtSensor() puts a simulated DHT11 or DHT22 on a pin.  When the DHT library
+ * ends the start pulse and attaches its interrupt, the sensor answers at once:  the simulated
+ * clock is moved on edge by edge, and the handler is called for each falling edge of the
+ * response and of the 40 data bits, encoding the reading set with setDhtReading().  A sensor
+ * that is not present (setDhtPresent()) does not answer.
+ *
+ * - EEPROM.  An in-memory emulated EEPROM, erased (0xff) to start with.  tearEepromWrites() lets
+ * only a number of bytes more be written, and drops every write after them, as a reset or power
+ * loss part way through a write would; -1 lets every write through again.
+ *
+ * - Cloud.  Published events are kept, with their time, in events().  setCloudConnected() and
+ * setPublishFails() simulate an outage.  Cloud variables and functions registered by the firmware
+ * are reached through the Particle stub (CloudClass::getVariable() and callFunction()).
+ *
+ * - Resets.  reset() only counts the resets; the firmware runs on.  The application watchdog
+ * never expires.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ * version 1.1: 10/17/26.  Added the start pulse observations
+ *
+ *******************************************************************************/
+#ifndef wldhalmock
+#define wldhalmock
+
+#include "application.h"
+#include <WLDHal.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// A published event
+struct WLDMockEvent {
+    std::string name;
+    std::string data;
+    unsigned long time;     // millis() when it was published
+};
+
+class WLDHalMock : public WLDHal  {
+    public:
+        // Constants
+        enum ClockMode {
+            CLOCK_SIMULATED,        // time moves only with delay() and advance()
+            CLOCK_FAST_FORWARD,     // time moves with the host clock; delay() skips ahead
+            CLOCK_REAL              // time moves with the host clock; delay() waits; host threads
+        };
+        static const int EEPROM_SIZE = 2048;
+        static const int MAX_THREADS = 4;
+
+    private:
+        // Simulated DHT sensor on a pin
+        struct DhtSensor {
+            bool attached;          // a sensor is on the pin
+            bool present;           // and it answers
+            int type;               // DHT11 or DHT22
+            float temperature;      // degrees C
+            float humidity;         // %RH
+            uint32_t readings;      // readings sent
+        };
+
+        // Thread started by startThread()
+        struct ThreadEntry {
+            const char *name;
+            void (*function)(void *);
+            void *arg;
+            int priority;
+        };
+
+        // Variables
+        static WLDHalMock *_active;
+        ClockMode _mode;
+        std::chrono::steady_clock::time_point _origin;
+        std::atomic<uint64_t> _skipped;     // microseconds added by delay() and advance()
+        uint32_t _unixTimeBase;             // Unix time at millis() 0, or 0 while the time is not set
+        std::recursive_mutex _lock;         // pins, EEPROM and cloud, shared by host threads
+
+        int _pinModes[HOST_NUM_PINS];
+        int _levels[HOST_NUM_PINS];         // digital input levels set, output levels written
+        uint32_t _writes[HOST_NUM_PINS];
+        int _analogLevels[HOST_NUM_PINS];
+        std::function<int(unsigned long)> _analogSources[HOST_NUM_PINS];
+        uint32_t _analogReads;
+        std::function<void()> _interrupts[HOST_NUM_PINS];
+        bool _drivenLow[HOST_NUM_PINS];     // an output written low, since _lowSince (micros())
+        unsigned long _lowSince[HOST_NUM_PINS];
+        uint32_t _pulses[HOST_NUM_PINS];    // start pulses:  driven low, then released to an input
+        unsigned long _shortestPulse[HOST_NUM_PINS];
+        unsigned long _longestPulse[HOST_NUM_PINS];
+        DhtSensor _dht[HOST_NUM_PINS];
+        int _servoPosition;
+
+        uint8_t _eeprom[EEPROM_SIZE];
+        long _eepromBudget;                 // bytes that may still be written, or -1
+        uint32_t _eepromBytesWritten;
+
+        bool _connected;
+        bool _publishFails;
+        std::vector<WLDMockEvent> _events;
+
+        ThreadEntry _threads[MAX_THREADS];
+        int _numThreads;
+        int _resetReason;
+        uint32_t _resetData;
+        uint32_t _resets;
+        unsigned long _watchdogTimeout;
+
+        // Private methods (internal use only)
+        void playDhtReading(int pin, const std::function<void()> &handler);
+
+    public:
+        // Constructor
+        WLDHalMock();
+
+        // Initialization; makes this the device that the Device OS stubs reach
+        void begin(ClockMode mode);
+        static WLDHalMock &device();
+
+        // Simulation control
+        void advance(unsigned long milliseconds);
+        void advanceMicros(unsigned long microseconds);
+        void setUnixTime(uint32_t time);
+        void setDigital(int pin, int level);
+        void setAnalog(int pin, int counts);
+        void analogSource(int pin, std::function<int(unsigned long)> source);     // counts at millis()
+        void addDhtSensor(int pin, int type);
+        void setDhtReading(int pin, float temperature, float humidity);
+        void setDhtPresent(int pin, bool present);
+        void tearEepromWrites(long bytes);
+        void setCloudConnected(bool connected);
+        void setPublishFails(bool fails);
+        void setResetReason(int reason, uint32_t data);
+
+        // Observations
+        int pinModeOf(int pin);
+        int level(int pin);
+        uint32_t writes(int pin);
+        uint32_t analogReads();
+        uint32_t startPulses(int pin);
+        unsigned long shortestStartPulse(int pin);      // microseconds
+        unsigned long longestStartPulse(int pin);
+        uint32_t dhtReadings(int pin);
+        int servoPosition();
+        uint8_t *eeprom() { return _eeprom; }
+        uint32_t eepromBytesWritten();
+        std::vector<WLDMockEvent> events();
+        int countEvents(const char *name);
+        void clearEvents();
+        int numThreads() { return _numThreads; }
+        uint32_t resets() { return _resets; }
+        unsigned long watchdogTimeout() { return _watchdogTimeout; }
+
+        // Device OS stubs
+        void attachInterrupt(int pin, std::function<void()> handler);
+        void detachInterrupt(int pin);
+
+        // WLDHal:  time base
+        unsigned long millis();
+        unsigned long micros();
+        void delay(unsigned long milliseconds);
+        uint32_t unixTime();
+
+        // WLDHal:  threads
+        void startThread(const char *name, void (*function)(void *), void *arg, int priority, size_t stackSize);
+
+        // WLDHal:  resets
+        int resetReason(uint32_t *data);
+        void reset();
+        void startWatchdog(unsigned long timeout, void (*expired)());
+
+        // WLDHal:  pins
+        void pinMode(int pin, int mode);
+        int analogRead(int pin);
+        void analogReadBurst(int pin, uint16_t *samples, int count);
+        int digitalRead(int pin);
+        void digitalWrite(int pin, int value);
+
+        // WLDHal:  servo meter
+        void servoAttach(int pin);
+        void servoWrite(int position);
+
+        // WLDHal:  non-volatile storage
+        void eepromRead(int address, void *data, size_t length);
+        void eepromWrite(int address, const void *data, size_t length);
+
+        // WLDHal:  memory
+        void heapStats(WLDHeapStats *stats);
+
+        // WLDHal:  cloud
+        bool cloudConnected();
+        bool publish(const char *eventName, const char *eventData);
+};
+
+#endif
@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * WLDTest:  checks for the WLD host tests
+ *
+ * CHECK(condition, ...) prints the location and a printf style message if the condition is
+ * false, and counts the failure; a test ends with "return testResult();", which prints the
+ * number of failures and returns the exit status for ctest.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#ifndef wldtest
+#define wldtest
+
+#include <stdio.h>
+
+static int testFailures = 0;
+
+#define CHECK(condition, ...) do { \
+        if(!(condition)) { \
+            testFailures++; \
+            printf("FAIL %s:%d: %s: ", __FILE__, __LINE__, #condition); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while(0)
+
+// print the result of the test and return its exit status
+static inline int testResult() {
+    if(testFailures == 0) {
+        printf("PASS\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", testFailures);
+    return 1;
+}   // end of testResult()
+
+#endif
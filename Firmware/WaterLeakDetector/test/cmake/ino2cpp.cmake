@@ -0,0 +1,37 @@
+# ino2cpp.cmake:  turn the firmware .ino into a C++ file, as the Particle build does
+#
+# Run with cmake -DINO=<firmware .ino> -DCPP=<output .cpp> -P ino2cpp.cmake.  Includes Particle.h
+# first, and declares every function defined in the .ino, at the first definition, so that a
+# function can be called before it is defined.  #line directives keep compiler messages pointing
+# at the .ino.
+#
+# By: Team Practical Projects
+# (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+#
+# version 1.0: 10/17/26.  Initial release
+
+file(READ "${INO}" source)
+
+# function definitions start a line, at file scope:  a return type, a name, the parameters, and "{"
+set(definition "\n[A-Za-z_][A-Za-z0-9_:<>\\* ]*[ \\*&]+[A-Za-z_][A-Za-z0-9_]*\\([^;{}()]*\\)[ \t]*\\{")
+string(REGEX MATCHALL "${definition}" definitions "${source}")
+
+set(prototypes "")
+foreach(match IN LISTS definitions)
+    string(REGEX REPLACE "[ \t]*\\{$" ";\n" prototype "${match}")
+    string(STRIP "${prototype}" prototype)
+    string(APPEND prototypes "${prototype}\n")
+endforeach()
+
+# insert the prototypes before the first definition, and carry on at its line of the .ino
+string(REGEX MATCH "${definition}" first "${source}")
+string(FIND "${source}" "${first}" offset)
+string(SUBSTRING "${source}" 0 ${offset} head)
+string(SUBSTRING "${source}" ${offset} -1 tail)
+string(REGEX MATCHALL "\n" newlines "${head}")
+list(LENGTH newlines line)
+math(EXPR line "${line} + 1")
+
+file(WRITE "${CPP}.tmp" "#include \"Particle.h\"\n#line 1 \"${INO}\"\n${head}\n${prototypes}#line ${line} \"${INO}\"${tail}")
+file(COPY_FILE "${CPP}.tmp" "${CPP}" ONLY_IF_DIFFERENT)
+file(REMOVE "${CPP}.tmp")
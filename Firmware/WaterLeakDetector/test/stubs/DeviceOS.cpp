@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * DeviceOS.cpp:  Device OS stubs for building the WLD firmware on a host
+ *
+ * See application.h for a description.  The stubs forward everything that touches the hardware
+ * to the active simulated device, WLDHalMock::device().
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "application.h"
+#include <WLDHalMock.h>
+#include <map>
+#include <thread>
+
+TimeClass Time;
+CloudClass Particle;
+SystemClass System;
+EEPROMClass EEPROM;
+
+// registered cloud variables and functions
+static std::map<std::string, const char *> cloudVariables;
+static std::map<std::string, int (*)(String)> cloudFunctions;
+
+// Pins
+
+void pinMode(uint16_t pin, PinMode mode) {
+    WLDHalMock::device().pinMode(pin, mode);
+}   // end of pinMode()
+
+int32_t digitalRead(uint16_t pin) {
+    return WLDHalMock::device().digitalRead(pin);
+}   // end of digitalRead()
+
+void digitalWrite(uint16_t pin, uint8_t value) {
+    WLDHalMock::device().digitalWrite(pin, value);
+}   // end of digitalWrite()
+
+int32_t analogRead(uint16_t pin) {
+    return WLDHalMock::device().analogRead(pin);
+}   // end of analogRead()
+
+// Interrupts
+
+bool attachInterrupt(uint16_t pin, std::function<void()> handler, InterruptMode mode) {
+    WLDHalMock::device().attachInterrupt(pin, handler);
+    return true;
+}   // end of attachInterrupt()
+
+void detachInterrupt(uint16_t pin) {
+    WLDHalMock::device().detachInterrupt(pin);
+}   // end of detachInterrupt()
+
+// Time
+
+unsigned long millis() {
+    return WLDHalMock::device().millis();
+}   // end of millis()
+
+unsigned long micros() {
+    return WLDHalMock::device().micros();
+}   // end of micros()
+
+void delay(unsigned long milliseconds) {
+    WLDHalMock::device().delay(milliseconds);
+}   // end of delay()
+
+// the simulated clock does not wait for microsecond delays either
+void delayMicroseconds(unsigned int microseconds) {
+    WLDHalMock::device().advanceMicros(microseconds);
+}   // end of delayMicroseconds()
+
+bool TimeClass::isValid() {
+    return WLDHalMock::device().unixTime() != 0;
+}   // end of isValid()
+
+time_t TimeClass::now() {
+    return WLDHalMock::device().unixTime();
+}   // end of now()
+
+// format a time as Device OS does; only TIME_FORMAT_DEFAULT is used by the firmware
+String TimeClass::format(time_t time, const char *format) {
+    char text[32];
+    struct tm calendar;
+
+    gmtime_r(&time, &calendar);
+    strftime(text, sizeof(text), "%a %b %d %H:%M:%S %Y", &calendar);
+    return String(text);
+}   // end of format()
+
+// Cloud
+
+bool CloudClass::variable(const char *name, const char *value) {
+    cloudVariables[name] = value;
+    return true;
+}   // end of variable()
+
+bool CloudClass::function(const char *name, int (*function)(String)) {
+    cloudFunctions[name] = function;
+    return true;
+}   // end of function()
+
+bool CloudClass::publish(const char *name, const char *data, int scope) {
+    return WLDHalMock::device().publish(name, data);
+}   // end of publish()
+
+bool CloudClass::connected() {
+    return WLDHalMock::device().cloudConnected();
+}   // end of connected()
+
+int CloudClass::callFunction(const char *name, const char *argument) {
+    std::map<std::string, int (*)(String)>::iterator entry = cloudFunctions.find(name);
+
+    return (entry == cloudFunctions.end()) ? -1 : entry->second(String(argument));
+}   // end of callFunction()
+
+const char *CloudClass::getVariable(const char *name) {
+    std::map<std::string, const char *>::iterator entry = cloudVariables.find(name);
+
+    return (entry == cloudVariables.end()) ? NULL : entry->second;
+}   // end of getVariable()
+
+// System
+
+int SystemClass::resetReason() {
+    uint32_t data;
+    return WLDHalMock::device().resetReason(&data);
+}   // end of resetReason()
+
+uint32_t SystemClass::resetReasonData() {
+    uint32_t data;
+    WLDHalMock::device().resetReason(&data);
+    return data;
+}   // end of resetReasonData()
+
+void SystemClass::reset() {
+    WLDHalMock::device().reset();
+}   // end of reset()
+
+// EEPROM
+
+uint8_t EEPROMClass::read(int address) {
+    uint8_t value;
+    WLDHalMock::device().eepromRead(address, &value, 1);
+    return value;
+}   // end of read()
+
+void EEPROMClass::write(int address, uint8_t value) {
+    WLDHalMock::device().eepromWrite(address, &value, 1);
+}   // end of write()
+
+size_t EEPROMClass::length() {
+    return WLDHalMock::EEPROM_SIZE;
+}   // end of length()
+
+// Servo
+
+void Servo::write(int position) {
+    WLDHalMock::device().servoWrite(position);
+}   // end of write()
+
+// Threads
+
+// run the thread on a detached host thread; like a Device OS thread, it is never stopped
+Thread::Thread(const char *name, void (*function)(void *), void *arg, os_thread_prio_t priority, size_t stackSize) {
+    std::thread(function, arg).detach();
+}   // end of Thread()
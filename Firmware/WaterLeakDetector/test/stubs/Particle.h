@@ -0,0 +1,12 @@
+/*******************************************************************************
+ * Particle.h:  Device OS stub header for building the WLD firmware on a host
+ *
+ * See application.h.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#include "application.h"
@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * application.h:  Device OS stub header for building the WLD firmware on a host
+ *
+ * Declares the part of the Device OS API that the WLD firmware, its classes and the
+ * PietteTech_DHT library use, so that they compile unchanged on Linux.  Everything that
+ * touches the hardware (time, pins, interrupts, EEPROM, the cloud, resets) is forwarded to
+ * the simulated device, the active WLDHalMock (see WLDHalMock.h and DeviceOS.cpp), so that the
+ * DHT library and the firmware's WLDHal see the same clock and pins.
+ *
+ * Only what the firmware uses is here, and the behaviour is only as close to Device OS as the
+ * tests need:  String holds a std::string, there is no retained memory (retained variables are
+ * ordinary variables, kept until the process ends) and there are no interrupts to mask.
+ *
+ * Two host-only extensions let a test act as the cloud:  CloudClass::callFunction() calls a
+ * registered cloud function and CloudClass::getVariable() reads a registered cloud variable.
+ *
+ * By: Team Practical Projects
+ * (c) 2026, Bob Glicksman, Jim Schrempp, Team Practical Projects
+ *
+ * version 1.0: 10/17/26.  Initial release
+ *
+ *******************************************************************************/
+#ifndef wldhost_application
+#define wldhost_application
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <functional>
+#include <string>
+
+// Device OS version; the DHT library takes the path of Device OS 1.2.1 and later
+#define SYSTEM_VERSION_v121RC3  0x01020103
+#define SYSTEM_VERSION          0x02030000
+
+// Wiring types and helpers
+typedef bool boolean;
+typedef uint8_t byte;
+#define constrain(amount, low, high) ((amount) < (low) ? (low) : ((amount) > (high) ? (high) : (amount)))
+
+// Pins
+enum { D0 = 0, D1, D2, D3, D4, D5, D6, D7, A0 = 10, A1, A2, A3, A4, A5, A6, A7 };
+const int HOST_NUM_PINS = 24;
+enum { LOW = 0, HIGH = 1 };
+enum PinMode { INPUT, OUTPUT, INPUT_PULLUP, INPUT_PULLDOWN };
+enum InterruptMode { CHANGE, RISING, FALLING };
+
+void pinMode(uint16_t pin, PinMode mode);
+int32_t digitalRead(uint16_t pin);
+void digitalWrite(uint16_t pin, uint8_t value);
+int32_t analogRead(uint16_t pin);
+
+// Interrupts; a handler is called by the simulated device when it plays edges on the pin
+bool attachInterrupt(uint16_t pin, std::function<void()> handler, InterruptMode mode);
+template <class T>
+bool attachInterrupt(uint16_t pin, void (T::*handler)(), T *instance, InterruptMode mode) {
+    return attachInterrupt(pin, std::function<void()>([instance, handler]() { (instance->*handler)(); }), mode);
+}
+void detachInterrupt(uint16_t pin);
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// Time
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long milliseconds);
+void delayMicroseconds(unsigned int microseconds);
+
+// String, as much of it as the firmware uses
+class String {
+    private:
+        std::string _s;
+
+    public:
+        String() {}
+        String(const char *s) : _s(s ? s : "") {}
+        String(const std::string &s) : _s(s) {}
+        unsigned int length() const { return _s.size(); }
+        char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+        String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(); }
+        String substring(unsigned int from, unsigned int to) const {
+            return from < to && from < _s.size() ? String(_s.substr(from, to - from)) : String();
+        }
+        int indexOf(char c, unsigned int from = 0) const {
+            size_t position = _s.find(c, from);
+            return position == std::string::npos ? -1 : (int)position;
+        }
+        long toInt() const { return atol(_s.c_str()); }
+        float toFloat() const { return atof(_s.c_str()); }
+        const char *c_str() const { return _s.c_str(); }
+        bool equals(const char *s) const { return _s == s; }
+        bool operator==(const char *s) const { return _s == s; }
+        String &operator+=(const String &s) { _s += s._s; return *this; }
+        friend String operator+(const String &a, const String &b) { String sum(a); sum += b; return sum; }
+        friend String operator+(const String &a, const char *b) { String sum(a); sum += String(b); return sum; }
+};
+
+// Time of day, from the simulated device's Unix time
+#define TIME_FORMAT_DEFAULT "asctime"
+class TimeClass {
+    public:
+        bool isValid();
+        time_t now();
+        String format(time_t time, const char *format);
+};
+extern TimeClass Time;
+
+// Cloud
+#define PRIVATE 1
+#define PUBLIC 0
+class CloudClass {
+    public:
+        bool variable(const char *name, const char *value);
+        bool function(const char *name, int (*function)(String));
+        bool publish(const char *name, const char *data, int scope = PRIVATE);
+        bool connected();
+        void process() {}
+
+        // host only:  call a cloud function (-1 if there is none), and read a cloud variable (NULL if none)
+        int callFunction(const char *name, const char *argument);
+        const char *getVariable(const char *name);
+};
+extern CloudClass Particle;
+
+// System
+#define FEATURE_RETAINED_MEMORY 1
+#define FEATURE_RESET_INFO 2
+#define RESET_REASON_NONE 0
+#define RESET_REASON_PIN_RESET 20
+#define RESET_REASON_POWER_DOWN 30
+#define RESET_REASON_WATCHDOG 40
+#define RESET_REASON_USER 70
+#define RESET_REASON_PANIC 80
+class SystemClass {
+    public:
+        void enableFeature(int feature) {}
+        int resetReason();
+        uint32_t resetReasonData();
+        void reset();
+        uint32_t freeMemory() { return 60000; }
+};
+extern SystemClass System;
+
+#define STARTUP_NAME2(line) _startup ## line
+#define STARTUP_NAME(line) STARTUP_NAME2(line)
+#define STARTUP(code) static struct STARTUP_NAME(__LINE__) { STARTUP_NAME(__LINE__)() { code; } } STARTUP_NAME(__LINE__)
+#define SYSTEM_THREAD(state)
+#define SYSTEM_MODE(mode)
+#define retained
+#define SINGLE_THREADED_BLOCK()
+#define ATOMIC_BLOCK()
+
+// Emulated EEPROM
+class EEPROMClass {
+    public:
+        uint8_t read(int address);
+        void write(int address, uint8_t value);
+        size_t length();
+};
+extern EEPROMClass EEPROM;
+
+// Servo; the simulated device keeps the position written
+class Servo {
+    private:
+        int _pin = -1;
+
+    public:
+        bool attach(int pin) { _pin = pin; return true; }
+        void write(int position);
+};
+
+// Threads.  A Thread runs on a host thread; the application watchdog never expires on the host
+typedef uint8_t os_thread_prio_t;
+const os_thread_prio_t OS_THREAD_PRIORITY_DEFAULT = 2;
+const size_t OS_THREAD_STACK_SIZE_DEFAULT = 3072;
+class Thread {
+    public:
+        Thread(const char *name, void (*function)(void *), void *arg = NULL,
+               os_thread_prio_t priority = OS_THREAD_PRIORITY_DEFAULT, size_t stackSize = OS_THREAD_STACK_SIZE_DEFAULT);
+};
+class ApplicationWatchdog {
+    public:
+        ApplicationWatchdog(unsigned long timeout, std::function<void()> expired, size_t stackSize = 512) {}
+        static void checkin() {}
+};
+
+#endif